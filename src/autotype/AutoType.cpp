@@ -30,6 +30,7 @@
 #include "autotype/AutoTypeSelectDialog.h"
 #include "autotype/PickcharsDialog.h"
 #include "core/Global.h"
+#include "core/GroupSettingsCache.h"
 #include "core/Resources.h"
 #include "core/Tools.h"
 #include "gui/MainWindow.h"
@@ -451,21 +452,26 @@ void AutoType::performGlobalAutoType(const QList<QSharedPointer<Database>>& dbLi
     bool hideExpired = config()->get(Config::AutoTypeHideExpiredEntry).toBool();
 
     for (const auto& db : dbList) {
-        const QList<Entry*> dbEntries = db->rootGroup()->entriesRecursive();
-        for (auto entry : dbEntries) {
-            auto group = entry->group();
-            if (!group || !group->resolveAutoTypeEnabled() || !entry->autoTypeEnabled()) {
-                continue;
+        auto settingsCache = db->groupSettingsCache();
+        db->rootGroup()->forEachGroup([&](const Group* group) {
+            if (!settingsCache->settings(group).autoTypeEnabled) {
+                return;
             }
 
-            if (hideExpired && entry->isExpired()) {
-                continue;
-            }
-            const QSet<QString> sequences = Tools::asSet(entry->autoTypeSequences(m_windowTitleForGlobal));
-            for (const auto& sequence : sequences) {
-                matchList << AutoTypeMatch(entry, sequence);
+            for (auto entry : group->entries()) {
+                if (!entry->autoTypeEnabled()) {
+                    continue;
+                }
+
+                if (hideExpired && entry->isExpired()) {
+                    continue;
+                }
+                const QSet<QString> sequences = Tools::asSet(entry->autoTypeSequences(m_windowTitleForGlobal));
+                for (const auto& sequence : sequences) {
+                    matchList << AutoTypeMatch(entry, sequence);
+                }
             }
-        }
+        });
     }
 
     // Show the selection dialog if we always ask, have multiple matches, or no matches
@@ -75,6 +75,40 @@ QJsonObject BrowserAction::processClientMessage(QLocalSocket* socket, const QJso
     return handleAction(socket, json);
 }
 
+/**
+ * Answer a read-only request from database snapshots. Safe to call from any thread on a
+ * copy of the client, as long as the GUI thread only changes the original.
+ *
+ * @param json request, see isLookup()
+ * @param lookup snapshots to answer from
+ * @return response, invalid if the lookup requires the GUI thread
+ */
+QJsonObject BrowserAction::processLookup(const QJsonObject& json, BrowserLookup* lookup)
+{
+    m_lookup = lookup;
+
+    const auto action = json.value("action").toString();
+    if (action.compare(BROWSER_REQUEST_GET_LOGINS) == 0) {
+        return handleGetLogins(json, action);
+    } else if (action.compare(BROWSER_REQUEST_GET_TOTP) == 0) {
+        return handleGetTotp(json, action);
+    } else if (action.compare(BROWSER_REQUEST_GET_DATABASE_GROUPS) == 0) {
+        return handleGetDatabaseGroups(json, action);
+    }
+
+    return getErrorReply(action, ERROR_KEEPASS_INCORRECT_ACTION);
+}
+
+/**
+ * @return true if the request only reads the databases and can be answered by processLookup()
+ */
+bool BrowserAction::isLookup(const QJsonObject& json)
+{
+    const auto action = json.value("action").toString();
+    return action.compare(BROWSER_REQUEST_GET_LOGINS) == 0 || action.compare(BROWSER_REQUEST_GET_TOTP) == 0
+           || action.compare(BROWSER_REQUEST_GET_DATABASE_GROUPS) == 0;
+}
+
 // Private functions
 ///////////////////////
 
@@ -252,7 +286,10 @@ QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QStrin
     entryParameters.httpAuth = httpAuth;
 
     bool entriesFound = false;
-    const auto entries = browserService()->findEntries(entryParameters, keyList, &entriesFound);
+    const auto entries = browserService()->findEntries(entryParameters, keyList, &entriesFound, m_lookup);
+    if (m_lookup && m_lookup->guiRequired) {
+        return {};
+    }
     if (!entriesFound) {
         return getErrorReply(action, ERROR_KEEPASS_NO_LOGINS_FOUND);
     }
@@ -380,7 +417,7 @@ QJsonObject BrowserAction::handleGetDatabaseGroups(const QJsonObject& json, cons
         return getErrorReply(action, ERROR_KEEPASS_INCORRECT_ACTION);
     }
 
-    const auto groups = browserService()->getDatabaseGroups();
+    const auto groups = browserService()->getDatabaseGroups(m_lookup);
     if (groups.isEmpty()) {
         return getErrorReply(action, ERROR_KEEPASS_NO_GROUPS_FOUND);
     }
@@ -466,7 +503,7 @@ QJsonObject BrowserAction::handleGetTotp(const QJsonObject& json, const QString&
         return getErrorReply(action, ERROR_KEEPASS_NO_VALID_UUID_PROVIDED);
     }
 
-    const Parameters params{{"totp", browserService()->getCurrentTotp(uuid)}};
+    const Parameters params{{"totp", browserService()->getCurrentTotp(uuid, m_lookup)}};
     return buildResponse(action, browserRequest.incrementedNonce, params);
 }
 
@@ -608,7 +645,7 @@ BrowserRequest BrowserAction::decodeRequest(const QJsonObject& json)
     const auto nonce = json.value("nonce").toString();
     const auto encrypted = json.value("message").toString();
 
-    return {browserService()->getDatabaseHash(),
+    return {m_lookup ? m_lookup->databaseHash : browserService()->getDatabaseHash(),
             nonce,
             browserMessageBuilder()->incrementNonce(nonce),
             decryptMessage(encrypted, nonce)};
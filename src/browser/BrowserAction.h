@@ -67,6 +67,9 @@ public:
     ~BrowserAction() = default;
 
     QJsonObject processClientMessage(QLocalSocket* socket, const QJsonObject& json);
+    QJsonObject processLookup(const QJsonObject& json, BrowserLookup* lookup);
+
+    static bool isLookup(const QJsonObject& json);
 
 private:
     QJsonObject handleAction(QLocalSocket* socket, const QJsonObject& json);
@@ -103,6 +106,7 @@ private:
     QString m_publicKey;
     QString m_secretKey;
     bool m_associated = false;
+    BrowserLookup* m_lookup = nullptr;
 
     friend class TestBrowser;
 };
@@ -17,6 +17,7 @@
 
 #include "BrowserHost.h"
 #include "BrowserShared.h"
+#include "core/Global.h"
 
 #include <QJsonDocument>
 #include <QLocalServer>
@@ -44,16 +45,29 @@ BrowserHost::~BrowserHost()
     stop();
 }
 
-void BrowserHost::start()
+/**
+ * @param serverPath path of the local socket, defaults to the one the proxy connects to
+ * @return true if the socket is listening
+ */
+bool BrowserHost::start(const QString& serverPath)
 {
-    if (!m_localServer->isListening()) {
-        m_localServer->listen(BrowserShared::localServerPath());
+    if (m_localServer->isListening()) {
+        return true;
+    }
+
+    const auto path = serverPath.isEmpty() ? BrowserShared::localServerPath() : serverPath;
+    if (!m_localServer->listen(path)) {
+        qWarning("Browser integration: cannot listen on %s: %s",
+                 qPrintable(path),
+                 qPrintable(m_localServer->errorString()));
+        return false;
     }
+    return true;
 }
 
 void BrowserHost::stop()
 {
-    m_socketList.clear();
+    m_connections.clear();
     m_localServer->close();
 }
 
@@ -61,28 +75,114 @@ void BrowserHost::proxyConnected()
 {
     auto socket = m_localServer->nextPendingConnection();
     if (socket) {
-        m_socketList.append(socket);
+        socket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
+        int socketDesc = socket->socketDescriptor();
+        if (socketDesc) {
+            int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
+            setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
+        }
+
+        m_connections.insert(socket, {});
         connect(socket, SIGNAL(readyRead()), this, SLOT(readProxyMessage()));
         connect(socket, SIGNAL(disconnected()), this, SLOT(proxyDisconnected()));
     }
 }
 
+/**
+ * Collect the data of a proxy connection and process every complete message in it.
+ * A read may end in the middle of a message or contain several of them.
+ */
 void BrowserHost::readProxyMessage()
 {
     QLocalSocket* socket = qobject_cast<QLocalSocket*>(QObject::sender());
-    if (!socket || socket->bytesAvailable() <= 0) {
+    if (!socket || socket->bytesAvailable() <= 0 || !m_connections.contains(socket)) {
         return;
     }
 
-    socket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
-    int socketDesc = socket->socketDescriptor();
-    if (socketDesc) {
-        int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
-        setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
+    m_connections[socket].buffer.append(socket->readAll());
+    if (m_connections[socket].framing == Framing::Unknown && !detectFraming(socket)) {
+        return;
+    }
+
+    // Sending the pending messages may have closed the connection
+    if (!m_connections.contains(socket)) {
+        return;
+    }
+
+    auto& connection = m_connections[socket];
+    const auto maxLength = BrowserShared::NATIVEMSG_MAX_INPUT_LENGTH;
+    if (connection.framing == Framing::Unframed) {
+        const auto message = connection.buffer;
+        connection.buffer.clear();
+        processProxyMessage(socket, message);
+        return;
+    }
+
+    // Emitting may process events, so take the messages out of the buffer first
+    QList<QByteArray> messages;
+    int offset = 0;
+    while (true) {
+        const auto frameSize = BrowserShared::nativeMessageFrameSize(connection.buffer, offset, maxLength);
+        if (frameSize < 0) {
+            qWarning() << "Invalid proxy message length, closing the connection";
+            m_connections.remove(socket);
+            socket->abort();
+            socket->deleteLater();
+            return;
+        }
+        if (frameSize == 0) {
+            break;
+        }
+
+        const int headerSize = sizeof(quint32);
+        messages << connection.buffer.mid(offset + headerSize, frameSize - headerSize);
+        offset += frameSize;
+    }
+    connection.buffer.remove(0, offset);
+
+    for (const auto& message : asConst(messages)) {
+        processProxyMessage(socket, message);
+    }
+}
+
+/**
+ * Detect the framing from the first message of a proxy connection and send the
+ * messages broadcast until then.
+ *
+ * @return true if the buffer holds a message to process
+ */
+bool BrowserHost::detectFraming(QLocalSocket* socket)
+{
+    auto& connection = m_connections[socket];
+    if (connection.buffer.size() < static_cast<int>(sizeof(quint32))) {
+        return false;
     }
 
+    // A JSON document read as length would be far beyond the limit
+    const auto maxLength = BrowserShared::NATIVEMSG_MAX_INPUT_LENGTH;
+    const bool unframed = connection.buffer.startsWith('{')
+                          && BrowserShared::nativeMessageFrameSize(connection.buffer, 0, maxLength) < 0;
+    // The proxy announces that it frames its messages with a bare hello
+    const bool hello = unframed && BrowserShared::isProxyHello(connection.buffer);
+    connection.framing = unframed && !hello ? Framing::Unframed : Framing::LengthPrefixed;
+
+    auto pending = connection.pending;
+    connection.pending.clear();
+    if (hello) {
+        connection.buffer.clear();
+        pending.prepend(BrowserShared::proxyHelloMessage());
+    }
+
+    for (const auto& data : asConst(pending)) {
+        sendClientData(socket, data);
+    }
+    return !hello;
+}
+
+void BrowserHost::processProxyMessage(QLocalSocket* socket, const QByteArray& message)
+{
     QJsonParseError error;
-    auto json = QJsonDocument::fromJson(socket->readAll(), &error);
+    auto json = QJsonDocument::fromJson(message, &error);
     if (json.isNull()) {
         qWarning() << "Failed to read proxy message: " << error.errorString();
         return;
@@ -93,23 +193,32 @@ void BrowserHost::readProxyMessage()
 
 void BrowserHost::broadcastClientMessage(const QJsonObject& json)
 {
-    QString reply(QJsonDocument(json).toJson(QJsonDocument::Compact));
-    for (const auto socket : m_socketList) {
-        sendClientData(socket, reply);
+    const auto reply = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    for (auto it = m_connections.cbegin(); it != m_connections.cend(); ++it) {
+        sendClientData(it.key(), reply);
     }
 }
 
 void BrowserHost::sendClientMessage(QLocalSocket* socket, const QJsonObject& json)
 {
-    QString reply(QJsonDocument(json).toJson(QJsonDocument::Compact));
-    sendClientData(socket, reply);
+    sendClientData(socket, QJsonDocument(json).toJson(QJsonDocument::Compact));
 }
 
-void BrowserHost::sendClientData(QLocalSocket* socket, const QString& data)
+void BrowserHost::sendClientData(QLocalSocket* socket, const QByteArray& data)
 {
-    if (socket && socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
-        QByteArray arr = data.toUtf8();
-        socket->write(arr.constData(), arr.length());
+    // Replies can be sent after the proxy disconnected, the socket may be gone
+    auto connection = m_connections.find(socket);
+    if (connection == m_connections.end()) {
+        return;
+    }
+
+    if (connection->framing == Framing::Unknown) {
+        connection->pending << data;
+        return;
+    }
+
+    if (socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
+        socket->write(connection->framing == Framing::Unframed ? data : BrowserShared::frameNativeMessage(data));
         socket->flush();
     }
 }
@@ -117,5 +226,7 @@ void BrowserHost::sendClientData(QLocalSocket* socket, const QString& data)
 void BrowserHost::proxyDisconnected()
 {
     auto socket = qobject_cast<QLocalSocket*>(QObject::sender());
-    m_socketList.removeOne(socket);
+    if (m_connections.remove(socket) > 0) {
+        socket->deleteLater();
+    }
 }
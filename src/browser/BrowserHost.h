@@ -18,6 +18,7 @@
 #ifndef KEEPASSXC_NATIVEMESSAGINGHOST_H
 #define KEEPASSXC_NATIVEMESSAGINGHOST_H
 
+#include <QHash>
 #include <QJsonObject>
 #include <QObject>
 #include <QPointer>
@@ -34,7 +35,7 @@ public:
     explicit BrowserHost(QObject* parent = nullptr);
     ~BrowserHost() override;
 
-    void start();
+    bool start(const QString& serverPath = {});
     void stop();
 
     void broadcastClientMessage(const QJsonObject& json);
@@ -49,11 +50,29 @@ private slots:
     void proxyDisconnected();
 
 private:
-    void sendClientData(QLocalSocket* socket, const QString& data);
+    enum class Framing
+    {
+        Unknown,
+        LengthPrefixed,
+        // Clients that predate the framing send and receive bare JSON documents
+        Unframed
+    };
+
+    struct ProxyConnection
+    {
+        QByteArray buffer;
+        Framing framing = Framing::Unknown;
+        // Messages broadcast before the framing of the connection is known
+        QList<QByteArray> pending;
+    };
+
+    bool detectFraming(QLocalSocket* socket);
+    void processProxyMessage(QLocalSocket* socket, const QByteArray& message);
+    void sendClientData(QLocalSocket* socket, const QByteArray& data);
 
 private:
     QPointer<QLocalServer> m_localServer;
-    QList<QLocalSocket*> m_socketList;
+    QHash<QLocalSocket*, ProxyConnection> m_connections;
 };
 
 #endif // KEEPASSXC_NATIVEMESSAGINGHOST_H
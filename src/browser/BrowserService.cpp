@@ -24,6 +24,8 @@
 #include "BrowserHost.h"
 #include "BrowserMessageBuilder.h"
 #include "BrowserSettings.h"
+#include "BrowserUrlIndex.h"
+#include "core/GroupSettingsCache.h"
 #include "core/Tools.h"
 #include "gui/MainWindow.h"
 #include "gui/MessageBox.h"
@@ -49,8 +51,10 @@
 #include <QListWidget>
 #include <QLocalSocket>
 #include <QLocale>
+#include <QPointer>
 #include <QProgressDialog>
 #include <QUrl>
+#include <QtConcurrent>
 
 const QString BrowserService::KEEPASSXCBROWSER_NAME = QStringLiteral("KeePassXC-Browser Settings");
 const QString BrowserService::KEEPASSXCBROWSER_OLD_NAME = QStringLiteral("keepassxc-browser Settings");
@@ -71,6 +75,15 @@ const QString BrowserService::OPTION_NOT_HTTP_AUTH = QStringLiteral("BrowserNotH
 const QString BrowserService::OPTION_OMIT_WWW = QStringLiteral("BrowserOmitWww");
 const QString BrowserService::OPTION_RESTRICT_KEY = QStringLiteral("BrowserRestrictKey");
 
+// Group options are inherited, the database caches them per group
+static Group::TriState groupOption(const Entry* entry, const QString& key)
+{
+    const auto* group = entry->group();
+    const auto* db = group->database();
+    return db ? db->groupSettingsCache()->settings(group).customDataTriState(key)
+              : group->resolveCustomDataTriState(key);
+}
+
 Q_GLOBAL_STATIC(BrowserService, s_browserService);
 
 BrowserService::BrowserService()
@@ -204,9 +217,9 @@ QJsonArray BrowserService::getChildrenFromGroup(Group* group)
     return groupList;
 }
 
-QJsonObject BrowserService::getDatabaseGroups()
+QJsonObject BrowserService::getDatabaseGroups(const BrowserLookup* lookup)
 {
-    auto db = getDatabase();
+    auto db = lookup ? lookup->database : getDatabase();
     if (!db) {
         return {};
     }
@@ -243,19 +256,15 @@ QJsonArray BrowserService::getDatabaseEntries()
     }
 
     QJsonArray entries;
-    for (const auto& group : rootGroup->groupsRecursive(true)) {
-        if (group == db->metadata()->recycleBin()) {
-            continue;
-        }
-
-        for (const auto& entry : group->entries()) {
+    rootGroup->forEachEntry(
+        [&entries](const Entry* entry) {
             QJsonObject jentry;
             jentry["title"] = entry->resolveMultiplePlaceholders(entry->title());
             jentry["uuid"] = entry->resolveMultiplePlaceholders(entry->uuidToHex());
             jentry["url"] = entry->resolveMultiplePlaceholders(entry->url());
             entries.push_back(jentry);
-        }
-    }
+        },
+        Group::SkipRecycled);
     return entries;
 }
 
@@ -338,20 +347,9 @@ QJsonObject BrowserService::createNewGroup(const QString& groupName, bool isPass
     return result;
 }
 
-QString BrowserService::getCurrentTotp(const QString& uuid)
+QString BrowserService::getCurrentTotp(const QString& uuid, const BrowserLookup* lookup)
 {
-    QList<QSharedPointer<Database>> databases;
-    if (browserSettings()->searchInAllDatabases()) {
-        for (auto dbWidget : getMainWindow()->getOpenDatabases()) {
-            auto db = dbWidget->database();
-            if (db) {
-                databases << db;
-            }
-        }
-    } else {
-        databases << getDatabase();
-    }
-
+    const auto databases = lookup ? lookup->databases : searchDatabases();
     auto entryUuid = Tools::hexToUuid(uuid);
     for (const auto& db : databases) {
         auto entry = db->rootGroup()->findEntryByUuid(entryUuid, true);
@@ -363,35 +361,44 @@ QString BrowserService::getCurrentTotp(const QString& uuid)
     return {};
 }
 
-QJsonArray
-BrowserService::findEntries(const EntryParameters& entryParameters, const StringPairList& keyList, bool* entriesFound)
+/**
+ * @param lookup search these database snapshots instead, entries that need a confirmation are left
+ *               to the GUI thread then
+ */
+QJsonArray BrowserService::findEntries(const EntryParameters& entryParameters,
+                                       const StringPairList& keyList,
+                                       bool* entriesFound,
+                                       BrowserLookup* lookup)
 {
     if (entriesFound) {
         *entriesFound = false;
     }
 
-    const bool alwaysAllowAccess = browserSettings()->alwaysAllowAccess();
-    const bool ignoreHttpAuth = browserSettings()->httpAuthPermission();
+    const bool alwaysAllowAccess = lookup ? lookup->alwaysAllowAccess : browserSettings()->alwaysAllowAccess();
+    const bool ignoreHttpAuth = lookup ? lookup->httpAuthPermission : browserSettings()->httpAuthPermission();
     const QString siteHost = QUrl(entryParameters.siteUrl).host();
     const QString formHost = QUrl(entryParameters.formUrl).host();
 
     // Check entries for authorization
     QList<Entry*> entriesToConfirm;
     QList<Entry*> allowedEntries;
-    for (auto* entry : searchEntries(entryParameters.siteUrl, entryParameters.formUrl, keyList)) {
+    const auto databases = lookup ? lookup->databases : searchDatabases();
+    const auto foundEntries =
+        searchEntries(databases, entryParameters.siteUrl, entryParameters.formUrl, keyList, false, lookup);
+    for (auto* entry : foundEntries) {
         auto entryCustomData = entry->customData();
 
         if (!entryParameters.httpAuth
             && ((entryCustomData->contains(BrowserService::OPTION_ONLY_HTTP_AUTH)
                  && entryCustomData->value(BrowserService::OPTION_ONLY_HTTP_AUTH) == TRUE_STR)
-                || entry->group()->resolveCustomDataTriState(BrowserService::OPTION_ONLY_HTTP_AUTH) == Group::Enable)) {
+                || groupOption(entry, BrowserService::OPTION_ONLY_HTTP_AUTH) == Group::Enable)) {
             continue;
         }
 
         if (entryParameters.httpAuth
             && ((entryCustomData->contains(BrowserService::OPTION_NOT_HTTP_AUTH)
                  && entryCustomData->value(BrowserService::OPTION_NOT_HTTP_AUTH) == TRUE_STR)
-                || entry->group()->resolveCustomDataTriState(BrowserService::OPTION_NOT_HTTP_AUTH) == Group::Enable)) {
+                || groupOption(entry, BrowserService::OPTION_NOT_HTTP_AUTH) == Group::Enable)) {
             continue;
         }
 
@@ -401,7 +408,7 @@ BrowserService::findEntries(const EntryParameters& entryParameters, const String
             continue;
         }
 
-        switch (checkAccess(entry, siteHost, formHost, entryParameters.realm)) {
+        switch (checkAccess(entry, siteHost, formHost, entryParameters.realm, lookup)) {
         case Denied:
             continue;
 
@@ -423,6 +430,11 @@ BrowserService::findEntries(const EntryParameters& entryParameters, const String
         return {};
     }
 
+    if (lookup && !entriesToConfirm.isEmpty()) {
+        lookup->guiRequired = true;
+        return {};
+    }
+
     // Confirm entries
     auto selectedEntriesToConfirm =
         confirmEntries(entriesToConfirm, entryParameters, siteHost, formHost, entryParameters.httpAuth);
@@ -431,17 +443,17 @@ BrowserService::findEntries(const EntryParameters& entryParameters, const String
     }
 
     // Ensure that database is not locked when the popup was visible
-    if (!isDatabaseOpened()) {
+    if (!lookup && !isDatabaseOpened()) {
         return {};
     }
 
     // Sort results
-    allowedEntries = sortEntries(allowedEntries, entryParameters.siteUrl, entryParameters.formUrl);
+    allowedEntries = sortEntries(allowedEntries, entryParameters.siteUrl, entryParameters.formUrl, lookup);
 
     // Fill the list
     QJsonArray entries;
     for (auto* entry : allowedEntries) {
-        entries.append(prepareEntry(entry));
+        entries.append(prepareEntry(entry, lookup));
     }
 
     if (entriesFound != nullptr) {
@@ -1006,7 +1018,8 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
                                             const QString& siteUrl,
                                             const QString& formUrl,
                                             const QStringList& keys,
-                                            bool passkey)
+                                            bool passkey,
+                                            const BrowserLookup* lookup)
 {
     QList<Entry*> entries;
     auto* rootGroup = db->rootGroup();
@@ -1014,46 +1027,82 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
         return entries;
     }
 
-    for (const auto& group : rootGroup->groupsRecursive(true)) {
-        if (group->isRecycled()
-            || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable) {
-            continue;
+    // Returns false if the group and its entries are hidden from the browser
+    auto settingsCache = db->groupSettingsCache();
+    auto groupVisible = [&](const Group* group, bool* omitWwwSubdomain) {
+        const auto settings = settingsCache->settings(group);
+        if (settings.customDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable) {
+            return false;
         }
 
         // If a key restriction is specified and not contained in the keys list then skip this group.
-        auto restrictKey = group->resolveCustomDataString(BrowserService::OPTION_RESTRICT_KEY);
+        auto restrictKey = settings.customDataString(BrowserService::OPTION_RESTRICT_KEY);
         if (!restrictKey.isEmpty() && !keys.contains(restrictKey)) {
-            continue;
+            return false;
         }
 
-        const auto omitWwwSubdomain =
-            group->resolveCustomDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
+        *omitWwwSubdomain = settings.customDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
+        return true;
+    };
 
-        for (auto* entry : group->entries()) {
-            if (entry->isRecycled()
-                || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
-                    && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
-                continue;
-            }
+    auto addEntry = [&](Entry* entry, bool omitWwwSubdomain) {
+        if (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
+            && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR) {
+            return;
+        }
 
-            if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, omitWwwSubdomain)) {
-                continue;
-            }
+        if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, omitWwwSubdomain, lookup)) {
+            return;
+        }
 
 #ifdef WITH_XC_BROWSER_PASSKEYS
-            // With Passkeys, check for the Relying Party instead of URL
-            if (passkey && entry->attributes()->value(BrowserPasskeys::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
-                continue;
-            }
+        // With Passkeys, check for the Relying Party instead of URL
+        if (passkey && entry->attributes()->value(BrowserPasskeys::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
+            return;
+        }
 #endif
 
-            // Additional URL check may have already inserted the entry to the list
-            if (!entries.contains(entry)) {
-                entries.append(entry);
+        // Additional URL check may have already inserted the entry to the list
+        if (!entries.contains(entry)) {
+            entries.append(entry);
+        }
+    };
+
+    // Only check the entries that have a URL on the same base domain as the site
+    auto index = passkey ? nullptr : BrowserUrlIndex::forDatabase(db.data());
+    bool indexed = false;
+    const auto candidates = index ? index->candidates(siteUrl, &indexed) : QList<Entry*>();
+    if (indexed) {
+        const Group* lastGroup = nullptr;
+        bool groupIncluded = false;
+        bool omitWwwSubdomain = false;
+        for (auto* entry : candidates) {
+            // Candidates are in tree order, so the entries of a group follow each other
+            const auto* group = entry->group();
+            if (group != lastGroup) {
+                lastGroup = group;
+                groupIncluded = group && !group->isRecycled() && groupVisible(group, &omitWwwSubdomain);
+            }
+            if (groupIncluded) {
+                addEntry(entry, omitWwwSubdomain);
             }
         }
+        return entries;
     }
 
+    rootGroup->forEachGroup(
+        [&](const Group* group) {
+            bool omitWwwSubdomain = false;
+            if (!groupVisible(group, &omitWwwSubdomain)) {
+                return;
+            }
+
+            for (auto* entry : group->entries()) {
+                addEntry(entry, omitWwwSubdomain);
+            }
+        },
+        Group::SkipRecycled);
+
     return entries;
 }
 
@@ -1061,6 +1110,16 @@ QList<Entry*> BrowserService::searchEntries(const QString& siteUrl,
                                             const QString& formUrl,
                                             const StringPairList& keyList,
                                             bool passkey)
+{
+    return searchEntries(searchDatabases(), siteUrl, formUrl, keyList, passkey);
+}
+
+QList<Entry*> BrowserService::searchEntries(const QList<QSharedPointer<Database>>& databases,
+                                            const QString& siteUrl,
+                                            const QString& formUrl,
+                                            const StringPairList& keyList,
+                                            bool passkey,
+                                            const BrowserLookup* lookup)
 {
     // Check if database is connected with KeePassXC-Browser. If so, return browser key (otherwise empty)
     auto databaseConnected = [&](const QSharedPointer<Database>& db) {
@@ -1073,39 +1132,41 @@ QList<Entry*> BrowserService::searchEntries(const QString& siteUrl,
         return QString();
     };
 
-    // Get the list of databases to search
-    QList<QSharedPointer<Database>> databases;
+    // Only search the databases connected with KeePassXC-Browser
+    QList<QSharedPointer<Database>> connectedDatabases;
     QStringList keys;
-    if (browserSettings()->searchInAllDatabases()) {
-        for (auto dbWidget : getMainWindow()->getOpenDatabases()) {
-            auto db = dbWidget->database();
-            auto key = databaseConnected(dbWidget->database());
-            if (db && !key.isEmpty()) {
-                databases << db;
-                keys << key;
-            }
-        }
-    } else {
-        const auto& db = getDatabase();
+    for (const auto& db : databases) {
         auto key = databaseConnected(db);
         if (!key.isEmpty()) {
-            databases << db;
+            connectedDatabases << db;
             keys << key;
         }
     }
 
-    // Search entries matching the hostname
-    QString hostname = QUrl(siteUrl).host();
     QList<Entry*> entries;
-    do {
-        for (const auto& db : databases) {
-            entries << searchEntries(db, siteUrl, formUrl, keys, passkey);
-        }
-    } while (entries.isEmpty() && removeFirstDomain(hostname));
+    for (const auto& db : connectedDatabases) {
+        entries << searchEntries(db, siteUrl, formUrl, keys, passkey, lookup);
+    }
 
     return entries;
 }
 
+/**
+ * @return databases that browser requests are answered from
+ */
+QList<QSharedPointer<Database>> BrowserService::searchDatabases()
+{
+    if (browserSettings()->searchInAllDatabases()) {
+        return getOpenDatabases();
+    }
+
+    QList<QSharedPointer<Database>> databases;
+    if (auto db = getDatabase()) {
+        databases << db;
+    }
+    return databases;
+}
+
 QString BrowserService::decodeCustomDataRestrictKey(const QString& key)
 {
     return key.isEmpty() ? tr("Disable") : key;
@@ -1116,8 +1177,13 @@ void BrowserService::requestGlobalAutoType(const QString& search)
     emit osUtils->globalShortcutTriggered("autotype", search);
 }
 
-QList<Entry*> BrowserService::sortEntries(QList<Entry*>& entries, const QString& siteUrl, const QString& formUrl)
+QList<Entry*> BrowserService::sortEntries(QList<Entry*>& entries,
+                                          const QString& siteUrl,
+                                          const QString& formUrl,
+                                          const BrowserLookup* lookup)
 {
+    const bool bestMatchOnly = lookup ? lookup->bestMatchOnly : browserSettings()->bestMatchOnly();
+
     // Build map of prioritized entries
     QMultiMap<int, Entry*> priorities;
     for (auto* entry : entries) {
@@ -1131,7 +1197,7 @@ QList<Entry*> BrowserService::sortEntries(QList<Entry*>& entries, const QString&
     for (auto key : keys) {
         results << priorities.values(key);
 
-        if (browserSettings()->bestMatchOnly() && !results.isEmpty()) {
+        if (bestMatchOnly && !results.isEmpty()) {
             // Early out once we find the highest batch of matches
             break;
         }
@@ -1174,7 +1240,7 @@ void BrowserService::denyEntry(Entry* entry, const QString& siteHost, const QStr
     config.save(entry);
 }
 
-QJsonObject BrowserService::prepareEntry(const Entry* entry)
+QJsonObject BrowserService::prepareEntry(const Entry* entry, const BrowserLookup* lookup)
 {
     QJsonObject res;
     res["login"] = entry->resolveMultiplePlaceholders(entry->username());
@@ -1191,7 +1257,7 @@ QJsonObject BrowserService::prepareEntry(const Entry* entry)
         res["expired"] = TRUE_STR;
     }
 
-    auto skipAutoSubmitGroup = entry->group()->resolveCustomDataTriState(BrowserService::OPTION_SKIP_AUTO_SUBMIT);
+    auto skipAutoSubmitGroup = groupOption(entry, BrowserService::OPTION_SKIP_AUTO_SUBMIT);
     if (skipAutoSubmitGroup == Group::Inherit) {
         if (entry->customData()->contains(BrowserService::OPTION_SKIP_AUTO_SUBMIT)) {
             res["skipAutoSubmit"] = entry->customData()->value(BrowserService::OPTION_SKIP_AUTO_SUBMIT);
@@ -1200,7 +1266,7 @@ QJsonObject BrowserService::prepareEntry(const Entry* entry)
         res["skipAutoSubmit"] = skipAutoSubmitGroup == Group::Enable ? TRUE_STR : FALSE_STR;
     }
 
-    if (browserSettings()->supportKphFields()) {
+    if (lookup ? lookup->supportKphFields : browserSettings()->supportKphFields()) {
         const EntryAttributes* attr = entry->attributes();
         QJsonArray stringFields;
         for (const auto& key : attr->keys()) {
@@ -1215,10 +1281,14 @@ QJsonObject BrowserService::prepareEntry(const Entry* entry)
     return res;
 }
 
-BrowserService::Access
-BrowserService::checkAccess(const Entry* entry, const QString& siteHost, const QString& formHost, const QString& realm)
+BrowserService::Access BrowserService::checkAccess(const Entry* entry,
+                                                  const QString& siteHost,
+                                                  const QString& formHost,
+                                                  const QString& realm,
+                                                  const BrowserLookup* lookup)
 {
-    if (entry->isExpired() && !browserSettings()->allowExpiredCredentials()) {
+    const bool allowExpired = lookup ? lookup->allowExpiredCredentials : browserSettings()->allowExpiredCredentials();
+    if (entry->isExpired() && !allowExpired) {
         return Denied;
     }
 
@@ -1250,10 +1320,17 @@ Group* BrowserService::getDefaultEntryGroup(const QSharedPointer<Database>& sele
         return nullptr;
     }
 
-    for (auto* g : rootGroup->groupsRecursive(true)) {
-        if (g->name() == KEEPASSXCBROWSER_GROUP_NAME && !g->isRecycled()) {
-            return db->rootGroup()->findGroupByUuid(g->uuid());
-        }
+    Group* defaultGroup = nullptr;
+    rootGroup->forEachGroup(
+        [&defaultGroup](Group* g) {
+            if (g->name() == KEEPASSXCBROWSER_GROUP_NAME) {
+                defaultGroup = g;
+            }
+            return !defaultGroup;
+        },
+        Group::SkipRecycled);
+    if (defaultGroup) {
+        return defaultGroup;
     }
 
     auto* group = new Group();
@@ -1337,29 +1414,13 @@ int BrowserService::sortPriority(const QStringList& urls, const QString& siteUrl
     return *std::max_element(priorityList.begin(), priorityList.end());
 }
 
-bool BrowserService::removeFirstDomain(QString& hostname)
-{
-    int pos = hostname.indexOf(".");
-    if (pos < 0) {
-        return false;
-    }
-
-    // Don't remove the second-level domain if it's the only one
-    if (hostname.count(".") > 1) {
-        hostname = hostname.mid(pos + 1);
-        return !hostname.isEmpty();
-    }
-
-    // Nothing removed
-    return false;
-}
-
 /* Test if a search URL matches a custom entry. If the URL has the schema "keepassxc", some special checks will be made.
  * Otherwise, this simply delegates to handleURL(). */
 bool BrowserService::shouldIncludeEntry(Entry* entry,
                                         const QString& url,
                                         const QString& submitUrl,
-                                        const bool omitWwwSubdomain)
+                                        const bool omitWwwSubdomain,
+                                        const BrowserLookup* lookup)
 {
     // Use this special scheme to find entries by UUID
     if (url.startsWith("keepassxc://by-uuid/")) {
@@ -1370,7 +1431,7 @@ bool BrowserService::shouldIncludeEntry(Entry* entry,
 
     const auto allEntryUrls = entry->getAllUrls();
     for (const auto& entryUrl : allEntryUrls) {
-        if (handleURL(entryUrl, url, submitUrl, omitWwwSubdomain)) {
+        if (handleURL(entryUrl, url, submitUrl, omitWwwSubdomain, lookup)) {
             return true;
         }
     }
@@ -1458,19 +1519,22 @@ QJsonObject BrowserService::getPasskeyError(int errorCode) const
 bool BrowserService::handleURL(const QString& entryUrl,
                                const QString& siteUrl,
                                const QString& formUrl,
-                               const bool omitWwwSubdomain)
+                               const bool omitWwwSubdomain,
+                               const BrowserLookup* lookup)
 {
     if (entryUrl.isEmpty()) {
         return false;
     }
 
+    const bool matchUrlScheme = lookup ? lookup->matchUrlScheme : browserSettings()->matchUrlScheme();
+
     QUrl entryQUrl;
     if (entryUrl.contains("://")) {
         entryQUrl = entryUrl;
     } else {
         entryQUrl = QUrl::fromUserInput(entryUrl);
 
-        if (browserSettings()->matchUrlScheme()) {
+        if (matchUrlScheme) {
             entryQUrl.setScheme("https");
         }
     }
@@ -1497,7 +1561,7 @@ bool BrowserService::handleURL(const QString& entryUrl,
     }
 
     // Match scheme
-    if (browserSettings()->matchUrlScheme() && !entryQUrl.scheme().isEmpty()
+    if (matchUrlScheme && !entryQUrl.scheme().isEmpty()
         && entryQUrl.scheme().compare(siteQUrl.scheme()) != 0) {
         return false;
     }
@@ -1658,6 +1722,13 @@ void BrowserService::databaseUnlocked(DatabaseWidget* dbWidget)
             hideWindow();
         }
 
+        // Index the entry URLs now, rather than on the first request from the browser
+        if (browserSettings()->isEnabled()) {
+            if (auto index = BrowserUrlIndex::forDatabase(dbWidget->database().data())) {
+                index->ensureBuilt();
+            }
+        }
+
         QJsonObject msg;
         msg["action"] = QString("database-unlocked");
         m_browserHost->broadcastClientMessage(msg);
@@ -1690,6 +1761,70 @@ void BrowserService::processClientMessage(QLocalSocket* socket, const QJsonObjec
     }
 
     auto& action = m_browserClients.value(clientID);
+    if (BrowserAction::isLookup(message) && isDatabaseOpened()) {
+        processLookup(socket, action, message);
+        return;
+    }
+
     auto response = action->processClientMessage(socket, message);
     m_browserHost->sendClientMessage(socket, response);
 }
+
+/**
+ * Answer a read-only request on the lookup pool, so requests from several tabs are
+ * served in parallel and do not block the GUI. Requests that turn out to need the
+ * GUI, e.g. to confirm access to entries, are processed again on the GUI thread.
+ * Replies are sent as soon as they are ready, the extension matches them by nonce.
+ */
+void BrowserService::processLookup(QLocalSocket* socket,
+                                   const QSharedPointer<BrowserAction>& action,
+                                   const QJsonObject& message)
+{
+    // The worker gets its own copy of the client state, which only the GUI thread changes
+    auto lookupAction = QSharedPointer<BrowserAction>::create(*action);
+    auto lookup = QSharedPointer<BrowserLookup>::create(createLookup());
+
+    auto future = QtConcurrent::run(&m_lookupPool, [=] { return lookupAction->processLookup(message, lookup.data()); });
+    auto watcher = new QFutureWatcher<QJsonObject>(this);
+    // The client may disconnect while the lookup is running
+    QPointer<QLocalSocket> client(socket);
+    connect(watcher, &QFutureWatcherBase::finished, this, [=] {
+        watcher->deleteLater();
+        if (!client) {
+            return;
+        }
+        auto response = lookup->guiRequired ? action->processClientMessage(client, message) : future.result();
+        m_browserHost->sendClientMessage(client, response);
+    });
+    watcher->setFuture(future);
+}
+
+/**
+ * Take the snapshots of the databases a lookup needs, must be called on the GUI thread.
+ */
+BrowserLookup BrowserService::createLookup()
+{
+    BrowserLookup lookup;
+    lookup.databaseHash = getDatabaseHash();
+    lookup.alwaysAllowAccess = browserSettings()->alwaysAllowAccess();
+    lookup.httpAuthPermission = browserSettings()->httpAuthPermission();
+    lookup.allowExpiredCredentials = browserSettings()->allowExpiredCredentials();
+    lookup.matchUrlScheme = browserSettings()->matchUrlScheme();
+    lookup.bestMatchOnly = browserSettings()->bestMatchOnly();
+    lookup.supportKphFields = browserSettings()->supportKphFields();
+    auto readSnapshot = [](const QSharedPointer<Database>& db) {
+        auto snapshot = db->readSnapshot();
+        if (auto index = BrowserUrlIndex::forDatabase(db.data())) {
+            index->shareWith(snapshot.data());
+        }
+        return snapshot;
+    };
+
+    if (auto db = getDatabase()) {
+        lookup.database = readSnapshot(db);
+    }
+    for (const auto& db : searchDatabases()) {
+        lookup.databases << readSnapshot(db);
+    }
+    return lookup;
+}
@@ -25,6 +25,8 @@
 #include "core/Entry.h"
 #include "gui/PasswordGeneratorWidget.h"
 
+#include <QThreadPool>
+
 class QLocalSocket;
 
 typedef QPair<QString, QString> StringPair;
@@ -56,6 +58,26 @@ struct EntryParameters
     bool httpAuth;
 };
 
+/**
+ * Read-only copies of the open databases for answering browser requests
+ * on a worker thread, see Database::readSnapshot().
+ */
+struct BrowserLookup
+{
+    QSharedPointer<Database> database;
+    QList<QSharedPointer<Database>> databases;
+    QString databaseHash;
+    // Browser settings at the time of the request, the worker must not read the settings itself
+    bool alwaysAllowAccess = false;
+    bool httpAuthPermission = false;
+    bool allowExpiredCredentials = false;
+    bool matchUrlScheme = false;
+    bool bestMatchOnly = false;
+    bool supportKphFields = false;
+    // Set if the request has to be answered on the GUI thread instead, e.g. to confirm access to entries
+    bool guiRequired = false;
+};
+
 class DatabaseWidget;
 class BrowserHost;
 class BrowserAction;
@@ -78,10 +100,10 @@ public:
     bool openDatabase(bool triggerUnlock);
     void lockDatabase();
 
-    QJsonObject getDatabaseGroups();
+    QJsonObject getDatabaseGroups(const BrowserLookup* lookup = nullptr);
     QJsonArray getDatabaseEntries();
     QJsonObject createNewGroup(const QString& groupName, bool isPasskeysGroup = false);
-    QString getCurrentTotp(const QString& uuid);
+    QString getCurrentTotp(const QString& uuid, const BrowserLookup* lookup = nullptr);
     void showPasswordGenerator(const KeyPairMessage& keyPairMessage);
     bool isPasswordGeneratorRequested() const;
     QSharedPointer<Database> getDatabase(const QUuid& rootGroupUuid = {});
@@ -120,7 +142,10 @@ public:
     bool updateEntry(const EntryParameters& entryParameters, const QString& uuid);
     bool deleteEntry(const QString& uuid);
     void removePluginData(Entry* entry) const;
-    QJsonArray findEntries(const EntryParameters& entryParameters, const StringPairList& keyList, bool* entriesFound);
+    QJsonArray findEntries(const EntryParameters& entryParameters,
+                           const StringPairList& keyList,
+                           bool* entriesFound,
+                           BrowserLookup* lookup = nullptr);
     void requestGlobalAutoType(const QString& search);
 
     static QString decodeCustomDataRestrictKey(const QString& key);
@@ -146,6 +171,12 @@ public slots:
 private slots:
     void processClientMessage(QLocalSocket* socket, const QJsonObject& message);
 
+private:
+    void processLookup(QLocalSocket* socket,
+                       const QSharedPointer<BrowserAction>& action,
+                       const QJsonObject& message);
+    BrowserLookup createLookup();
+
 private:
     enum Access
     {
@@ -165,25 +196,42 @@ private:
                                 const QString& siteUrl,
                                 const QString& formUrl,
                                 const QStringList& keys = {},
-                                bool passkey = false);
+                                bool passkey = false,
+                                const BrowserLookup* lookup = nullptr);
     QList<Entry*>
     searchEntries(const QString& siteUrl, const QString& formUrl, const StringPairList& keyList, bool passkey = false);
-    QList<Entry*> sortEntries(QList<Entry*>& entries, const QString& siteUrl, const QString& formUrl);
+    QList<Entry*> searchEntries(const QList<QSharedPointer<Database>>& databases,
+                                const QString& siteUrl,
+                                const QString& formUrl,
+                                const StringPairList& keyList,
+                                bool passkey = false,
+                                const BrowserLookup* lookup = nullptr);
+    QList<QSharedPointer<Database>> searchDatabases();
+    QList<Entry*> sortEntries(QList<Entry*>& entries,
+                              const QString& siteUrl,
+                              const QString& formUrl,
+                              const BrowserLookup* lookup = nullptr);
     QList<Entry*> confirmEntries(QList<Entry*>& entriesToConfirm,
                                  const EntryParameters& entryParameters,
                                  const QString& siteHost,
                                  const QString& formUrl,
                                  const bool httpAuth);
-    QJsonObject prepareEntry(const Entry* entry);
+    QJsonObject prepareEntry(const Entry* entry, const BrowserLookup* lookup = nullptr);
     void allowEntry(Entry* entry, const QString& siteHost, const QString& formUrl, const QString& realm);
     void denyEntry(Entry* entry, const QString& siteHost, const QString& formUrl, const QString& realm);
     QJsonArray getChildrenFromGroup(Group* group);
-    Access checkAccess(const Entry* entry, const QString& siteHost, const QString& formHost, const QString& realm);
+    Access checkAccess(const Entry* entry,
+                       const QString& siteHost,
+                       const QString& formHost,
+                       const QString& realm,
+                       const BrowserLookup* lookup = nullptr);
     Group* getDefaultEntryGroup(const QSharedPointer<Database>& selectedDb = {});
     int sortPriority(const QStringList& urls, const QString& siteUrl, const QString& formUrl);
-    bool removeFirstDomain(QString& hostname);
-    bool
-    shouldIncludeEntry(Entry* entry, const QString& url, const QString& submitUrl, const bool omitWwwSubdomain = false);
+    bool shouldIncludeEntry(Entry* entry,
+                            const QString& url,
+                            const QString& submitUrl,
+                            const bool omitWwwSubdomain = false,
+                            const BrowserLookup* lookup = nullptr);
 #ifdef WITH_XC_BROWSER_PASSKEYS
     QList<Entry*> getPasskeyEntries(const QString& rpId, const StringPairList& keyList);
     QList<Entry*>
@@ -198,7 +246,8 @@ private:
     bool handleURL(const QString& entryUrl,
                    const QString& siteUrl,
                    const QString& formUrl,
-                   const bool omitWwwSubdomain = false);
+                   const bool omitWwwSubdomain = false,
+                   const BrowserLookup* lookup = nullptr);
     QString getDatabaseRootUuid();
     QString getDatabaseRecycleBinUuid();
     void hideWindow() const;
@@ -207,6 +256,7 @@ private:
 
     QPointer<BrowserHost> m_browserHost;
     QHash<QString, QSharedPointer<BrowserAction>> m_browserClients;
+    QThreadPool m_lookupPool;
 
     bool m_dialogActive;
     bool m_bringToFrontRequested;
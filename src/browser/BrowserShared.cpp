@@ -20,11 +20,32 @@
 #include "config-keepassx.h"
 
 #include <QDir>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QStandardPaths>
 #if defined(KEEPASSXC_DIST_SNAP)
 #include <QProcessEnvironment>
 #endif
 
+namespace
+{
+    const QString PROXY_HELLO_ACTION = QStringLiteral("proxy-hello");
+
+    bool readFully(QIODevice* device, char* data, qint64 size)
+    {
+        while (size > 0) {
+            const auto bytesRead = device->read(data, size);
+            if (bytesRead <= 0) {
+                return false;
+            }
+            data += bytesRead;
+            size -= bytesRead;
+        }
+        return true;
+    }
+} // namespace
+
 namespace BrowserShared
 {
     QString localServerPath()
@@ -57,4 +78,88 @@ namespace BrowserShared
         return QStandardPaths::writableLocation(QStandardPaths::TempLocation) + serverName;
 #endif
     }
+
+    /**
+     * Read a native messaging frame, the message length in native byte order followed
+     * by the message. Blocks until the whole message was read.
+     *
+     * @param device blocking input, e.g. the standard input of the proxy
+     * @param message receives the message, its buffer is reused if possible
+     * @return false at the end of the input or if the message is too long
+     */
+    bool readNativeMessage(QIODevice* device, QByteArray& message)
+    {
+        quint32 length = 0;
+        if (!readFully(device, reinterpret_cast<char*>(&length), sizeof(length))
+            || length > NATIVEMSG_MAX_INPUT_LENGTH) {
+            return false;
+        }
+
+        message.resize(static_cast<int>(length));
+        return readFully(device, message.data(), length);
+    }
+
+    /**
+     * @param message message to send to the browser
+     * @return message prefixed with its length in native byte order
+     */
+    QByteArray frameNativeMessage(const QByteArray& message)
+    {
+        const auto length = static_cast<quint32>(message.size());
+        QByteArray frame;
+        frame.reserve(static_cast<int>(sizeof(length)) + message.size());
+        frame.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        frame.append(message);
+        return frame;
+    }
+
+    /**
+     * Find the end of the next frame in data received from a local socket. The proxy and
+     * KeePassXC frame their messages the same way as the browser does.
+     *
+     * @param buffer received data
+     * @param offset start of the frame in the buffer
+     * @param maxLength longest message accepted
+     * @return size of the frame including the length, 0 if it is incomplete, -1 if the length is invalid
+     */
+    int nativeMessageFrameSize(const QByteArray& buffer, int offset, quint32 maxLength)
+    {
+        quint32 length = 0;
+        if (buffer.size() - offset < static_cast<int>(sizeof(length))) {
+            return 0;
+        }
+
+        memcpy(&length, buffer.constData() + offset, sizeof(length));
+        if (length > maxLength) {
+            return -1;
+        }
+
+        const auto frameSize = static_cast<int>(sizeof(length) + length);
+        return buffer.size() - offset >= frameSize ? frameSize : 0;
+    }
+
+    /**
+     * The proxy sends this message unframed when it connects and waits for the reply.
+     * KeePassXC answers with a framed hello, versions that predate the framing answer
+     * with an unframed error reply because they don't know the action.
+     *
+     * @return hello message of the proxy
+     */
+    QByteArray proxyHelloMessage()
+    {
+        QJsonObject hello;
+        hello["action"] = PROXY_HELLO_ACTION;
+        // Older versions ignore messages without a client id instead of replying
+        hello["clientID"] = QStringLiteral("keepassxc-proxy");
+        return QJsonDocument(hello).toJson(QJsonDocument::Compact);
+    }
+
+    /**
+     * @param message message without the length, either from the proxy or a reply to it
+     * @return true if the message is a hello or a reply to it
+     */
+    bool isProxyHello(const QByteArray& message)
+    {
+        return QJsonDocument::fromJson(message).object().value("action").toString() == PROXY_HELLO_ACTION;
+    }
 } // namespace BrowserShared
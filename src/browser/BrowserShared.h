@@ -20,9 +20,13 @@
 
 #include <QString>
 
+class QIODevice;
+
 namespace BrowserShared
 {
     constexpr int NATIVEMSG_MAX_LENGTH = 1024 * 1024;
+    // Browsers send messages of up to 64 MiB to the native messaging host
+    constexpr quint32 NATIVEMSG_MAX_INPUT_LENGTH = 64 * 1024 * 1024;
 
     enum SupportedBrowsers : int
     {
@@ -38,6 +42,11 @@ namespace BrowserShared
     };
 
     QString localServerPath();
+    bool readNativeMessage(QIODevice* device, QByteArray& message);
+    QByteArray frameNativeMessage(const QByteArray& message);
+    int nativeMessageFrameSize(const QByteArray& buffer, int offset, quint32 maxLength);
+    QByteArray proxyHelloMessage();
+    bool isProxyHello(const QByteArray& message);
 } // namespace BrowserShared
 
 #endif // KEEPASSXC_BROWSERSHARED_H
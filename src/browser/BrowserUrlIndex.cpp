@@ -0,0 +1,319 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrowserUrlIndex.h"
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "gui/UrlTools.h"
+
+#include <QThread>
+#include <QUrl>
+
+#include <algorithm>
+
+namespace
+{
+    // Path of group indices from the root followed by the index of the entry, ordered like a tree traversal
+    QVector<int> treePosition(Entry* entry)
+    {
+        QVector<int> position;
+        auto group = entry->group();
+        if (!group) {
+            return position;
+        }
+
+        position << group->entries().indexOf(entry) << -1;
+        for (; group->parentGroup(); group = group->parentGroup()) {
+            position << group->parentGroup()->children().indexOf(group);
+        }
+        std::reverse(position.begin(), position.end());
+        return position;
+    }
+} // namespace
+
+BrowserUrlIndex::BrowserUrlIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+{
+    connect(db, &Database::entryAdded, this, &BrowserUrlIndex::addEntry);
+    connect(db, &Database::entryRemoved, this, &BrowserUrlIndex::removeEntry);
+    connect(db, &Database::entryModified, this, &BrowserUrlIndex::updateEntry);
+    connect(db, &Database::groupAboutToAdd, this, &BrowserUrlIndex::addGroup);
+    connect(db, &Database::groupAboutToRemove, this, &BrowserUrlIndex::removeGroup);
+}
+
+/**
+ * @param db database to index
+ * @return index of the database, nullptr if it has none yet and this is not the thread of the database
+ */
+BrowserUrlIndex* BrowserUrlIndex::forDatabase(Database* db)
+{
+    auto index = db->findChild<BrowserUrlIndex*>(QString(), Qt::FindDirectChildrenOnly);
+    if (!index && QThread::currentThread() == db->thread()) {
+        index = new BrowserUrlIndex(db);
+    }
+    return index;
+}
+
+/**
+ * Find the entries that may have a URL matching the site, see BrowserService::handleURL().
+ *
+ * @param siteUrl URL of the site
+ * @param ok set to false if the index cannot answer, e.g. for local files
+ * @return candidate entries in the order of the group tree
+ */
+QList<Entry*> BrowserUrlIndex::candidates(const QString& siteUrl, bool* ok)
+{
+    // Local files and the keepassxc:// scheme are not matched by host
+    const QUrl url(siteUrl);
+    if (url.host().isEmpty() || url.scheme() == "file" || url.scheme() == "keepassxc") {
+        *ok = false;
+        return {};
+    }
+
+    const auto key = hostKey(url.host());
+    QSet<Entry*> found;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!isCurrent()) {
+            build();
+        }
+        found = m_entries.value(key);
+        found.unite(m_unresolvedEntries);
+    }
+
+    QVector<QPair<QVector<int>, Entry*>> ordered;
+    ordered.reserve(found.size());
+    for (auto entry : asConst(found)) {
+        ordered.append({treePosition(entry), entry});
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    QList<Entry*> entries;
+    entries.reserve(ordered.size());
+    for (const auto& candidate : asConst(ordered)) {
+        entries << candidate.second;
+    }
+
+    *ok = true;
+    return entries;
+}
+
+/**
+ * Build the index now instead of on first use.
+ */
+void BrowserUrlIndex::ensureBuilt()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!isCurrent()) {
+        build();
+    }
+}
+
+/**
+ * Attach an index to a read snapshot of the database, see Database::readSnapshot().
+ * The snapshot is an exact copy of the tree, so the entries of this index are mapped
+ * over instead of parsing their URLs again. Must be called on the thread of the database.
+ *
+ * @param snapshot read snapshot of the indexed database
+ */
+void BrowserUrlIndex::shareWith(Database* snapshot)
+{
+    if (snapshot->findChild<BrowserUrlIndex*>(QString(), Qt::FindDirectChildrenOnly)) {
+        return;
+    }
+    auto index = new BrowserUrlIndex(snapshot);
+
+    QMutexLocker locker(&m_mutex);
+    if (!isCurrent()) {
+        build();
+    }
+
+    QList<Entry*> entries;
+    QList<Entry*> snapshotEntries;
+    m_db->rootGroup()->forEachGroup([&entries](Group* group) { entries.append(group->entries()); });
+    snapshot->rootGroup()->forEachGroup(
+        [&snapshotEntries](Group* group) { snapshotEntries.append(group->entries()); });
+    if (entries.size() != snapshotEntries.size()) {
+        // Not a copy of this tree, the snapshot index is built on first use
+        return;
+    }
+
+    QHash<const Entry*, Entry*> snapshotEntryMap;
+    snapshotEntryMap.reserve(entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        snapshotEntryMap.insert(entries.at(i), snapshotEntries.at(i));
+    }
+
+    for (auto it = m_entryKeys.cbegin(); it != m_entryKeys.cend(); ++it) {
+        auto snapshotEntry = snapshotEntryMap.value(it.key());
+        index->m_entryKeys.insert(snapshotEntry, it.value());
+        for (const auto& key : it.value()) {
+            index->m_entries[key].insert(snapshotEntry);
+        }
+    }
+    for (auto entry : asConst(m_unresolvedEntries)) {
+        index->m_unresolvedEntries.insert(snapshotEntryMap.value(entry));
+    }
+    index->m_rootGroup = snapshot->rootGroup();
+}
+
+void BrowserUrlIndex::addEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (isCurrent()) {
+        insertEntry(entry);
+    }
+}
+
+void BrowserUrlIndex::removeEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (isCurrent()) {
+        eraseEntry(entry);
+    }
+}
+
+void BrowserUrlIndex::updateEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (isCurrent()) {
+        eraseEntry(entry);
+        insertEntry(entry);
+    }
+}
+
+void BrowserUrlIndex::addGroup(Group* group)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!isCurrent()) {
+        return;
+    }
+
+    group->forEachGroup([this](Group* child) {
+        for (auto entry : child->entries()) {
+            insertEntry(entry);
+        }
+    });
+}
+
+void BrowserUrlIndex::removeGroup(Group* group)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!isCurrent()) {
+        return;
+    }
+
+    group->forEachGroup([this](Group* child) {
+        for (auto entry : child->entries()) {
+            eraseEntry(entry);
+        }
+    });
+}
+
+bool BrowserUrlIndex::isCurrent() const
+{
+    return m_rootGroup && m_rootGroup == m_db->rootGroup();
+}
+
+void BrowserUrlIndex::build()
+{
+    clear();
+
+    auto rootGroup = m_db->rootGroup();
+    if (!rootGroup) {
+        return;
+    }
+
+    rootGroup->forEachGroup([this](Group* group) {
+        for (auto entry : group->entries()) {
+            insertEntry(entry);
+        }
+    });
+    m_rootGroup = rootGroup;
+}
+
+void BrowserUrlIndex::clear()
+{
+    m_entries.clear();
+    m_unresolvedEntries.clear();
+    m_entryKeys.clear();
+    m_rootGroup.clear();
+}
+
+void BrowserUrlIndex::insertEntry(Entry* entry)
+{
+    if (m_entryKeys.contains(entry)) {
+        return;
+    }
+
+    QStringList keys;
+    for (const auto& url : entry->getAllUrls(false)) {
+        if (url.contains('{')) {
+            m_unresolvedEntries.insert(entry);
+            continue;
+        }
+
+        // Parsed the same way as BrowserService::handleURL() does
+        const auto host = url.contains("://") ? QUrl(url).host() : QUrl::fromUserInput(url).host();
+        if (host.isEmpty()) {
+            continue;
+        }
+
+        keys << hostKey(host);
+        if (host.startsWith("www.")) {
+            // The www subdomain may be omitted by a group setting
+            keys << hostKey(QString(host).remove("www."));
+        }
+    }
+    keys.removeDuplicates();
+
+    for (const auto& key : asConst(keys)) {
+        m_entries[key].insert(entry);
+    }
+    m_entryKeys.insert(entry, keys);
+}
+
+void BrowserUrlIndex::eraseEntry(Entry* entry)
+{
+    const auto it = m_entryKeys.find(entry);
+    if (it == m_entryKeys.end()) {
+        return;
+    }
+
+    for (const auto& key : it.value()) {
+        auto entries = m_entries.find(key);
+        if (entries != m_entries.end()) {
+            entries->remove(entry);
+            if (entries->isEmpty()) {
+                m_entries.erase(entries);
+            }
+        }
+    }
+    m_unresolvedEntries.remove(entry);
+    m_entryKeys.erase(it);
+}
+
+/**
+ * @return base domain of the host, a site only matches entries with the same base domain
+ */
+QString BrowserUrlIndex::hostKey(const QString& host)
+{
+    return urlTools()->getBaseDomainFromUrl(host);
+}
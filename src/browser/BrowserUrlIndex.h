@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_BROWSERURLINDEX_H
+#define KEEPASSXC_BROWSERURLINDEX_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Maps the base domains of the entry URLs in a database to the entries, so a
+ * browser request only has to check the entries that can match the site.
+ *
+ * The index is attached to the database, built on first use and then kept up
+ * to date from the entry and group signals of the database. History items are
+ * not indexed. URLs with placeholders depend on other fields and entries, so
+ * their entries are candidates for every site.
+ *
+ * Lookups are thread-safe, the index of a read snapshot can be used by several
+ * lookup threads at once.
+ */
+class BrowserUrlIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static BrowserUrlIndex* forDatabase(Database* db);
+
+    QList<Entry*> candidates(const QString& siteUrl, bool* ok);
+    void ensureBuilt();
+    void shareWith(Database* snapshot);
+
+private slots:
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+    void updateEntry(Entry* entry);
+    void addGroup(Group* group);
+    void removeGroup(Group* group);
+
+private:
+    explicit BrowserUrlIndex(Database* db);
+
+    bool isCurrent() const;
+    void build();
+    void clear();
+    void insertEntry(Entry* entry);
+    void eraseEntry(Entry* entry);
+
+    static QString hostKey(const QString& host);
+
+    Database* m_db;
+    QMutex m_mutex;
+    // The root group the index was built from, the database may replace it
+    QPointer<Group> m_rootGroup;
+    QHash<QString, QSet<Entry*>> m_entries;
+    QSet<Entry*> m_unresolvedEntries;
+    // Entries are removed by the keys they were indexed with, their URLs may have changed since
+    QHash<const Entry*, QStringList> m_entryKeys;
+};
+
+#endif // KEEPASSXC_BROWSERURLINDEX_H
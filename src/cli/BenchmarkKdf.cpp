@@ -0,0 +1,196 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkKdf.h"
+
+#include "Utils.h"
+#include "core/Global.h"
+#include "crypto/kdf/Argon2Kdf.h"
+#include "crypto/kdf/KdfBenchmark.h"
+#include "format/KeePass2.h"
+
+#include <QCommandLineParser>
+#include <QThread>
+
+namespace
+{
+    const QString DefaultMemories = QStringLiteral("16,64,256");
+
+    template <typename T> bool parseList(const QString& value, QList<T>& list)
+    {
+        for (const auto& item : value.split(',', Qt::SkipEmptyParts)) {
+            bool ok;
+            const auto number = item.trimmed().toULongLong(&ok);
+            if (!ok || number == 0) {
+                return false;
+            }
+            list << static_cast<T>(number);
+        }
+        return !list.isEmpty();
+    }
+
+    QString formatMs(double ns)
+    {
+        return QString::number(ns / 1e6, 'f', 3);
+    }
+} // namespace
+
+const QCommandLineOption BenchmarkKdf::KdfOption =
+    QCommandLineOption(QStringList() << "kdf",
+                       QObject::tr("Key derivation function to measure: argon2id (default), argon2d or aes."),
+                       QObject::tr("kdf"),
+                       QStringLiteral("argon2id"));
+
+const QCommandLineOption BenchmarkKdf::DecryptionTimeOption =
+    QCommandLineOption(QStringList() << "t" << "decryption-time",
+                       QObject::tr("Target decryption time in MS to calibrate the rounds for."),
+                       QObject::tr("time"),
+                       QString::number(Kdf::DEFAULT_ENCRYPTION_TIME));
+
+const QCommandLineOption BenchmarkKdf::MemoryOption =
+    QCommandLineOption(QStringList() << "m" << "memory",
+                       QObject::tr("Comma separated list of Argon2 memory sizes in MiB to measure."),
+                       QObject::tr("sizes"),
+                       DefaultMemories);
+
+const QCommandLineOption BenchmarkKdf::ParallelismOption =
+    QCommandLineOption(QStringList() << "p" << "parallelism",
+                       QObject::tr("Comma separated list of Argon2 thread counts to measure, "
+                                   "defaults to 1 and the number of CPU threads."),
+                       QObject::tr("threads"));
+
+const QCommandLineOption BenchmarkKdf::SamplesOption =
+    QCommandLineOption(QStringList() << "s" << "samples",
+                       QObject::tr("Number of measurements per parameter set, the median is used."),
+                       QObject::tr("count"),
+                       QString::number(KdfBenchmark::DefaultSamples));
+
+BenchmarkKdf::BenchmarkKdf()
+{
+    name = QString("kdf-benchmark");
+    description = QObject::tr("Measure unlock times of key derivation parameters on this computer.");
+    options.append(BenchmarkKdf::KdfOption);
+    options.append(BenchmarkKdf::DecryptionTimeOption);
+    options.append(BenchmarkKdf::MemoryOption);
+    options.append(BenchmarkKdf::ParallelismOption);
+    options.append(BenchmarkKdf::SamplesOption);
+}
+
+int BenchmarkKdf::execute(const QStringList& arguments)
+{
+    QSharedPointer<QCommandLineParser> parser = getCommandLineParser(arguments);
+    if (parser.isNull()) {
+        return EXIT_FAILURE;
+    }
+
+    auto& out = Utils::STDOUT;
+    auto& err = Utils::STDERR;
+
+    const auto kdfName = parser->value(BenchmarkKdf::KdfOption).toLower();
+    QSharedPointer<Kdf> kdf;
+    if (kdfName == "argon2id") {
+        kdf = KeePass2::uuidToKdf(KeePass2::KDF_ARGON2ID);
+    } else if (kdfName == "argon2d") {
+        kdf = KeePass2::uuidToKdf(KeePass2::KDF_ARGON2D);
+    } else if (kdfName == "aes") {
+        kdf = KeePass2::uuidToKdf(KeePass2::KDF_AES_KDBX4);
+    } else {
+        err << QObject::tr("Unsupported key derivation function %1.").arg(kdfName) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto decryptionTimeValue = parser->value(BenchmarkKdf::DecryptionTimeOption);
+    const int decryptionTime = decryptionTimeValue.toInt();
+    if (decryptionTime < Kdf::MIN_ENCRYPTION_TIME || decryptionTime > Kdf::MAX_ENCRYPTION_TIME) {
+        err << QObject::tr("Target decryption time must be between %1 and %2.")
+                   .arg(QString::number(Kdf::MIN_ENCRYPTION_TIME), QString::number(Kdf::MAX_ENCRYPTION_TIME))
+            << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto samplesValue = parser->value(BenchmarkKdf::SamplesOption);
+    const int samples = samplesValue.toInt();
+    if (samples <= 0) {
+        err << QObject::tr("Invalid sample count %1.").arg(samplesValue) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    QList<KdfBenchmark::Argon2Point> points;
+    auto argon2Kdf = kdf.dynamicCast<Argon2Kdf>();
+    if (argon2Kdf) {
+        QList<quint64> memories;
+        const auto memoryValue = parser->value(BenchmarkKdf::MemoryOption);
+        if (!parseList(memoryValue, memories)) {
+            err << QObject::tr("Invalid memory sizes %1.").arg(memoryValue) << Qt::endl;
+            return EXIT_FAILURE;
+        }
+        for (auto& memory : memories) {
+            memory *= 1024;
+        }
+
+        QList<quint32> parallelisms;
+        if (parser->isSet(BenchmarkKdf::ParallelismOption)) {
+            const auto parallelismValue = parser->value(BenchmarkKdf::ParallelismOption);
+            if (!parseList(parallelismValue, parallelisms)) {
+                err << QObject::tr("Invalid thread counts %1.").arg(parallelismValue) << Qt::endl;
+                return EXIT_FAILURE;
+            }
+        } else {
+            parallelisms << 1;
+            if (QThread::idealThreadCount() > 1) {
+                parallelisms << static_cast<quint32>(QThread::idealThreadCount());
+            }
+        }
+
+        points = KdfBenchmark::sweepArgon2(*argon2Kdf, memories, parallelisms, samples);
+    } else {
+        points.append({0, 1, KdfBenchmark::measure(*kdf, samples, false)});
+    }
+
+    const QStringList header = {QObject::tr("Memory (MiB)"),
+                                QObject::tr("Threads"),
+                                QObject::tr("Rounds"),
+                                QObject::tr("Round (ms)"),
+                                QObject::tr("Overhead (ms)"),
+                                QObject::tr("Unlock (ms)")};
+    out << QObject::tr("%1 calibrated for %2 ms:").arg(KeePass2::kdfToString(kdf->uuid())).arg(decryptionTime)
+        << Qt::endl;
+    out << header.join('\t') << Qt::endl;
+
+    bool ok = true;
+    for (const auto& point : asConst(points)) {
+        if (!point.result.isValid()) {
+            err << QObject::tr("Failed to measure %1 MiB with %2 threads.")
+                       .arg(point.memory / 1024)
+                       .arg(point.parallelism)
+                << Qt::endl;
+            ok = false;
+            continue;
+        }
+
+        const auto rounds = point.result.roundsFor(decryptionTime);
+        const QStringList row = {argon2Kdf ? QString::number(point.memory / 1024) : QStringLiteral("-"),
+                                 QString::number(point.parallelism),
+                                 QString::number(rounds),
+                                 formatMs(point.result.roundNs),
+                                 formatMs(point.result.overheadNs),
+                                 QString::number(point.result.estimateMs(rounds))};
+        out << row.join('\t') << Qt::endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -19,6 +19,10 @@
 
 #include "Utils.h"
 #include "core/Global.h"
+#include "core/Metadata.h"
+#include "crypto/kdf/Argon2Kdf.h"
+#include "crypto/kdf/KdfBenchmark.h"
+#include "format/KeePass2.h"
 #include "keys/FileKey.h"
 
 #include <QCommandLineParser>
@@ -29,6 +33,11 @@ const QCommandLineOption DatabaseCreate::DecryptionTimeOption =
                        QObject::tr("Target decryption time in MS for the database."),
                        QObject::tr("time"));
 
+const QCommandLineOption DatabaseCreate::TuneKdfOption =
+    QCommandLineOption(QStringList() << "tune-kdf",
+                       QObject::tr("Use Argon2 with memory and threads chosen for this computer to meet the "
+                                   "decryption time."));
+
 const QCommandLineOption DatabaseCreate::SetKeyFileShortOption = QCommandLineOption(
     QStringList() << "k",
     QObject::tr("Set the key file for the database.\nThis option is deprecated, use --set-key-file instead."),
@@ -51,6 +60,7 @@ DatabaseCreate::DatabaseCreate()
     options.append(DatabaseCreate::SetKeyFileShortOption);
     options.append(DatabaseCreate::SetPasswordOption);
     options.append(DatabaseCreate::DecryptionTimeOption);
+    options.append(DatabaseCreate::TuneKdfOption);
 }
 
 QSharedPointer<Database> DatabaseCreate::initializeDatabaseFromOptions(const QSharedPointer<QCommandLineParser>& parser)
@@ -78,6 +88,10 @@ QSharedPointer<Database> DatabaseCreate::initializeDatabaseFromOptions(const QSh
             return {};
         }
     }
+    if (parser->isSet(DatabaseCreate::TuneKdfOption) && decryptionTime == 0) {
+        decryptionTime = Kdf::DEFAULT_ENCRYPTION_TIME;
+        decryptionTimeValue = QString::number(decryptionTime);
+    }
 
     auto key = QSharedPointer<CompositeKey>::create();
 
@@ -119,7 +133,26 @@ QSharedPointer<Database> DatabaseCreate::initializeDatabaseFromOptions(const QSh
     auto db = QSharedPointer<Database>::create();
     db->setKey(key);
 
-    if (decryptionTime != 0) {
+    if (parser->isSet(DatabaseCreate::TuneKdfOption)) {
+        auto kdf = KeePass2::uuidToKdf(KeePass2::KDF_ARGON2ID).staticCast<Argon2Kdf>();
+
+        out << QObject::tr("Tuning key derivation function for %1ms delay.").arg(decryptionTimeValue) << Qt::endl;
+        if (!KdfBenchmark::tuneArgon2(*kdf, decryptionTime).isValid()) {
+            err << QObject::tr("error while setting database key derivation settings.") << Qt::endl;
+            return {};
+        }
+        out << QObject::tr("Setting %1 rounds, %2 MiB of memory and %3 threads for key derivation function.")
+                   .arg(QString::number(kdf->rounds()),
+                        QString::number(kdf->memory() / 1024),
+                        QString::number(kdf->parallelism()))
+            << Qt::endl;
+
+        if (!db->changeKdf(kdf)) {
+            err << QObject::tr("error while setting database key derivation settings.") << Qt::endl;
+            return {};
+        }
+        db->metadata()->customData()->set(CustomData::DecryptionTimePreference, QString::number(decryptionTime));
+    } else if (decryptionTime != 0) {
         auto kdf = db->kdf();
         Q_ASSERT(kdf);
 
@@ -32,6 +32,7 @@ public:
     static const QCommandLineOption SetKeyFileShortOption;
     static const QCommandLineOption SetPasswordOption;
     static const QCommandLineOption DecryptionTimeOption;
+    static const QCommandLineOption TuneKdfOption;
 };
 
 #endif // KEEPASSXC_DATABASECREATE_H
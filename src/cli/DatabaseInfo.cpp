@@ -23,6 +23,7 @@
 #include "core/Global.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "crypto/kdf/Argon2Kdf.h"
 
 #include <QCommandLineParser>
 
@@ -45,6 +46,19 @@ int DatabaseInfo::executeWithDatabase(QSharedPointer<Database> database, QShared
         }
     }
     out << QObject::tr("KDF: ") << database->kdf()->toString() << Qt::endl;
+    auto argon2Kdf = database->kdf().dynamicCast<Argon2Kdf>();
+    if (argon2Kdf) {
+        out << QObject::tr("KDF memory: ") << QObject::tr("%1 MiB").arg(argon2Kdf->memory() / 1024) << Qt::endl;
+        out << QObject::tr("KDF threads: ") << QString::number(argon2Kdf->parallelism()) << Qt::endl;
+    }
+    const auto decryptionTime = database->metadata()->customData()->value(CustomData::DecryptionTimePreference);
+    if (!decryptionTime.isEmpty()) {
+        out << QObject::tr("Target decryption time: ") << QObject::tr("%1 ms").arg(decryptionTime) << Qt::endl;
+    }
+    if (database->keyTransformTime() >= 0) {
+        out << QObject::tr("Key transformation time: ") << QObject::tr("%1 ms").arg(database->keyTransformTime())
+            << Qt::endl;
+    }
     if (database->metadata()->recycleBinEnabled()) {
         out << QObject::tr("Recycle bin is enabled.") << Qt::endl;
     } else {
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HibpIndex.h"
+
+#include "Utils.h"
+#include "core/HibpOffline.h"
+
+#include <QCommandLineParser>
+#include <QFile>
+#include <QSaveFile>
+
+HibpIndex::HibpIndex()
+{
+    name = QString("hibp-index");
+    description = QObject::tr("Convert a HIBP file sorted by hash into an index for fast analysis.");
+    positionalArguments.append({QString("hibp"),
+                                QObject::tr("Path of the HIBP file, it must be sorted by hash."),
+                                QString("")});
+    positionalArguments.append({QString("index"), QObject::tr("Path of the index file to create."), QString("")});
+}
+
+int HibpIndex::execute(const QStringList& arguments)
+{
+    QSharedPointer<QCommandLineParser> parser = getCommandLineParser(arguments);
+    if (parser.isNull()) {
+        return EXIT_FAILURE;
+    }
+
+    auto& out = parser->isSet(Command::QuietOption) ? Utils::DEVNULL : Utils::STDOUT;
+    auto& err = Utils::STDERR;
+
+    const QStringList args = parser->positionalArguments();
+    const auto& hibpPath = args.at(0);
+    const auto& indexPath = args.at(1);
+
+    QFile hibpFile(hibpPath);
+    if (!hibpFile.open(QFile::ReadOnly)) {
+        err << QObject::tr("Failed to open HIBP file %1: %2").arg(hibpPath).arg(hibpFile.errorString()) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    QSaveFile indexFile(indexPath);
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        err << QObject::tr("Could not open output file %1.").arg(indexPath) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    QString error;
+    if (!HibpOffline::buildIndex(hibpFile, indexFile, &error)) {
+        err << error << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!indexFile.commit()) {
+        err << QObject::tr("Failed to write HIBP index: %1").arg(indexFile.errorString()) << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    out << QObject::tr("Successfully created HIBP index %1.").arg(indexPath) << Qt::endl;
+    return EXIT_SUCCESS;
+}
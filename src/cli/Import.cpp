@@ -46,6 +46,7 @@ Import::Import()
     options.append(DatabaseCreate::SetKeyFileShortOption);
     options.append(DatabaseCreate::SetPasswordOption);
     options.append(DatabaseCreate::DecryptionTimeOption);
+    options.append(DatabaseCreate::TuneKdfOption);
 }
 
 int Import::execute(const QStringList& arguments)
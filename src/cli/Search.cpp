@@ -39,6 +39,7 @@ int Search::executeWithDatabase(QSharedPointer<Database> database, QSharedPointe
     const QStringList args = parser->positionalArguments();
 
     EntrySearcher searcher;
+    searcher.setParallel(true);
     auto results = searcher.search(args.at(1), database->rootGroup(), true);
     if (results.isEmpty()) {
         err << "No results for that search term." << Qt::endl;
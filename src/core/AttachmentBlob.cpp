@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AttachmentBlob.h"
+
+#include "crypto/CryptoHash.h"
+
+AttachmentBlob::AttachmentBlob(QByteArray data)
+    : m_data(std::move(data))
+{
+}
+
+QSharedPointer<const AttachmentBlob> AttachmentBlob::create(const QByteArray& data)
+{
+    return QSharedPointer<const AttachmentBlob>(new AttachmentBlob(data));
+}
+
+const QByteArray& AttachmentBlob::data() const
+{
+    return m_data;
+}
+
+int AttachmentBlob::size() const
+{
+    return m_data.size();
+}
+
+/**
+ * SHA-256 hash of the content, computed on first use.
+ * Safe to call from multiple threads.
+ *
+ * @return content hash
+ */
+QByteArray AttachmentBlob::hash() const
+{
+    QMutexLocker locker(&m_hashMutex);
+    if (m_hash.isEmpty()) {
+        m_hash = CryptoHash::hash(m_data, CryptoHash::Sha256);
+    }
+    return m_hash;
+}
+
+bool AttachmentBlob::operator==(const AttachmentBlob& other) const
+{
+    return this == &other || m_data == other.m_data;
+}
+
+bool AttachmentBlob::operator!=(const AttachmentBlob& other) const
+{
+    return !(*this == other);
+}
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_ATTACHMENTBLOB_H
+#define KEEPASSXC_ATTACHMENTBLOB_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QSharedPointer>
+
+/**
+ * Immutable content of an attachment, addressed by its SHA-256 hash.
+ *
+ * Blobs are shared between the attachments of an entry, its history items and
+ * every copy of them (including the snapshot written by a background save),
+ * so the hash is computed at most once per content and the bytes can be
+ * accounted for once. Readers share one blob per binary of the file.
+ */
+class AttachmentBlob
+{
+public:
+    explicit AttachmentBlob(QByteArray data);
+
+    static QSharedPointer<const AttachmentBlob> create(const QByteArray& data);
+
+    const QByteArray& data() const;
+    int size() const;
+    QByteArray hash() const;
+
+    bool operator==(const AttachmentBlob& other) const;
+    bool operator!=(const AttachmentBlob& other) const;
+
+private:
+    const QByteArray m_data;
+    mutable QMutex m_hashMutex;
+    mutable QByteArray m_hash;
+
+    Q_DISABLE_COPY(AttachmentBlob)
+};
+
+#endif // KEEPASSXC_ATTACHMENTBLOB_H
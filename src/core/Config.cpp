@@ -89,6 +89,7 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
     {Config::LastActiveDatabase, {QS("LastActiveDatabase"), Local, {}}},
     {Config::LastOpenedDatabases, {QS("LastOpenedDatabases"), Local, {}}},
     {Config::LastDir, {QS("LastDir"), Local, QDir::homePath()}},
+    {Config::KdfBenchmarkCache, {QS("KdfBenchmarkCache"), Local, {}}},
 
     // GUI
     {Config::GUI_Language, {QS("GUI/Language"), Roaming, QS("system")}},
@@ -226,7 +227,31 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
 
 QPointer<Config> Config::m_instance(nullptr);
 
+/**
+ * Get a configuration value from the in-memory snapshot of the settings.
+ * Boolean and numeric values are already converted to their type, so this is
+ * cheap enough for hot paths like model rendering and safe to call from any thread.
+ *
+ * @param key config key
+ * @return current value or the default value if the key is not set
+ */
 QVariant Config::get(ConfigKey key)
+{
+    if (key >= 0 && key < Deleted) {
+        if (const auto value = m_cache[key].loadAcquire()) {
+            return *value;
+        }
+    }
+    return getUncached(key);
+}
+
+/**
+ * Read a configuration value from the settings files, bypassing the snapshot used by get().
+ *
+ * @param key config key
+ * @return stored value or the default value if the key is not set
+ */
+QVariant Config::getUncached(ConfigKey key)
 {
     auto cfg = configStrings[key];
     auto defaultValue = configStrings[key].defaultValue;
@@ -264,6 +289,7 @@ void Config::set(ConfigKey key, const QVariant& value)
         m_settings->setValue(cfg.name, value);
     }
 
+    updateCache(key);
     emit changed(key);
 }
 
@@ -276,6 +302,7 @@ void Config::remove(ConfigKey key)
         m_settings->remove(cfg.name);
     }
 
+    updateCache(key);
     emit changed(key);
 }
 
@@ -300,6 +327,38 @@ void Config::resetToDefaults()
     if (m_localSettings) {
         m_localSettings->clear();
     }
+    rebuildCache();
+}
+
+void Config::updateCache(ConfigKey key)
+{
+    auto value = std::make_unique<const QVariant>(cacheValue(key));
+
+    // Replaced values stay alive until the config is destroyed, a setting only changes on user actions
+    QMutexLocker locker(&m_cachedValuesMutex);
+    m_cache[key].storeRelease(value.get());
+    m_cachedValues.push_back(std::move(value));
+}
+
+void Config::rebuildCache()
+{
+    for (int key = 0; key < Deleted; ++key) {
+        updateCache(static_cast<ConfigKey>(key));
+    }
+}
+
+QVariant Config::cacheValue(ConfigKey key)
+{
+    auto value = getUncached(key);
+    // INI files store everything as strings, parse the types used on hot paths only once
+    const auto type = configStrings[key].defaultValue.userType();
+    if (type == QMetaType::Bool || type == QMetaType::Int || type == QMetaType::Double) {
+        auto typed = value;
+        if (typed.convert(type)) {
+            value = typed;
+        }
+    }
+    return value;
 }
 
 /**
@@ -503,6 +562,7 @@ void Config::init(const QString& configFileName, const QString& localConfigFileN
         m_localSettings.reset(new QSettings(localConfigFileName, QSettings::IniFormat));
     }
 
+    rebuildCache();
     migrate();
     connect(qApp, &QCoreApplication::aboutToQuit, this, &Config::sync);
 }
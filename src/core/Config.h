@@ -19,10 +19,15 @@
 #ifndef KEEPASSX_CONFIG_H
 #define KEEPASSX_CONFIG_H
 
+#include <QAtomicPointer>
+#include <QMutex>
 #include <QPointer>
 #include <QVariant>
 #include <QVector>
 
+#include <memory>
+#include <vector>
+
 class QSettings;
 
 class Config : public QObject
@@ -72,6 +77,7 @@ public:
         LastActiveDatabase,
         LastOpenedDatabases,
         LastDir,
+        KdfBenchmarkCache,
 
         GUI_Language,
         GUI_HideMenubar,
@@ -209,6 +215,7 @@ public:
 
     ~Config() override;
     QVariant get(ConfigKey key);
+    QVariant getUncached(ConfigKey key);
     QVariant getDefault(ConfigKey key);
     QString getFileName();
     void set(ConfigKey key, const QVariant& value);
@@ -234,6 +241,9 @@ private:
     explicit Config(QObject* parent);
     void init(const QString& configFileName, const QString& localConfigFileName);
     void migrate();
+    void updateCache(ConfigKey key);
+    void rebuildCache();
+    QVariant cacheValue(ConfigKey key);
     static QPair<QString, QString> defaultConfigFiles();
 
     static QPointer<Config> m_instance;
@@ -241,6 +251,11 @@ private:
     QScopedPointer<QSettings> m_settings;
     QScopedPointer<QSettings> m_localSettings;
     QHash<QString, QVariant> m_defaults;
+    // Current value of every key, a changed key points to a new value and get() never locks
+    QAtomicPointer<const QVariant> m_cache[Deleted];
+    // Owns current and replaced values, a reader on another thread may still copy a replaced one
+    std::vector<std::unique_ptr<const QVariant>> m_cachedValues;
+    QMutex m_cachedValuesMutex;
 };
 
 inline Config* config()
@@ -28,6 +28,7 @@ const QString CustomData::ExcludeFromReportsLegacy = QStringLiteral("KnownBad");
 const QString CustomData::FdoSecretsExposedGroup = QStringLiteral("FDO_SECRETS_EXPOSED_GROUP");
 const QString CustomData::RandomSlug = QStringLiteral("KPXC_RANDOM_SLUG");
 const QString CustomData::RemoteProgramSettings = QStringLiteral("KPXC_REMOTE_SYNC_SETTINGS");
+const QString CustomData::DecryptionTimePreference = QStringLiteral("KPXC_DECRYPTION_TIME_PREFERENCE");
 
 // Fallback item for return by reference
 static const CustomData::CustomDataItem NULL_ITEM{};
@@ -140,7 +141,7 @@ void CustomData::rename(const QString& oldKey, const QString& newKey)
     emit renamed(oldKey, newKey);
 }
 
-void CustomData::copyDataFrom(const CustomData* other)
+void CustomData::copyDataFrom(const CustomData* other, bool keepLastModified)
 {
     if (*this == *other) {
         return;
@@ -150,7 +151,9 @@ void CustomData::copyDataFrom(const CustomData* other)
 
     m_data = other->m_data;
 
-    updateLastModified();
+    if (!keepLastModified) {
+        updateLastModified();
+    }
     emit reset();
     emitModified();
 }
@@ -60,7 +60,7 @@ public:
     bool isEmpty() const;
     int size() const;
     int dataSize() const;
-    void copyDataFrom(const CustomData* other);
+    void copyDataFrom(const CustomData* other, bool keepLastModified = false);
     bool operator==(const CustomData& other) const;
     bool operator!=(const CustomData& other) const;
 
@@ -72,6 +72,7 @@ public:
     static const QString FdoSecretsExposedGroup;
     static const QString RandomSlug;
     static const QString RemoteProgramSettings;
+    static const QString DecryptionTimePreference;
 
     // Pre-KDBX 4.1
     static const QString ExcludeFromReportsLegacy;
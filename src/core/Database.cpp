@@ -19,8 +19,13 @@
 #include "Database.h"
 
 #include "core/AsyncTask.h"
+#include "core/EntrySearchIndex.h"
 #include "core/FileWatcher.h"
 #include "core/Group.h"
+#include "core/GroupSettingsCache.h"
+#include "core/PasswordHealth.h"
+#include "core/PlaceholderCache.h"
+#include "core/UuidIndex.h"
 #include "crypto/Random.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2Reader.h"
@@ -44,6 +49,11 @@ Database::Database()
     , m_data()
     , m_rootGroup(nullptr)
     , m_fileWatcher(new FileWatcher(this))
+    , m_searchIndex(new EntrySearchIndex(this))
+    , m_groupSettingsCache(new GroupSettingsCache(this))
+    , m_placeholderCache(new PlaceholderCache(this))
+    , m_uuidIndex(new UuidIndex(this))
+    , m_passwordHealthCache(new PasswordHealthCache())
     , m_uuid(QUuid::createUuid())
 {
     // setup modified timer
@@ -54,9 +64,19 @@ Database::Database()
         }
     });
     connect(&m_modifiedTimer, &QTimer::timeout, this, &Database::emitModified);
+    connect(&m_backgroundSaveWatcher, &QFutureWatcherBase::finished, this, &Database::finishBackgroundSave);
 
     // other signals
+    // The read snapshot has to follow a change before markAsModified() sees it
+    connect(m_metadata, &Metadata::modified, this, &Database::updateReadSnapshotMetadata);
     connect(m_metadata, &Metadata::modified, this, &Database::markAsModified);
+    connect(this, &Database::entryAboutToAdd, this, &Database::addEntryToReadSnapshot);
+    connect(this, &Database::entryAboutToRemove, this, &Database::removeEntryFromReadSnapshot);
+    connect(this, &Database::entryModified, this, &Database::updateReadSnapshot);
+    connect(this, &Database::groupAboutToAdd, this, &Database::addGroupToReadSnapshot);
+    connect(this, &Database::groupAboutToRemove, this, &Database::removeGroupFromReadSnapshot);
+    connect(this, &Database::groupAboutToMove, this, &Database::moveGroupInReadSnapshot);
+    connect(this, &Database::groupDataChanged, this, &Database::discardReadSnapshot);
     connect(this, &Database::databaseOpened, this, [this]() {
         updateCommonUsernames();
         updateTagList();
@@ -198,7 +218,7 @@ bool Database::isSaving()
     if (locked) {
         m_saveMutex.unlock();
     }
-    return !locked;
+    return !locked || m_backgroundSave;
 }
 
 /**
@@ -244,33 +264,13 @@ bool Database::save(SaveAction action, const QString& backupFilePath, QString* e
  */
 bool Database::saveAs(const QString& filePath, SaveAction action, const QString& backupFilePath, QString* error)
 {
-    // Disallow overlapping save operations
-    if (isSaving()) {
-        if (error) {
-            *error = tr("Database save is already in progress.");
-        }
-        return false;
-    }
+    // A running background save is superseded by this one
+    waitForBackgroundSave();
 
-    // Never save an uninitialized database
-    if (!isInitialized()) {
-        if (error) {
-            *error = tr("Could not save, database has not been initialized!");
-        }
+    if (!canSaveAs(filePath, error)) {
         return false;
     }
 
-    if (filePath == m_data.filePath) {
-        // Fail-safe check to make sure we don't overwrite underlying file changes
-        // that have not yet triggered a file reload/merge operation.
-        if (!m_fileWatcher->hasSameFileChecksum()) {
-            if (error) {
-                *error = tr("Database file has unmerged changes.");
-            }
-            return false;
-        }
-    }
-
     // Clear read-only flag
     m_fileWatcher->stop();
 
@@ -312,6 +312,216 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
     return ok;
 }
 
+/**
+ * Save the database to the current file path without blocking the caller.
+ *
+ * A snapshot of the database is serialized on a worker thread, so the database
+ * can be modified while the file is being written. Saves requested while a
+ * background save is running are coalesced into a single follow-up save of the
+ * latest state. backgroundSaveFinished() is emitted once the file was written.
+ *
+ * @param action Save action used to write the file
+ * @param backupFilePath Absolute path to the location where the backup should be stored. Passing an empty string
+ * disables backup.
+ * @param error error message in case the save could not be started
+ * @return true if the save was started or queued
+ */
+bool Database::saveInBackground(SaveAction action, const QString& backupFilePath, QString* error)
+{
+    if (m_data.filePath.isEmpty()) {
+        if (error) {
+            *error = tr("Could not save, database does not point to a valid file.");
+        }
+        return false;
+    }
+
+    if (m_backgroundSave) {
+        m_backgroundSaveQueued = true;
+        m_queuedSaveAction = action;
+        m_queuedBackupFilePath = backupFilePath;
+        return true;
+    }
+
+    if (!canSaveAs(m_data.filePath, error)) {
+        return false;
+    }
+
+    // Clear read-only flag
+    m_fileWatcher->stop();
+
+    QFileInfo fileInfo(m_data.filePath);
+    auto realFilePath = fileInfo.exists() ? fileInfo.canonicalFilePath() : fileInfo.absoluteFilePath();
+
+    m_backgroundSave.reset(new BackgroundSave());
+    m_backgroundSave->snapshot.reset(createSnapshot());
+    m_backgroundSave->kdf = m_data.kdf;
+    m_backgroundSave->formatVersion = m_data.formatVersion;
+    m_backgroundSave->modifiedGeneration = m_modifiedGeneration;
+    m_backgroundSave->filePath = m_data.filePath;
+    m_backgroundSave->realFilePath = realFilePath;
+    m_backgroundSave->isNewFile = !QFile::exists(realFilePath);
+#ifdef Q_OS_WIN
+    m_backgroundSave->isHidden = fileInfo.isHidden();
+#endif
+
+    auto snapshot = m_backgroundSave->snapshot.data();
+    auto saveError = &m_backgroundSave->error;
+
+    // Add random data to prevent side-channel data deduplication attacks
+    int length = Random::instance()->randomUIntRange(64, 512);
+    snapshot->metadata()->customData()->set(CustomData::RandomSlug, Random::instance()->randomArray(length).toHex());
+
+    m_backgroundSaveWatcher.setFuture(QtConcurrent::run(
+        [=] { return snapshot->performSave(realFilePath, action, backupFilePath, saveError); }));
+
+    return true;
+}
+
+void Database::finishBackgroundSave()
+{
+    if (!m_backgroundSave || !m_backgroundSaveWatcher.future().isFinished()) {
+        return;
+    }
+
+    QScopedPointer<BackgroundSave> backgroundSave(m_backgroundSave.take());
+    auto snapshot = backgroundSave->snapshot.data();
+    bool ok = m_backgroundSaveWatcher.result();
+    if (ok) {
+        // Adopt the key derivation state written to the file unless the key settings changed meanwhile
+        if (m_data.key == snapshot->m_data.key && m_data.kdf == backgroundSave->kdf
+            && m_data.formatVersion == backgroundSave->formatVersion) {
+            m_data.formatVersion = snapshot->m_data.formatVersion;
+            m_data.kdf = snapshot->m_data.kdf;
+            m_data.masterSeed->setRawKey(snapshot->m_data.masterSeed->rawKey());
+            m_data.transformedDatabaseKey->setRawKey(snapshot->m_data.transformedDatabaseKey->rawKey());
+            m_data.challengeResponseKey->setRawKey(snapshot->m_data.challengeResponseKey->rawKey());
+        }
+
+        setFilePath(backgroundSave->filePath);
+        // Changes made during the save are not part of the written file
+        if (m_modifiedGeneration == backgroundSave->modifiedGeneration) {
+            markAsClean();
+        }
+        if (backgroundSave->isNewFile) {
+            QFile::setPermissions(backgroundSave->realFilePath, QFile::ReadUser | QFile::WriteUser);
+        }
+
+#ifdef Q_OS_WIN
+        if (backgroundSave->isHidden) {
+            SetFileAttributes(backgroundSave->realFilePath.toStdString().c_str(), FILE_ATTRIBUTE_HIDDEN);
+        }
+#endif
+
+        m_fileWatcher->start(backgroundSave->realFilePath, 30, 1);
+    } else {
+        // Saving failed, don't rewatch file since it does not represent our database
+        markAsModified();
+    }
+
+    emit backgroundSaveFinished(ok, backgroundSave->error);
+
+    if (m_backgroundSaveQueued) {
+        m_backgroundSaveQueued = false;
+        QString error;
+        if (isModified() && !saveInBackground(m_queuedSaveAction, m_queuedBackupFilePath, &error)) {
+            emit backgroundSaveFinished(false, error);
+        }
+    }
+}
+
+/**
+ * Wait for a running background save to finish without blocking the event loop.
+ * Saves queued in the meantime are dropped.
+ */
+void Database::waitForBackgroundSave()
+{
+    while (m_backgroundSave) {
+        m_backgroundSaveQueued = false;
+        AsyncTask::waitForFuture(m_backgroundSaveWatcher.future());
+        finishBackgroundSave();
+    }
+}
+
+bool Database::canSaveAs(const QString& filePath, QString* error)
+{
+    // Disallow overlapping save operations
+    if (isSaving()) {
+        if (error) {
+            *error = tr("Database save is already in progress.");
+        }
+        return false;
+    }
+
+    // Never save an uninitialized database
+    if (!isInitialized()) {
+        if (error) {
+            *error = tr("Could not save, database has not been initialized!");
+        }
+        return false;
+    }
+
+    if (filePath == m_data.filePath) {
+        // Fail-safe check to make sure we don't overwrite underlying file changes
+        // that have not yet triggered a file reload/merge operation.
+        if (!m_fileWatcher->hasSameFileChecksum()) {
+            if (error) {
+                *error = tr("Database file has unmerged changes.");
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Create a detached copy of this database that serializes to the same file.
+ *
+ * Groups and entries are cloned with their uuids and timestamps, their string
+ * and binary data stays implicitly shared with this database until either
+ * side modifies it. The snapshot never emits modification signals.
+ *
+ * @return snapshot owned by the caller
+ */
+Database* Database::createSnapshot() const
+{
+    auto snapshot = cloneContents(true);
+    snapshot->m_deletedObjects = m_deletedObjects;
+
+    snapshot->m_data.formatVersion = m_data.formatVersion;
+    snapshot->m_data.filePath = m_data.filePath;
+    snapshot->m_data.cipher = m_data.cipher;
+    snapshot->m_data.compressionAlgorithm = m_data.compressionAlgorithm;
+    snapshot->m_data.masterSeed->setRawKey(m_data.masterSeed->rawKey());
+    snapshot->m_data.transformedDatabaseKey->setRawKey(m_data.transformedDatabaseKey->rawKey());
+    snapshot->m_data.challengeResponseKey->setRawKey(m_data.challengeResponseKey->rawKey());
+    snapshot->m_data.key = m_data.key;
+    snapshot->m_data.kdf = m_data.kdf->clone();
+    snapshot->m_data.publicCustomData = m_data.publicCustomData;
+
+    return snapshot;
+}
+
+/**
+ * @param includeHistory whether to clone the history of the entries
+ * @return copy of the groups, entries and metadata that never emits modification signals
+ */
+Database* Database::cloneContents(bool includeHistory) const
+{
+    auto snapshot = new Database();
+    snapshot->setEmitModified(false);
+
+    Entry::CloneFlags entryFlags = Entry::CloneExactCopy;
+    if (includeHistory) {
+        entryFlags |= Entry::CloneIncludeHistory;
+    }
+    auto rootGroup = m_rootGroup->clone(entryFlags, Group::CloneIncludeEntries | Group::CloneExactCopy);
+    delete snapshot->setRootGroup(rootGroup);
+
+    snapshot->m_metadata->copyFrom(m_metadata, rootGroup);
+    return snapshot;
+}
+
 bool Database::performSave(const QString& filePath, SaveAction action, const QString& backupFilePath, QString* error)
 {
     if (!backupFilePath.isNull()) {
@@ -482,6 +692,13 @@ bool Database::import(const QString& xmlExportPath, QString* error)
 
 void Database::releaseData()
 {
+    // The result of a running background save is of no interest anymore
+    m_backgroundSaveQueued = false;
+    if (m_backgroundSave) {
+        m_backgroundSaveWatcher.waitForFinished();
+        m_backgroundSave.reset();
+    }
+
     // Prevent data release while saving
     Q_ASSERT(!isSaving());
     QMutexLocker locker(&m_saveMutex);
@@ -508,6 +725,7 @@ void Database::releaseData()
     m_deletedObjects.clear();
     m_commonUsernames.clear();
     m_tagList.clear();
+    m_passwordHealthCache->clear();
 }
 
 /**
@@ -592,6 +810,11 @@ Group* Database::setRootGroup(Group* group)
     auto oldRoot = m_rootGroup;
     m_rootGroup = group;
     m_rootGroup->setParent(this);
+    m_searchIndex->invalidate();
+    m_groupSettingsCache->clear();
+    m_placeholderCache->clear();
+    m_uuidIndex->invalidate();
+    m_readSnapshot.reset();
 
     // Initialize the root group if not done already
     if (m_rootGroup->uuid().isNull()) {
@@ -728,13 +951,13 @@ void Database::updateTagList()
     // Search groups recursively looking for tags
     // Use a set to prevent adding duplicates
     QSet<QString> tagSet;
-    for (auto entry : m_rootGroup->entriesRecursive()) {
-        if (!entry->isRecycled()) {
-            for (auto tag : entry->tagList()) {
+    m_rootGroup->forEachEntry(
+        [&tagSet](const Entry* entry) {
+            for (const auto& tag : entry->tagList()) {
                 tagSet.insert(tag);
             }
-        }
-    }
+        },
+        Group::SkipRecycled);
 
     m_tagList = tagSet.values();
     m_tagList.sort();
@@ -752,6 +975,220 @@ void Database::removeTag(const QString& tag)
     }
 }
 
+/**
+ * Trigram index of the searchable entry fields, used by
+ * EntrySearcher to narrow down candidate entries.
+ */
+EntrySearchIndex* Database::searchIndex() const
+{
+    return m_searchIndex;
+}
+
+/**
+ * Memoized inherited group settings, see GroupSettingsCache.
+ */
+GroupSettingsCache* Database::groupSettingsCache() const
+{
+    return m_groupSettingsCache;
+}
+
+/**
+ * Memoized placeholder resolution of entry attributes,
+ * see Entry::resolvedAttribute().
+ */
+PlaceholderCache* Database::placeholderCache() const
+{
+    return m_placeholderCache;
+}
+
+/**
+ * Lookup of the groups and entries in this database by uuid,
+ * see Group::findEntryByUuid() and Group::findGroupByUuid().
+ */
+UuidIndex* Database::uuidIndex() const
+{
+    return m_uuidIndex;
+}
+
+/**
+ * Copy of the groups, entries and metadata that other threads can read while this
+ * database is being changed. Entry history is left out. The copy is kept until
+ * the next change, so repeated lookups share it. While nobody holds the snapshot,
+ * added, removed and changed entries, added, removed and moved groups and metadata
+ * changes are applied to it, other changes discard it.
+ *
+ * Must be called from the thread of this database, the snapshot must not be modified.
+ *
+ * @return read-only snapshot of this database
+ */
+QSharedPointer<Database> Database::readSnapshot()
+{
+    if (!m_readSnapshot) {
+        // The last reference may be dropped by another thread
+        m_readSnapshot = QSharedPointer<Database>(cloneContents(false), &QObject::deleteLater);
+        m_readSnapshotUsers = QSharedPointer<QAtomicInt>::create(0);
+    }
+
+    auto snapshot = m_readSnapshot;
+    auto users = m_readSnapshotUsers;
+    users->ref();
+    return QSharedPointer<Database>(snapshot.data(), [snapshot, users](Database*) mutable {
+        users->deref();
+        snapshot.reset();
+    });
+}
+
+void Database::discardReadSnapshot()
+{
+    m_readSnapshot.reset();
+}
+
+/**
+ * @return read snapshot if there is one that nobody holds, nullptr otherwise
+ */
+Database* Database::readSnapshotForUpdate()
+{
+    if (m_readSnapshot && m_readSnapshotUsers->loadAcquire() != 0) {
+        m_readSnapshot.reset();
+    }
+    return m_readSnapshot.data();
+}
+
+/**
+ * Keep the read snapshot on the next call of markAsModified(), which follows
+ * the change that was applied to it unless the modified signal of its source is disabled.
+ */
+void Database::markReadSnapshotUpdated(const ModifiableObject* source)
+{
+    m_readSnapshotUpdated = source->modifiedSignalEnabled();
+}
+
+/**
+ * Copy a changed entry into the read snapshot, so the next lookup does not have to
+ * clone the whole database. A snapshot that is still held by a reader is discarded instead.
+ */
+void Database::updateReadSnapshot(Entry* entry)
+{
+    auto snapshot = readSnapshotForUpdate();
+    if (!snapshot) {
+        return;
+    }
+
+    auto snapshotEntry = snapshot->rootGroup()->findEntryByUuid(entry->uuid());
+    if (!snapshotEntry) {
+        m_readSnapshot.reset();
+        return;
+    }
+
+    snapshotEntry->copyDataFrom(entry);
+    // copyDataFrom() assigns m_data without any signal and the modified signals of the
+    // snapshot are disabled, so its caches have to be told about the change explicitly
+    emit snapshot->entryModified(snapshotEntry);
+    markReadSnapshotUpdated(entry);
+}
+
+void Database::addEntryToReadSnapshot(Entry* entry)
+{
+    auto snapshot = readSnapshotForUpdate();
+    if (!snapshot) {
+        return;
+    }
+
+    // The entry already refers to the group it is about to be added to
+    auto snapshotGroup = snapshot->rootGroup()->findGroupByUuid(entry->group()->uuid());
+    if (!snapshotGroup || snapshot->rootGroup()->findEntryByUuid(entry->uuid())) {
+        m_readSnapshot.reset();
+        return;
+    }
+
+    entry->clone(Entry::CloneExactCopy)->setGroup(snapshotGroup);
+    markReadSnapshotUpdated(entry->group());
+}
+
+void Database::removeEntryFromReadSnapshot(Entry* entry)
+{
+    auto snapshot = readSnapshotForUpdate();
+    if (!snapshot) {
+        return;
+    }
+
+    delete snapshot->rootGroup()->findEntryByUuid(entry->uuid());
+    markReadSnapshotUpdated(entry->group());
+}
+
+void Database::addGroupToReadSnapshot(Group* group, int index)
+{
+    auto snapshot = readSnapshotForUpdate();
+    if (!snapshot) {
+        return;
+    }
+
+    // The group already refers to its new parent
+    auto snapshotParent = snapshot->rootGroup()->findGroupByUuid(group->parentGroup()->uuid());
+    if (!snapshotParent || snapshot->rootGroup()->findGroupByUuid(group->uuid())) {
+        m_readSnapshot.reset();
+        return;
+    }
+
+    auto snapshotGroup = group->clone(Entry::CloneExactCopy, Group::CloneIncludeEntries | Group::CloneExactCopy);
+    snapshotGroup->setParent(snapshotParent, index);
+    markReadSnapshotUpdated(group);
+}
+
+void Database::removeGroupFromReadSnapshot(Group* group)
+{
+    auto snapshot = readSnapshotForUpdate();
+    if (!snapshot) {
+        return;
+    }
+
+    delete snapshot->rootGroup()->findGroupByUuid(group->uuid());
+    markReadSnapshotUpdated(group);
+}
+
+void Database::moveGroupInReadSnapshot(Group* group, Group* toGroup, int index)
+{
+    auto snapshot = readSnapshotForUpdate();
+    if (!snapshot) {
+        return;
+    }
+
+    auto snapshotGroup = snapshot->rootGroup()->findGroupByUuid(group->uuid());
+    auto snapshotParent = snapshot->rootGroup()->findGroupByUuid(toGroup->uuid());
+    if (!snapshotGroup || !snapshotParent) {
+        m_readSnapshot.reset();
+        return;
+    }
+
+    // Both trees have the same order, so the index of the move applies to the snapshot as well
+    snapshotGroup->setParent(snapshotParent, index, false);
+    markReadSnapshotUpdated(group);
+}
+
+void Database::updateReadSnapshotMetadata()
+{
+    auto snapshot = readSnapshotForUpdate();
+    if (!snapshot) {
+        return;
+    }
+
+    snapshot->m_metadata->copyFrom(m_metadata, snapshot->rootGroup());
+    if (m_metadata->recycleBin() && !snapshot->m_metadata->recycleBin()) {
+        // The recycle bin is not part of the snapshot yet, lookups must not miss it
+        m_readSnapshot.reset();
+        return;
+    }
+    markReadSnapshotUpdated(m_metadata);
+}
+
+/**
+ * Entropy estimates of the passwords in this database, see HealthChecker.
+ */
+PasswordHealthCache* Database::passwordHealthCache() const
+{
+    return m_passwordHealthCache.data();
+}
+
 const QUuid& Database::cipher() const
 {
     return m_data.cipher;
@@ -771,6 +1208,14 @@ QByteArray Database::transformedDatabaseKey() const
     return m_data.transformedDatabaseKey->rawKey();
 }
 
+/**
+ * @return duration of the last key transformation in milliseconds, -1 if the key was not transformed
+ */
+qint64 Database::keyTransformTime() const
+{
+    return m_data.keyTransformTime;
+}
+
 QByteArray Database::challengeResponseKey() const
 {
     Q_ASSERT(m_data.challengeResponseKey);
@@ -850,8 +1295,12 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
 
     if (!transformKey) {
         transformedDatabaseKey = QByteArray(oldTransformedDatabaseKey.rawKey());
-    } else if (!key->transform(*m_data.kdf, transformedDatabaseKey, &m_keyError)) {
-        return false;
+    } else {
+        qint64 transformTime;
+        if (!key->transform(*m_data.kdf, transformedDatabaseKey, &m_keyError, &transformTime)) {
+            return false;
+        }
+        m_data.keyTransformTime = transformTime;
     }
 
     m_data.key = key;
@@ -955,6 +1404,12 @@ bool Database::hasNonDataChanges() const
 void Database::markAsModified()
 {
     m_modified = true;
+    ++m_modifiedGeneration;
+    // Changes that were applied to the snapshot keep it, see markReadSnapshotUpdated()
+    if (!m_readSnapshotUpdated) {
+        m_readSnapshot.reset();
+    }
+    m_readSnapshotUpdated = false;
     if (modifiedSignalEnabled() && !m_modifiedTimer.isActive()) {
         // Small time delay prevents numerous consecutive saves due to repeated signals
         startModifiedTimer();
@@ -1010,12 +1465,14 @@ bool Database::changeKdf(const QSharedPointer<Kdf>& kdf)
     if (!m_data.key) {
         m_data.key = QSharedPointer<CompositeKey>::create();
     }
-    if (!m_data.key->transform(*kdf, transformedDatabaseKey)) {
+    qint64 transformTime;
+    if (!m_data.key->transform(*kdf, transformedDatabaseKey, nullptr, &transformTime)) {
         return false;
     }
 
     setKdf(kdf);
     m_data.transformedDatabaseKey->setRawKey(transformedDatabaseKey);
+    m_data.keyTransformTime = transformTime;
     markAsModified();
 
     return true;
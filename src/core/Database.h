@@ -20,6 +20,7 @@
 #define KEEPASSX_DATABASE_H
 
 #include <QDateTime>
+#include <QFutureWatcher>
 #include <QHash>
 #include <QMutex>
 #include <QPointer>
@@ -34,10 +35,15 @@
 
 class Entry;
 enum class EntryReferenceType;
+class EntrySearchIndex;
 class FileWatcher;
 class Group;
+class GroupSettingsCache;
 class Metadata;
+class PasswordHealthCache;
+class PlaceholderCache;
 class QIODevice;
+class UuidIndex;
 
 struct DeletedObject
 {
@@ -79,6 +85,10 @@ private:
     bool backupDatabase(const QString& filePath, const QString& destinationFilePath);
     bool restoreDatabase(const QString& filePath, const QString& fromBackupFilePath);
     bool performSave(const QString& filePath, SaveAction flags, const QString& backupFilePath, QString* error);
+    bool canSaveAs(const QString& filePath, QString* error);
+    Database* createSnapshot() const;
+    Database* cloneContents(bool includeHistory) const;
+    void waitForBackgroundSave();
 
 public:
     bool open(QSharedPointer<const CompositeKey> key, QString* error = nullptr);
@@ -88,6 +98,9 @@ public:
                 SaveAction action = Atomic,
                 const QString& backupFilePath = QString(),
                 QString* error = nullptr);
+    bool saveInBackground(SaveAction action = Atomic,
+                          const QString& backupFilePath = QString(),
+                          QString* error = nullptr);
     bool extract(QByteArray&, QString* error = nullptr);
     bool import(const QString& xmlExportPath, QString* error = nullptr);
 
@@ -132,6 +145,13 @@ public:
     const QStringList& tagList() const;
     void removeTag(const QString& tag);
 
+    EntrySearchIndex* searchIndex() const;
+    GroupSettingsCache* groupSettingsCache() const;
+    PlaceholderCache* placeholderCache() const;
+    PasswordHealthCache* passwordHealthCache() const;
+    UuidIndex* uuidIndex() const;
+    QSharedPointer<Database> readSnapshot();
+
     QSharedPointer<const CompositeKey> key() const;
     bool setKey(const QSharedPointer<const CompositeKey>& key,
                 bool updateChangedTime = true,
@@ -149,6 +169,7 @@ public:
     void setKdf(QSharedPointer<Kdf> kdf);
     bool changeKdf(const QSharedPointer<Kdf>& kdf);
     QByteArray transformedDatabaseKey() const;
+    qint64 keyTransformTime() const;
 
     void markAsTemporaryDatabase();
     bool isTemporaryDatabase();
@@ -171,13 +192,30 @@ signals:
     void groupRemoved();
     void groupAboutToMove(Group* group, Group* toGroup, int index);
     void groupMoved();
+    void entryAboutToAdd(Entry* entry);
+    void entryAdded(Entry* entry);
+    void entryAboutToRemove(Entry* entry);
+    void entryRemoved(Entry* entry);
+    void entryModified(Entry* entry);
     void databaseOpened();
     void databaseSaved();
+    void backgroundSaveFinished(bool ok, const QString& error);
     void databaseDiscarded();
     void databaseFileChanged();
     void databaseNonDataChanged();
     void tagListUpdated();
 
+private slots:
+    void finishBackgroundSave();
+    void discardReadSnapshot();
+    void updateReadSnapshot(Entry* entry);
+    void addEntryToReadSnapshot(Entry* entry);
+    void removeEntryFromReadSnapshot(Entry* entry);
+    void addGroupToReadSnapshot(Group* group, int index);
+    void removeGroupFromReadSnapshot(Group* group);
+    void moveGroupInReadSnapshot(Group* group, Group* toGroup, int index);
+    void updateReadSnapshotMetadata();
+
 private:
     struct DatabaseData
     {
@@ -192,6 +230,7 @@ private:
 
         QSharedPointer<const CompositeKey> key;
         QSharedPointer<Kdf> kdf;
+        qint64 keyTransformTime = -1;
 
         QVariantMap publicCustomData;
 
@@ -214,6 +253,7 @@ private:
             challengeResponseKey.reset(new PasswordKey());
 
             key.reset();
+            keyTransformTime = -1;
 
             // Default to AES KDF, KDBX4 databases overwrite this
             kdf.reset(new AesKdf(true));
@@ -221,7 +261,22 @@ private:
         }
     };
 
+    struct BackgroundSave
+    {
+        QScopedPointer<Database> snapshot;
+        QSharedPointer<Kdf> kdf;
+        quint32 formatVersion = 0;
+        quint64 modifiedGeneration = 0;
+        QString filePath;
+        QString realFilePath;
+        bool isNewFile = false;
+        bool isHidden = false;
+        QString error;
+    };
+
     void createRecycleBin();
+    Database* readSnapshotForUpdate();
+    void markReadSnapshotUpdated(const ModifiableObject* source);
 
     void startModifiedTimer();
     void stopModifiedTimer();
@@ -232,8 +287,23 @@ private:
     QList<DeletedObject> m_deletedObjects;
     QTimer m_modifiedTimer;
     QMutex m_saveMutex;
+    QFutureWatcher<bool> m_backgroundSaveWatcher;
+    QScopedPointer<BackgroundSave> m_backgroundSave;
+    bool m_backgroundSaveQueued = false;
+    SaveAction m_queuedSaveAction = Atomic;
+    QString m_queuedBackupFilePath;
     QPointer<FileWatcher> m_fileWatcher;
+    QPointer<EntrySearchIndex> m_searchIndex;
+    QPointer<GroupSettingsCache> m_groupSettingsCache;
+    QPointer<PlaceholderCache> m_placeholderCache;
+    QPointer<UuidIndex> m_uuidIndex;
+    QScopedPointer<PasswordHealthCache> m_passwordHealthCache;
+    QSharedPointer<Database> m_readSnapshot;
+    // Number of references to the read snapshot handed out that are still held
+    QSharedPointer<QAtomicInt> m_readSnapshotUsers;
+    bool m_readSnapshotUpdated = false;
     bool m_modified = false;
+    quint64 m_modifiedGeneration = 0;
     bool m_hasNonDataChange = false;
     QString m_keyError;
     bool m_isTemporaryDatabase = false;
@@ -21,7 +21,7 @@ DatabaseStats::DatabaseStats(QSharedPointer<Database> db)
     : modified(QFileInfo(db->filePath()).lastModified())
     , m_db(db)
 {
-    gatherStats(db->rootGroup()->groupsRecursive(true));
+    gatherStats(db->rootGroup());
 }
 
 // Get average password length
@@ -64,56 +64,49 @@ bool DatabaseStats::isAvgPwdTooShort() const
     return averagePwdLength() < 10;
 }
 
-void DatabaseStats::gatherStats(const QList<Group*>& groups)
+void DatabaseStats::gatherStats(const Group* rootGroup)
 {
     auto checker = HealthChecker(m_db);
 
-    for (const auto* group : groups) {
-        // Don't count anything in the recycle bin
-        if (group->isRecycled()) {
-            continue;
-        }
+    // Don't count anything in the recycle bin
+    rootGroup->forEachGroup(
+        [&](const Group* group) {
+            ++groupCount;
 
-        ++groupCount;
+            for (const auto* entry : group->entries()) {
+                ++entryCount;
 
-        for (const auto* entry : group->entries()) {
-            // Don't count anything in the recycle bin
-            if (entry->isRecycled()) {
-                continue;
-            }
-
-            ++entryCount;
-
-            if (entry->isExpired()) {
-                ++expiredEntries;
-            }
-
-            // Get password statistics
-            const auto pwd = entry->password();
-            if (!pwd.isEmpty()) {
-                if (!m_passwords.contains(pwd)) {
-                    ++uniquePasswords;
-                } else {
-                    ++reusedPasswords;
+                if (entry->isExpired()) {
+                    ++expiredEntries;
                 }
 
-                if (pwd.size() < PasswordHealth::Length::Short) {
-                    ++shortPasswords;
+                // Get password statistics
+                const auto pwd = entry->password();
+                if (!pwd.isEmpty()) {
+                    if (!m_passwords.contains(pwd)) {
+                        ++uniquePasswords;
+                    } else {
+                        ++reusedPasswords;
+                    }
+
+                    if (pwd.size() < PasswordHealth::Length::Short) {
+                        ++shortPasswords;
+                    }
+
+                    // Speed up Zxcvbn process by excluding very long passwords and most passphrases
+                    if (pwd.size() < PasswordHealth::Length::Long
+                        && checker.evaluate(entry)->quality() <= PasswordHealth::Quality::Weak) {
+                        ++weakPasswords;
+                    }
+
+                    if (entry->excludeFromReports()) {
+                        ++excludedEntries;
+                    }
+
+                    totalPasswordLength += pwd.size();
+                    m_passwords[pwd]++;
                 }
-
-                // Speed up Zxcvbn process by excluding very long passwords and most passphrases
-                if (pwd.size() < PasswordHealth::Length::Long
-                    && checker.evaluate(entry)->quality() <= PasswordHealth::Quality::Weak) {
-                    ++weakPasswords;
-                }
-
-                if (entry->excludeFromReports()) {
-                    ++excludedEntries;
-                }
-
-                totalPasswordLength += pwd.size();
-                m_passwords[pwd]++;
             }
-        }
-    }
+        },
+        Group::SkipRecycled);
 }
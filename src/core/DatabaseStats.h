@@ -54,6 +54,6 @@ private:
     QSharedPointer<Database> m_db;
     QHash<QString, int> m_passwords;
 
-    void gatherStats(const QList<Group*>& groups);
+    void gatherStats(const Group* rootGroup);
 };
 #endif // KEEPASSXC_DATABASESTATS_H
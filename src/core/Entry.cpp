@@ -22,8 +22,10 @@
 #include "core/Database.h"
 #include "core/Global.h"
 #include "core/Group.h"
+#include "core/GroupSettingsCache.h"
 #include "core/Metadata.h"
 #include "core/PasswordHealth.h"
+#include "core/PlaceholderCache.h"
 #include "core/Tools.h"
 #include "core/Totp.h"
 
@@ -42,6 +44,49 @@ namespace
     const QRegularExpression TagDelimiterRegex(R"([,;\t])");
 } // namespace
 
+/**
+ * Fields of an entry that history revisions store relative to the next newer revision.
+ */
+struct Entry::HistoryState
+{
+    QMap<QString, QString> attributes;
+    QSet<QString> protectedAttributes;
+    QMap<QString, QSharedPointer<const AttachmentBlob>> attachments;
+    QList<AutoTypeAssociations::Association> associations;
+    QSharedPointer<const CustomData> customData;
+};
+
+/**
+ * History item stored as the difference to the next newer revision, or to the
+ * entry itself for the newest item. Only attribute values that changed are
+ * stored, all other fields share the storage of the next revision if they are
+ * equal. Revisions are immutable, so clones of an entry share them.
+ */
+struct Entry::HistoryRevision
+{
+    EntryData data;
+    QMap<QString, QString> changedAttributes;
+    QStringList removedAttributes;
+    QSet<QString> protectedAttributes;
+    QMap<QString, QSharedPointer<const AttachmentBlob>> attachments;
+    QList<AutoTypeAssociations::Association> associations;
+    QSharedPointer<const CustomData> customData;
+    // Entry::size() without the attachment data
+    int fixedSize = 0;
+
+    int size(QSet<const AttachmentBlob*>* countedAttachments) const
+    {
+        int size = fixedSize;
+        for (const auto& blob : attachments) {
+            if (!countedAttachments->contains(blob.data())) {
+                countedAttachments->insert(blob.data());
+                size += blob->size();
+            }
+        }
+        return size;
+    }
+};
+
 Entry::Entry()
     : m_attributes(new EntryAttributes(this))
     , m_attachments(new EntryAttachments(this))
@@ -214,7 +259,12 @@ bool Entry::autoTypeEnabled() const
 
 bool Entry::groupAutoTypeEnabled() const
 {
-    return group() && group()->resolveAutoTypeEnabled();
+    const auto* group = this->group();
+    if (!group) {
+        return false;
+    }
+    const auto* db = group->database();
+    return db ? db->groupSettingsCache()->settings(group).autoTypeEnabled : group->resolveAutoTypeEnabled();
 }
 
 int Entry::autoTypeObfuscation() const
@@ -230,7 +280,7 @@ QString Entry::defaultAutoTypeSequence() const
 const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 {
     if (!m_data.passwordHealth) {
-        m_data.passwordHealth.reset(new PasswordHealth(resolvePlaceholder(password())));
+        m_data.passwordHealth.reset(new PasswordHealth(passwordEntropy()));
     }
     return m_data.passwordHealth;
 }
@@ -238,11 +288,20 @@ const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 const QSharedPointer<PasswordHealth> Entry::passwordHealth() const
 {
     if (!m_data.passwordHealth) {
-        return QSharedPointer<PasswordHealth>::create(resolvePlaceholder(password()));
+        return QSharedPointer<PasswordHealth>::create(passwordEntropy());
     }
     return m_data.passwordHealth;
 }
 
+double Entry::passwordEntropy() const
+{
+    const auto pwd = resolvePlaceholder(password());
+    if (auto db = database()) {
+        return db->passwordHealthCache()->entropy(pwd);
+    }
+    return PasswordHealth::estimateEntropy(pwd);
+}
+
 bool Entry::excludeFromReports() const
 {
     return m_data.excludeFromReports
@@ -381,14 +440,19 @@ QString Entry::url() const
     return m_attributes->value(EntryAttributes::URLKey);
 }
 
-QStringList Entry::getAllUrls() const
+/**
+ * @param resolvePlaceholders if false, return the URLs as stored
+ * @return URL and additional URLs of this entry
+ */
+QStringList Entry::getAllUrls(bool resolvePlaceholders) const
 {
     QStringList urlList;
     auto entryUrl = url();
 
     if (!entryUrl.isEmpty()) {
-        urlList << (EntryAttributes::matchReference(entryUrl).hasMatch() ? resolveMultiplePlaceholders(entryUrl)
-                                                                         : entryUrl);
+        urlList << (resolvePlaceholders && EntryAttributes::matchReference(entryUrl).hasMatch()
+                        ? resolveMultiplePlaceholders(entryUrl)
+                        : entryUrl);
     }
 
     for (const auto& key : m_attributes->keys()) {
@@ -396,7 +460,7 @@ QStringList Entry::getAllUrls() const
             || key == QString("%1_RELYING_PARTY").arg(EntryAttributes::PasskeyAttribute)) {
             auto additionalUrl = m_attributes->value(key);
             if (!additionalUrl.isEmpty()) {
-                urlList << resolveMultiplePlaceholders(additionalUrl);
+                urlList << (resolvePlaceholders ? resolveMultiplePlaceholders(additionalUrl) : additionalUrl);
             }
         }
     }
@@ -436,12 +500,19 @@ QString Entry::attribute(const QString& key) const
     return m_attributes->value(key);
 }
 
-int Entry::size() const
+/**
+ * Estimated size of the entry data.
+ *
+ * @param countedAttachments if set, attachment data already accounted for elsewhere
+ *                           (e.g. shared with other history items) is not counted again
+ * @return size in bytes
+ */
+int Entry::size(QSet<const AttachmentBlob*>* countedAttachments) const
 {
     int size = 0;
     size += attributes()->attributesSize();
     size += autoTypeAssociations()->associationsSize();
-    size += attachments()->attachmentsSize();
+    size += attachments()->attachmentsSize(countedAttachments);
     size += customData()->dataSize();
     for (const QString& tag : tags().split(TagDelimiterRegex, Qt::SkipEmptyParts)) {
         size += tag.toUtf8().size();
@@ -631,7 +702,13 @@ QString Entry::path() const
 void Entry::setUuid(const QUuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
-    set(m_uuid, uuid);
+    if (set(m_uuid, uuid)) {
+        // Resolved values are cached by uuid, including those that referenced the old one
+        const auto db = database();
+        if (db && db->placeholderCache()) {
+            db->placeholderCache()->clear();
+        }
+    }
 }
 
 void Entry::setIcon(int iconNumber)
@@ -795,18 +872,58 @@ void Entry::setExpiryTime(const QDateTime& dateTime)
 
 QList<Entry*> Entry::historyItems()
 {
+    materializeHistory();
     return m_history;
 }
 
-const QList<Entry*>& Entry::historyItems() const
+int Entry::historyCount() const
 {
-    return m_history;
+    return m_history.size() + m_compactHistory.size();
+}
+
+/**
+ * @return custom icons of the history items, compact revisions are read without decoding them
+ */
+QSet<QUuid> Entry::historyIconUuids() const
+{
+    QSet<QUuid> icons;
+    for (const Entry* item : m_history) {
+        if (!item->iconUuid().isNull()) {
+            icons.insert(item->iconUuid());
+        }
+    }
+    for (const auto& revision : m_compactHistory) {
+        if (!revision->data.customIcon.isNull()) {
+            icons.insert(revision->data.customIcon);
+        }
+    }
+    return icons;
+}
+
+/**
+ * Visit the history items from oldest to newest without materializing compact history.
+ * Compact revisions are decoded into temporary items that only live during the visit,
+ * so the visitor must not keep pointers to them.
+ *
+ * @param visitor callable taking a history item, it may return false to stop the iteration
+ * @return false if the visitor stopped the iteration
+ */
+bool Entry::forEachHistoryItem(const std::function<bool(const Entry*)>& visitor) const
+{
+    const auto items = temporaryHistoryItems();
+    for (const auto& item : items) {
+        if (!visitor(item.data())) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void Entry::addHistoryItem(Entry* entry)
 {
     Q_ASSERT(!entry->parent());
 
+    materializeHistory();
     entry->setHistoryOwner(this);
     m_history.append(entry);
     emitModified();
@@ -828,6 +945,7 @@ void Entry::removeHistoryItems(const QList<Entry*>& historyEntries)
         return;
     }
 
+    materializeHistory();
     for (Entry* entry : historyEntries) {
         Q_ASSERT(!entry->parent());
         Q_ASSERT(entry->uuid().isNull() || entry->uuid() == uuid());
@@ -863,11 +981,21 @@ void Entry::truncateHistory()
                 changed = true;
             }
         }
+
+        // Older revisions are never the base of newer ones, so they can simply be dropped
+        while (m_compactHistory.size() > histMaxItems) {
+            m_compactHistory.removeFirst();
+            changed = true;
+        }
     }
 
     int histMaxSize = db->metadata()->historyMaxSize();
     if (histMaxSize > -1) {
         int size = 0;
+        // Attachments are shared between the entry and its history items and stored once per
+        // database, so only charge the history for the attachment data deleting it would free
+        QSet<const AttachmentBlob*> countedAttachments;
+        attachments()->attachmentsSize(&countedAttachments);
 
         QMutableListIterator<Entry*> i(m_history);
         i.toBack();
@@ -876,7 +1004,7 @@ void Entry::truncateHistory()
 
             // don't calculate size if it's already above the maximum
             if (size <= histMaxSize) {
-                size += historyItem->size();
+                size += historyItem->size(&countedAttachments);
             }
 
             if (size > histMaxSize) {
@@ -885,6 +1013,15 @@ void Entry::truncateHistory()
                 changed = true;
             }
         }
+
+        for (int index = m_compactHistory.size() - 1; index >= 0; --index) {
+            size += m_compactHistory.at(index)->size(&countedAttachments);
+            if (size > histMaxSize) {
+                m_compactHistory.erase(m_compactHistory.begin(), m_compactHistory.begin() + index + 1);
+                changed = true;
+                break;
+            }
+        }
     }
 
     if (changed) {
@@ -892,6 +1029,205 @@ void Entry::truncateHistory()
     }
 }
 
+/**
+ * Replace the history items by a compact representation that only stores the
+ * differences between revisions. The newest revision is stored in full, so the
+ * history does not depend on the current fields of the entry. The items are
+ * materialized again when they are requested through historyItems().
+ *
+ * Pointers to history items become invalid, so this must only be called while
+ * nobody holds them, e.g. right after reading a database.
+ */
+void Entry::compactHistory()
+{
+    if (m_history.isEmpty()) {
+        return;
+    }
+    Q_ASSERT(m_compactHistory.isEmpty());
+
+    HistoryState state;
+    QList<QSharedPointer<const HistoryRevision>> revisions;
+    for (int i = m_history.size() - 1; i >= 0; --i) {
+        revisions.prepend(encodeHistoryItem(m_history.at(i), state));
+    }
+
+    qDeleteAll(m_history);
+    m_history.clear();
+    m_compactHistory = revisions;
+}
+
+/**
+ * Append a history item to the compact history. The previous newest revision is
+ * encoded again relative to the item, which becomes the new full revision.
+ *
+ * @param item history item to append
+ */
+void Entry::appendCompactHistoryItem(const Entry* item)
+{
+    HistoryState state;
+    auto revision = encodeHistoryItem(item, state);
+
+    if (!m_compactHistory.isEmpty()) {
+        HistoryState previousState;
+        QScopedPointer<Entry> previous(decodeHistoryItem(*m_compactHistory.last(), previousState));
+        m_compactHistory.last() = encodeHistoryItem(previous.data(), state);
+    }
+    m_compactHistory.append(revision);
+}
+
+Entry::HistoryState Entry::historyState(const Entry* entry)
+{
+    HistoryState state;
+    for (const auto& key : entry->m_attributes->keys()) {
+        state.attributes.insert(key, entry->m_attributes->value(key));
+        if (entry->m_attributes->isProtected(key)) {
+            state.protectedAttributes.insert(key);
+        }
+    }
+    for (const auto& key : entry->m_attachments->keys()) {
+        state.attachments.insert(key, entry->m_attachments->blob(key));
+    }
+    state.associations = entry->m_autoTypeAssociations->getAll();
+    if (!entry->m_customData->isEmpty()) {
+        auto customData = QSharedPointer<CustomData>::create();
+        customData->copyDataFrom(entry->m_customData, true);
+        state.customData = customData;
+    }
+    return state;
+}
+
+/**
+ * Encode a history item relative to the state of the next newer revision.
+ *
+ * @param item history item to encode
+ * @param state state of the next newer revision, replaced by the state of the item
+ * @return compact revision
+ */
+QSharedPointer<const Entry::HistoryRevision> Entry::encodeHistoryItem(const Entry* item, HistoryState& state)
+{
+    auto itemState = historyState(item);
+    auto revision = QSharedPointer<HistoryRevision>::create();
+    revision->data = item->m_data;
+
+    for (auto it = itemState.attributes.constBegin(); it != itemState.attributes.constEnd(); ++it) {
+        const auto baseIt = state.attributes.constFind(it.key());
+        if (baseIt == state.attributes.constEnd() || baseIt.value() != it.value()) {
+            revision->changedAttributes.insert(it.key(), it.value());
+        }
+    }
+    for (auto it = state.attributes.constBegin(); it != state.attributes.constEnd(); ++it) {
+        if (!itemState.attributes.contains(it.key())) {
+            revision->removedAttributes.append(it.key());
+        }
+    }
+
+    // Share the storage of unchanged fields with the next revision
+    if (itemState.protectedAttributes == state.protectedAttributes) {
+        itemState.protectedAttributes = state.protectedAttributes;
+    }
+    if (itemState.attachments == state.attachments) {
+        itemState.attachments = state.attachments;
+    }
+    if (itemState.associations == state.associations) {
+        itemState.associations = state.associations;
+    }
+    if (itemState.customData && state.customData && *itemState.customData == *state.customData) {
+        itemState.customData = state.customData;
+    }
+    revision->protectedAttributes = itemState.protectedAttributes;
+    revision->attachments = itemState.attachments;
+    revision->associations = itemState.associations;
+    revision->customData = itemState.customData;
+
+    QSet<const AttachmentBlob*> attachmentBlobs;
+    for (const auto& blob : asConst(itemState.attachments)) {
+        attachmentBlobs.insert(blob.data());
+    }
+    revision->fixedSize = item->size(&attachmentBlobs);
+
+    state = itemState;
+    return revision;
+}
+
+/**
+ * Create the history item of a revision.
+ *
+ * @param revision compact revision
+ * @param state state of the next newer revision, replaced by the state of the revision
+ * @return new history item owned by this entry
+ */
+Entry* Entry::decodeHistoryItem(const HistoryRevision& revision, HistoryState& state) const
+{
+    for (const auto& key : revision.removedAttributes) {
+        state.attributes.remove(key);
+    }
+    for (auto it = revision.changedAttributes.constBegin(); it != revision.changedAttributes.constEnd(); ++it) {
+        state.attributes.insert(it.key(), it.value());
+    }
+    state.protectedAttributes = revision.protectedAttributes;
+    state.attachments = revision.attachments;
+    state.associations = revision.associations;
+    state.customData = revision.customData;
+
+    auto item = new Entry();
+    item->setUpdateTimeinfo(false);
+    item->m_uuid = m_uuid;
+    for (auto it = state.attributes.constBegin(); it != state.attributes.constEnd(); ++it) {
+        item->m_attributes->set(it.key(), it.value(), state.protectedAttributes.contains(it.key()));
+    }
+    for (auto it = state.attachments.constBegin(); it != state.attachments.constEnd(); ++it) {
+        item->m_attachments->set(it.key(), it.value());
+    }
+    for (const auto& association : asConst(state.associations)) {
+        item->m_autoTypeAssociations->add(association);
+    }
+    if (state.customData) {
+        item->m_customData->copyDataFrom(state.customData.data(), true);
+    }
+    item->m_data = revision.data;
+    item->setUpdateTimeinfo(true);
+    item->setHistoryOwner(const_cast<Entry*>(this));
+    return item;
+}
+
+void Entry::materializeHistory()
+{
+    if (m_compactHistory.isEmpty()) {
+        return;
+    }
+    Q_ASSERT(m_history.isEmpty());
+
+    HistoryState state;
+    QList<Entry*> items;
+    for (int i = m_compactHistory.size() - 1; i >= 0; --i) {
+        items.prepend(decodeHistoryItem(*m_compactHistory.at(i), state));
+    }
+
+    m_history = items;
+    m_compactHistory.clear();
+}
+
+/**
+ * History items from oldest to newest that can be read without materializing compact
+ * history. Compact revisions are decoded into items owned by the returned list,
+ * materialized items are returned without taking ownership.
+ *
+ * @return history items
+ */
+QList<QSharedPointer<const Entry>> Entry::temporaryHistoryItems() const
+{
+    QList<QSharedPointer<const Entry>> items;
+    for (const Entry* item : m_history) {
+        items.append(QSharedPointer<const Entry>(item, [](const Entry*) {}));
+    }
+
+    HistoryState state;
+    for (int i = m_compactHistory.size() - 1; i >= 0; --i) {
+        items.prepend(QSharedPointer<const Entry>(decodeHistoryItem(*m_compactHistory.at(i), state)));
+    }
+    return items;
+}
+
 bool Entry::equals(const Entry* other, CompareItemOptions options) const
 {
     if (!other) {
@@ -916,11 +1252,13 @@ bool Entry::equals(const Entry* other, CompareItemOptions options) const
         return false;
     }
     if (!options.testFlag(CompareItemIgnoreHistory)) {
-        if (m_history.count() != other->m_history.count()) {
+        if (historyCount() != other->historyCount()) {
             return false;
         }
-        for (int i = 0; i < m_history.count(); ++i) {
-            if (!m_history[i]->equals(other->m_history[i], options)) {
+        const auto history = temporaryHistoryItems();
+        const auto otherHistory = other->temporaryHistoryItems();
+        for (int i = 0; i < history.count(); ++i) {
+            if (!history[i]->equals(otherHistory[i], options)) {
                 return false;
             }
         }
@@ -938,7 +1276,7 @@ Entry* Entry::clone(CloneFlags flags) const
         entry->m_uuid = m_uuid;
     }
     entry->m_data = m_data;
-    entry->m_customData->copyDataFrom(m_customData);
+    entry->m_customData->copyDataFrom(m_customData, flags & CloneExactCopy);
     entry->m_attributes->copyDataFrom(m_attributes);
     entry->m_attachments->copyDataFrom(m_attachments);
 
@@ -956,13 +1294,19 @@ Entry* Entry::clone(CloneFlags flags) const
 
     entry->m_autoTypeAssociations->copyDataFrom(m_autoTypeAssociations);
     if (flags & CloneIncludeHistory) {
-        for (Entry* historyItem : m_history) {
-            Entry* historyItemClone =
-                historyItem->clone(flags & ~CloneIncludeHistory & ~CloneNewUuid & ~CloneResetTimeInfo);
-            historyItemClone->setUpdateTimeinfo(false);
-            historyItemClone->setUuid(entry->uuid());
-            historyItemClone->setUpdateTimeinfo(true);
-            entry->addHistoryItem(historyItemClone);
+        const auto historyFlags = flags & ~CloneIncludeHistory & ~CloneNewUuid & ~CloneResetTimeInfo;
+        // Compact revisions are shared as they are, unless the flags change the history items
+        const auto itemChangingFlags = CloneRenameTitle | CloneUserAsRef | ClonePassAsRef;
+        if (!m_compactHistory.isEmpty() && !(historyFlags & itemChangingFlags)) {
+            entry->m_compactHistory = m_compactHistory;
+        } else {
+            for (const auto& historyItem : temporaryHistoryItems()) {
+                Entry* historyItemClone = historyItem->clone(historyFlags);
+                historyItemClone->setUpdateTimeinfo(false);
+                historyItemClone->setUuid(entry->uuid());
+                historyItemClone->setUpdateTimeinfo(true);
+                entry->addHistoryItem(historyItemClone);
+            }
         }
     }
 
@@ -1014,7 +1358,13 @@ bool Entry::endUpdate()
     Q_ASSERT(!m_tmpHistoryItem.isNull());
     if (m_modifiedSinceBegin) {
         m_tmpHistoryItem->setUpdateTimeinfo(true);
-        addHistoryItem(m_tmpHistoryItem.take());
+        if (m_history.isEmpty()) {
+            // Nobody can hold pointers to history items, so keep the history compact
+            appendCompactHistoryItem(m_tmpHistoryItem.data());
+            emitModified();
+        } else {
+            addHistoryItem(m_tmpHistoryItem.take());
+        }
         truncateHistory();
     }
 
@@ -1330,6 +1680,29 @@ QString Entry::resolvePlaceholder(const QString& placeholder) const
     return resolvePlaceholderRecursive(placeholder, ResolveMaximumDepth);
 }
 
+/**
+ * Value of the given attribute with all placeholders resolved.
+ * Entries that are part of a database share a resolution cache
+ * that is invalidated when this entry or a referenced entry changes.
+ *
+ * @param key attribute key
+ * @return resolved attribute value
+ */
+QString Entry::resolvedAttribute(const QString& key) const
+{
+    const auto value = m_attributes->value(key);
+    if (!value.contains(QLatin1Char('{'))) {
+        return value;
+    }
+
+    const auto db = database();
+    if (!db || !db->placeholderCache()) {
+        return resolveMultiplePlaceholders(value);
+    }
+
+    return db->placeholderCache()->resolve(this, key);
+}
+
 QString Entry::resolveUrlPlaceholder(const QString& str, Entry::PlaceholderType placeholderType) const
 {
     if (str.isEmpty()) {
@@ -23,6 +23,8 @@
 #include <QPointer>
 #include <QUuid>
 
+#include <functional>
+
 #include "core/AutoTypeAssociations.h"
 #include "core/CustomData.h"
 #include "core/EntryAttachments.h"
@@ -100,7 +102,7 @@ public:
     const AutoTypeAssociations* autoTypeAssociations() const;
     QString title() const;
     QString url() const;
-    QStringList getAllUrls() const;
+    QStringList getAllUrls(bool resolvePlaceholders = true) const;
     QString webUrl() const;
     QString displayUrl() const;
     QString username() const;
@@ -113,7 +115,7 @@ public:
     Group* previousParentGroup();
     const Group* previousParentGroup() const;
     QUuid previousParentGroupUuid() const;
-    int size() const;
+    int size(QSet<const AttachmentBlob*>* countedAttachments = nullptr) const;
     QString path() const;
     const QSharedPointer<PasswordHealth> passwordHealth();
     const QSharedPointer<PasswordHealth> passwordHealth() const;
@@ -166,12 +168,15 @@ public:
     void removeTag(const QString& tag);
 
     QList<Entry*> historyItems();
-    const QList<Entry*>& historyItems() const;
+    int historyCount() const;
+    QSet<QUuid> historyIconUuids() const;
+    bool forEachHistoryItem(const std::function<bool(const Entry*)>& visitor) const;
     void addHistoryItem(Entry* entry);
     void setHistoryOwner(Entry* entry);
     Entry* historyOwner() const;
     void removeHistoryItems(const QList<Entry*>& historyEntries);
     void truncateHistory();
+    void compactHistory();
 
     bool equals(const Entry* other, CompareItemOptions options = CompareItemDefault) const;
 
@@ -186,6 +191,7 @@ public:
         CloneRenameTitle = 8, // add "-Clone" after the original title
         CloneUserAsRef = 16, // Add the user as a reference to the original entry
         ClonePassAsRef = 32, // Add the password as a reference to the original entry
+        CloneExactCopy = 64, // keep all timestamps of the original, used for database snapshots
     };
     Q_DECLARE_FLAGS(CloneFlags, CloneFlag)
 
@@ -242,6 +248,7 @@ public:
     Entry* resolveReference(const QString& str) const;
     QString resolveMultiplePlaceholders(const QString& str) const;
     QString resolvePlaceholder(const QString& str) const;
+    QString resolvedAttribute(const QString& key) const;
     QString resolveUrlPlaceholder(const QString& str, PlaceholderType placeholderType) const;
     QString resolveDateTimePlaceholder(PlaceholderType placeholderType) const;
     PlaceholderType placeholderType(const QString& placeholder) const;
@@ -283,12 +290,22 @@ private:
     QString resolvePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString resolveReferencePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString referenceFieldValue(EntryReferenceType referenceType) const;
+    double passwordEntropy() const;
 
     static QString buildReference(const QUuid& uuid, const QString& field);
     static EntryReferenceType referenceType(const QString& referenceStr);
 
     template <class T> bool set(T& property, const T& value);
 
+    struct HistoryState;
+    struct HistoryRevision;
+    static HistoryState historyState(const Entry* entry);
+    static QSharedPointer<const HistoryRevision> encodeHistoryItem(const Entry* item, HistoryState& state);
+    Entry* decodeHistoryItem(const HistoryRevision& revision, HistoryState& state) const;
+    void appendCompactHistoryItem(const Entry* item);
+    void materializeHistory();
+    QList<QSharedPointer<const Entry>> temporaryHistoryItems() const;
+
     QUuid m_uuid;
     EntryData m_data;
     QPointer<EntryAttributes> m_attributes;
@@ -296,6 +313,8 @@ private:
     QPointer<AutoTypeAssociations> m_autoTypeAssociations;
     QPointer<CustomData> m_customData;
     QList<Entry*> m_history; // Items sorted from oldest to newest
+    // Compact history that is used instead of m_history until the items are requested
+    QList<QSharedPointer<const HistoryRevision>> m_compactHistory;
     QPointer<Entry> m_historyOwner;
 
     QScopedPointer<Entry> m_tmpHistoryItem;
@@ -51,16 +51,48 @@ bool EntryAttachments::hasKey(const QString& key) const
 
 QSet<QByteArray> EntryAttachments::values() const
 {
-    return Tools::asSet(m_attachments.values());
+    QSet<QByteArray> values;
+    for (const auto& blob : m_attachments) {
+        values.insert(blob->data());
+    }
+    return values;
 }
 
 QByteArray EntryAttachments::value(const QString& key) const
+{
+    const auto blob = m_attachments.value(key);
+    return blob ? blob->data() : QByteArray();
+}
+
+QSharedPointer<const AttachmentBlob> EntryAttachments::blob(const QString& key) const
 {
     return m_attachments.value(key);
 }
 
+/**
+ * Content hash of an attachment, cached by the shared blob.
+ *
+ * @param key attachment name
+ * @return SHA-256 of the attachment data or an empty array if there is no such attachment
+ */
+QByteArray EntryAttachments::hash(const QString& key) const
+{
+    const auto blob = m_attachments.value(key);
+    return blob ? blob->hash() : QByteArray();
+}
+
 void EntryAttachments::set(const QString& key, const QByteArray& value)
 {
+    // Keep sharing the current blob (and its cached hash) if the content is unchanged
+    const auto current = m_attachments.value(key);
+    const bool unchanged = current && current->size() == value.size() && current->data() == value;
+    set(key, unchanged ? current : AttachmentBlob::create(value));
+}
+
+void EntryAttachments::set(const QString& key, const QSharedPointer<const AttachmentBlob>& blob)
+{
+    Q_ASSERT(blob);
+
     bool shouldEmitModified = false;
     bool addAttachment = !m_attachments.contains(key);
 
@@ -68,8 +100,8 @@ void EntryAttachments::set(const QString& key, const QByteArray& value)
         emit aboutToBeAdded(key);
     }
 
-    if (addAttachment || m_attachments.value(key) != value) {
-        m_attachments.insert(key, value);
+    if (addAttachment || *m_attachments.value(key) != *blob) {
+        m_attachments.insert(key, blob);
         shouldEmitModified = true;
     }
 
@@ -127,9 +159,9 @@ void EntryAttachments::remove(const QStringList& keys)
 
 void EntryAttachments::rename(const QString& key, const QString& newKey)
 {
-    const QByteArray val = value(key);
+    const auto blob = m_attachments.value(key);
     remove(key);
-    set(newKey, val);
+    set(newKey, blob);
 }
 
 bool EntryAttachments::isEmpty() const
@@ -197,19 +229,44 @@ void EntryAttachments::copyDataFrom(const EntryAttachments* other)
 
 bool EntryAttachments::operator==(const EntryAttachments& other) const
 {
-    return m_attachments == other.m_attachments;
+    if (m_attachments.size() != other.m_attachments.size()) {
+        return false;
+    }
+
+    // Both maps are sorted by key
+    auto otherIt = other.m_attachments.constBegin();
+    for (auto it = m_attachments.constBegin(); it != m_attachments.constEnd(); ++it, ++otherIt) {
+        if (it.key() != otherIt.key() || *it.value() != *otherIt.value()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool EntryAttachments::operator!=(const EntryAttachments& other) const
 {
-    return m_attachments != other.m_attachments;
+    return !(*this == other);
 }
 
-int EntryAttachments::attachmentsSize() const
+/**
+ * Size of the attachment names and data.
+ *
+ * @param countedBlobs if set, data of the blobs in this set is not counted again
+ *                     and the blobs of these attachments are added to it
+ * @return size in bytes
+ */
+int EntryAttachments::attachmentsSize(QSet<const AttachmentBlob*>* countedBlobs) const
 {
     int size = 0;
     for (auto it = m_attachments.constBegin(); it != m_attachments.constEnd(); ++it) {
-        size += it.key().toUtf8().size() + it.value().size();
+        size += it.key().toUtf8().size();
+        const auto* blob = it.value().data();
+        if (!countedBlobs || !countedBlobs->contains(blob)) {
+            size += blob->size();
+            if (countedBlobs) {
+                countedBlobs->insert(blob);
+            }
+        }
     }
     return size;
 }
@@ -0,0 +1,267 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntrySearchIndex.h"
+
+#include "core/Database.h"
+#include "core/Group.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+
+namespace
+{
+    constexpr int TrigramLength = 3;
+
+    bool isAscii(const QString& str)
+    {
+        for (const auto& c : str) {
+            if (c.unicode() > 0x7F) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+EntrySearchIndex::EntrySearchIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+{
+    connect(db, &Database::entryAdded, this, &EntrySearchIndex::addEntry);
+    connect(db, &Database::entryRemoved, this, &EntrySearchIndex::removeEntry);
+    connect(db, &Database::entryModified, this, &EntrySearchIndex::addEntry);
+    connect(db, &Database::groupAboutToAdd, this, &EntrySearchIndex::addGroup);
+    connect(db, &Database::groupAboutToRemove, this, &EntrySearchIndex::removeGroup);
+}
+
+/**
+ * Collect the entries that may contain all of the given literals.
+ *
+ * Literals shorter than three characters or containing non-ASCII characters
+ * cannot be looked up and do not restrict the result.
+ *
+ * @param literals plain substrings that every match must contain
+ * @param result receives the candidate entries
+ * @return false if none of the literals could restrict the search,
+ *         in that case every entry has to be considered
+ */
+bool EntrySearchIndex::candidates(const QStringList& literals, QSet<const Entry*>& result)
+{
+    if (!m_built) {
+        build();
+    } else {
+        reindexDirty();
+    }
+
+    bool restricted = false;
+    for (const auto& literal : literals) {
+        if (!isAscii(literal)) {
+            continue;
+        }
+
+        const auto grams = trigrams(literal);
+        if (grams.isEmpty()) {
+            continue;
+        }
+
+        QVector<const QSet<const Entry*>*> postings;
+        bool missing = false;
+        for (auto gram : grams) {
+            auto it = m_postings.constFind(gram);
+            if (it == m_postings.constEnd()) {
+                missing = true;
+                break;
+            }
+            postings << &it.value();
+        }
+
+        QSet<const Entry*> matches;
+        if (!missing) {
+            // Intersect starting from the rarest trigram to keep the working set small
+            std::sort(postings.begin(), postings.end(), [](const auto* a, const auto* b) {
+                return a->size() < b->size();
+            });
+            matches = *postings.first();
+            for (int i = 1; i < postings.size() && !matches.isEmpty(); ++i) {
+                matches.intersect(*postings.at(i));
+            }
+        }
+        matches.unite(m_unindexed);
+
+        if (restricted) {
+            result.intersect(matches);
+        } else {
+            result = matches;
+            restricted = true;
+        }
+    }
+
+    return restricted;
+}
+
+/**
+ * Drop the index, it will be rebuilt from the database on next use.
+ */
+void EntrySearchIndex::invalidate()
+{
+    m_postings.clear();
+    m_entryTrigrams.clear();
+    m_unindexed.clear();
+    m_dirty.clear();
+    m_built = false;
+}
+
+/**
+ * Split a search word into the plain substrings that any match must contain.
+ * Wildcards separate the literals, a logical or makes none of them required.
+ *
+ * @param word search word as entered by the user
+ * @return list of literals that are long enough to be looked up
+ */
+QStringList EntrySearchIndex::literalsFromSearchWord(const QString& word)
+{
+    static const QRegularExpression wildcards(QStringLiteral("[*?]"));
+
+    if (word.contains('|')) {
+        return {};
+    }
+
+    QStringList literals;
+    for (const auto& part : word.split(wildcards, Qt::SkipEmptyParts)) {
+        if (part.size() >= TrigramLength) {
+            literals << part;
+        }
+    }
+    return literals;
+}
+
+void EntrySearchIndex::addEntry(Entry* entry)
+{
+    if (!m_built) {
+        return;
+    }
+
+    m_dirty.insert(entry);
+}
+
+void EntrySearchIndex::removeEntry(Entry* entry)
+{
+    if (!m_built) {
+        return;
+    }
+
+    unindexEntry(entry);
+    m_dirty.remove(entry);
+}
+
+void EntrySearchIndex::addGroup(Group* group)
+{
+    if (!m_built) {
+        return;
+    }
+
+    group->forEachEntry([this](Entry* entry) { addEntry(entry); });
+}
+
+void EntrySearchIndex::removeGroup(Group* group)
+{
+    if (!m_built) {
+        return;
+    }
+
+    group->forEachEntry([this](Entry* entry) { removeEntry(entry); });
+}
+
+void EntrySearchIndex::build()
+{
+    invalidate();
+
+    if (m_db->rootGroup()) {
+        m_db->rootGroup()->forEachEntry([this](Entry* entry) { indexEntry(entry); });
+    }
+
+    m_built = true;
+}
+
+void EntrySearchIndex::reindexDirty()
+{
+    for (const auto* entry : asConst(m_dirty)) {
+        unindexEntry(entry);
+        indexEntry(entry);
+    }
+    m_dirty.clear();
+}
+
+void EntrySearchIndex::indexEntry(const Entry* entry)
+{
+    const auto title = entry->title();
+    const auto username = entry->username();
+    const auto url = entry->url();
+
+    // The searcher matches these fields after resolving placeholders
+    if (title.contains('{') || username.contains('{') || url.contains('{')) {
+        m_unindexed.insert(entry);
+        return;
+    }
+
+    QVector<quint64> grams;
+    for (const auto& text : {title, username, url, entry->notes(), entry->tags()}) {
+        grams << trigrams(text);
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    for (auto gram : asConst(grams)) {
+        m_postings[gram].insert(entry);
+    }
+    m_entryTrigrams.insert(entry, grams);
+}
+
+void EntrySearchIndex::unindexEntry(const Entry* entry)
+{
+    m_unindexed.remove(entry);
+
+    const auto grams = m_entryTrigrams.take(entry);
+    for (auto gram : grams) {
+        auto it = m_postings.find(gram);
+        if (it != m_postings.end()) {
+            it->remove(entry);
+            if (it->isEmpty()) {
+                m_postings.erase(it);
+            }
+        }
+    }
+}
+
+QVector<quint64> EntrySearchIndex::trigrams(const QString& text)
+{
+    QVector<quint64> grams;
+    const auto folded = text.toCaseFolded();
+    if (folded.size() < TrigramLength) {
+        return grams;
+    }
+
+    grams.reserve(folded.size() - TrigramLength + 1);
+    for (int i = 0; i + TrigramLength <= folded.size(); ++i) {
+        grams << (static_cast<quint64>(folded.at(i).unicode()) << 32
+                  | static_cast<quint64>(folded.at(i + 1).unicode()) << 16
+                  | static_cast<quint64>(folded.at(i + 2).unicode()));
+    }
+    return grams;
+}
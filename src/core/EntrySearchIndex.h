@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_ENTRYSEARCHINDEX_H
+#define KEEPASSXC_ENTRYSEARCHINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Trigram index over the searchable plain text fields (title, username, url,
+ * notes and tags) of every entry in a database.
+ *
+ * The index only answers whether an entry *may* contain a literal, so
+ * EntrySearcher still verifies every candidate with the full search term.
+ * Entries that contain placeholders are always reported as candidates since
+ * their searchable value is only known after resolving them.
+ *
+ * The index is built on first use and then kept up to date from the entry and
+ * group signals of the database. Added and modified entries are re-indexed
+ * lazily on the next lookup.
+ */
+class EntrySearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EntrySearchIndex(Database* db);
+
+    bool candidates(const QStringList& literals, QSet<const Entry*>& result);
+    void invalidate();
+
+    static QStringList literalsFromSearchWord(const QString& word);
+
+private slots:
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+    void addGroup(Group* group);
+    void removeGroup(Group* group);
+
+private:
+    void build();
+    void reindexDirty();
+    void indexEntry(const Entry* entry);
+    void unindexEntry(const Entry* entry);
+
+    static QVector<quint64> trigrams(const QString& text);
+
+    Database* m_db;
+    bool m_built = false;
+    QHash<quint64, QSet<const Entry*>> m_postings;
+    QHash<const Entry*, QVector<quint64>> m_entryTrigrams;
+    QSet<const Entry*> m_unindexed;
+    QSet<const Entry*> m_dirty;
+};
+
+#endif // KEEPASSXC_ENTRYSEARCHINDEX_H
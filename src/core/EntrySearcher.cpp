@@ -19,9 +19,18 @@
 #include "EntrySearcher.h"
 
 #include "PasswordHealth.h"
+#include "core/EntrySearchIndex.h"
 #include "core/Group.h"
 #include "core/Tools.h"
 
+#include <QtConcurrent>
+
+namespace
+{
+    // Below this number of entries the thread dispatch costs more than it saves
+    const int ParallelSearchThreshold = 1000;
+} // namespace
+
 EntrySearcher::EntrySearcher(bool caseSensitive, bool skipProtected)
     : m_caseSensitive(caseSensitive)
     , m_skipProtected(skipProtected)
@@ -69,17 +78,18 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
 {
     Q_ASSERT(baseGroup);
 
-    QList<Entry*> results;
-    for (const auto group : baseGroup->groupsRecursive(true)) {
-        if (forceSearch || group->resolveSearchingEnabled()) {
-            for (const auto entry : group->entries()) {
-                if (searchEntryImpl(entry)) {
-                    results.append(entry);
-                }
+    QSet<const Entry*> candidates;
+    const bool useIndex = indexCandidates(baseGroup, candidates);
+
+    QList<Entry*> entries;
+    baseGroup->forEachEntry(
+        [&](Entry* entry) {
+            if (!useIndex || candidates.contains(entry)) {
+                entries.append(entry);
             }
-        }
-    }
-    return results;
+        },
+        forceSearch ? Group::TraverseAll : Group::SkipSearchDisabled);
+    return repeatEntries(entries);
 }
 
 /**
@@ -117,6 +127,11 @@ QList<Entry*> EntrySearcher::searchEntries(const QString& searchString, const QL
  */
 QList<Entry*> EntrySearcher::repeatEntries(const QList<Entry*>& entries)
 {
+    if (m_parallel && entries.size() >= ParallelSearchThreshold) {
+        // Matching is read-only, the filtered result keeps the order of the input
+        return QtConcurrent::blockingFiltered(entries, [this](const Entry* entry) { return searchEntryImpl(entry); });
+    }
+
     QList<Entry*> results;
     for (auto* entry : entries) {
         if (searchEntryImpl(entry)) {
@@ -141,7 +156,64 @@ bool EntrySearcher::isCaseSensitive() const
     return m_caseSensitive;
 }
 
-bool EntrySearcher::searchEntryImpl(const Entry* entry)
+/**
+ * Evaluate large searches on the global thread pool
+ *
+ * @param state
+ */
+void EntrySearcher::setParallel(bool state)
+{
+    m_parallel = state;
+}
+
+bool EntrySearcher::isParallel() const
+{
+    return m_parallel;
+}
+
+/**
+ * Query the search index of the database for entries that may
+ * match all of the current search terms.
+ *
+ * @param baseGroup group the search starts from
+ * @param candidates receives the entries that need to be verified
+ * @return false if the index cannot narrow down the search
+ */
+bool EntrySearcher::indexCandidates(const Group* baseGroup, QSet<const Entry*>& candidates) const
+{
+    const auto db = baseGroup->database();
+    if (!db || !db->searchIndex()) {
+        return false;
+    }
+
+    QStringList literals;
+    for (const auto& term : m_searchTerms) {
+        if (term.exclude) {
+            continue;
+        }
+
+        switch (term.field) {
+        case Field::Undefined:
+        case Field::Title:
+        case Field::Username:
+        case Field::Url:
+        case Field::Notes:
+        case Field::Tag:
+            literals << term.literals;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (literals.isEmpty()) {
+        return false;
+    }
+
+    return db->searchIndex()->candidates(literals, candidates);
+}
+
+bool EntrySearcher::searchEntryImpl(const Entry* entry) const
 {
     // Pre-load in case they are needed
     auto attributes_keys = entry->attributes()->customKeys();
@@ -159,19 +231,19 @@ bool EntrySearcher::searchEntryImpl(const Entry* entry)
     for (const auto& term : m_searchTerms) {
         switch (term.field) {
         case Field::Title:
-            found = term.regex.match(entry->resolvePlaceholder(entry->title())).hasMatch();
+            found = term.regex.match(entry->resolvedAttribute(EntryAttributes::TitleKey)).hasMatch();
             break;
         case Field::Username:
-            found = term.regex.match(entry->resolvePlaceholder(entry->username())).hasMatch();
+            found = term.regex.match(entry->resolvedAttribute(EntryAttributes::UserNameKey)).hasMatch();
             break;
         case Field::Password:
             if (m_skipProtected) {
                 continue;
             }
-            found = term.regex.match(entry->resolvePlaceholder(entry->password())).hasMatch();
+            found = term.regex.match(entry->resolvedAttribute(EntryAttributes::PasswordKey)).hasMatch();
             break;
         case Field::Url:
-            found = term.regex.match(entry->resolvePlaceholder(entry->url())).hasMatch();
+            found = term.regex.match(entry->resolvedAttribute(EntryAttributes::URLKey)).hasMatch();
             break;
         case Field::Notes:
             found = term.regex.match(entry->notes()).hasMatch();
@@ -226,9 +298,9 @@ bool EntrySearcher::searchEntryImpl(const Entry* entry)
             break;
         default:
             // Terms without a specific field try to match title, username, url, and notes
-            found = term.regex.match(entry->resolvePlaceholder(entry->title())).hasMatch()
-                    || term.regex.match(entry->resolvePlaceholder(entry->username())).hasMatch()
-                    || term.regex.match(entry->resolvePlaceholder(entry->url())).hasMatch()
+            found = term.regex.match(entry->resolvedAttribute(EntryAttributes::TitleKey)).hasMatch()
+                    || term.regex.match(entry->resolvedAttribute(EntryAttributes::UserNameKey)).hasMatch()
+                    || term.regex.match(entry->resolvedAttribute(EntryAttributes::URLKey)).hasMatch()
                     || entry->tagList().indexOf(term.regex) != -1 || term.regex.match(entry->notes()).hasMatch();
         }
 
@@ -298,6 +370,11 @@ void EntrySearcher::parseSearchTerms(const QString& searchString)
         }
         term.regex = Tools::convertToRegex(term.word, opts);
 
+        // Plain words can be looked up in the search index
+        if (!mods.contains("*")) {
+            term.literals = EntrySearchIndex::literalsFromSearchWord(term.word);
+        }
+
         // Exclude modifier
         term.exclude = mods.contains("-") || mods.contains("!");
 
@@ -20,6 +20,7 @@
 #define KEEPASSX_ENTRYSEARCHER_H
 
 #include <QRegularExpression>
+#include <QSet>
 
 class Group;
 class Entry;
@@ -51,6 +52,8 @@ public:
         QString word;
         QRegularExpression regex;
         bool exclude;
+        // plain substrings every match must contain, used to query the search index
+        QStringList literals;
     };
 
     explicit EntrySearcher(bool caseSensitive = false, bool skipProtected = false);
@@ -65,13 +68,17 @@ public:
 
     void setCaseSensitive(bool state);
     bool isCaseSensitive() const;
+    void setParallel(bool state);
+    bool isParallel() const;
 
 private:
-    bool searchEntryImpl(const Entry* entry);
+    bool searchEntryImpl(const Entry* entry) const;
+    bool indexCandidates(const Group* baseGroup, QSet<const Entry*>& candidates) const;
     void parseSearchTerms(const QString& searchString);
 
     bool m_caseSensitive;
     bool m_skipProtected;
+    bool m_parallel = false;
     QList<SearchTerm> m_searchTerms;
 
     friend class TestEntrySearcher;
@@ -28,6 +28,7 @@
 #include "core/Global.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
+#include "core/UuidIndex.h"
 
 #include <QtConcurrent>
 #include <QtConcurrentFilter>
@@ -48,6 +49,8 @@ Group::Group()
     m_data.mergeMode = Default;
 
     connect(m_customData, &CustomData::modified, this, &Group::modified);
+    // Custom data holds inherited settings, see GroupSettingsCache
+    connect(m_customData, &CustomData::modified, this, [this] { emit groupDataChanged(this); });
     connect(this, &Group::modified, this, &Group::updateTimeinfo);
     connect(this, &Group::groupNonDataChange, this, &Group::updateTimeinfo);
 }
@@ -350,7 +353,9 @@ bool Group::equals(const Group* other, CompareItemOptions options) const
 
 void Group::setUuid(const QUuid& uuid)
 {
-    set(m_uuid, uuid);
+    if (set(m_uuid, uuid)) {
+        emit groupDataChanged(this);
+    }
 }
 
 void Group::setName(const QString& name)
@@ -410,12 +415,16 @@ void Group::setDefaultAutoTypeSequence(const QString& sequence)
 
 void Group::setAutoTypeEnabled(TriState enable)
 {
-    set(m_data.autoTypeEnabled, enable);
+    if (set(m_data.autoTypeEnabled, enable)) {
+        emit groupDataChanged(this);
+    }
 }
 
 void Group::setSearchingEnabled(TriState enable)
 {
-    set(m_data.searchingEnabled, enable);
+    if (set(m_data.searchingEnabled, enable)) {
+        emit groupDataChanged(this);
+    }
 }
 
 void Group::setLastTopVisibleEntry(Entry* entry)
@@ -597,19 +606,18 @@ const QList<Entry*>& Group::entries() const
 QList<Entry*> Group::entriesRecursive(bool includeHistoryItems) const
 {
     QList<Entry*> entryList;
+    if (!includeHistoryItems) {
+        forEachEntry([&entryList](Entry* entry) { entryList.append(entry); });
+        return entryList;
+    }
 
-    entryList.append(m_entries);
-
-    if (includeHistoryItems) {
-        for (Entry* entry : m_entries) {
+    // Callers keep the history items, so compact history has to be materialized
+    forEachGroup([&entryList](const Group* group) {
+        entryList.append(group->m_entries);
+        for (Entry* entry : group->m_entries) {
             entryList.append(entry->historyItems());
         }
-    }
-
-    for (Group* group : m_children) {
-        entryList.append(group->entriesRecursive(includeHistoryItems));
-    }
-
+    });
     return entryList;
 }
 
@@ -626,18 +634,35 @@ Entry* Group::findEntryByUuid(const QUuid& uuid, bool recursive) const
         return nullptr;
     }
 
-    auto entries = m_entries;
-    if (recursive) {
-        entries = entriesRecursive(false);
+    if (isIndexed()) {
+        bool ok;
+        auto entry = m_db->uuidIndex()->entry(uuid, &ok);
+        if (ok) {
+            if (entry && (recursive ? containsGroup(entry->group()) : entry->group() == this)) {
+                return entry;
+            }
+            return nullptr;
+        }
     }
 
-    for (auto entry : entries) {
-        if (entry->uuid() == uuid) {
-            return entry;
+    if (!recursive) {
+        for (auto entry : m_entries) {
+            if (entry->uuid() == uuid) {
+                return entry;
+            }
         }
+        return nullptr;
     }
 
-    return nullptr;
+    Entry* result = nullptr;
+    forEachEntry([&uuid, &result](Entry* entry) {
+        if (entry->uuid() == uuid) {
+            result = entry;
+            return false;
+        }
+        return true;
+    });
+    return result;
 }
 
 Entry* Group::findEntryByPath(const QString& entryPath) const
@@ -661,45 +686,45 @@ Entry* Group::findEntryBySearchTerm(const QString& term, EntryReferenceType refe
                "Database::findEntryRecursive",
                "Can't search entry with \"referenceType\" parameter equal to \"Unknown\"");
 
-    const QList<Group*> groups = groupsRecursive(true);
+    if (referenceType == EntryReferenceType::QUuid) {
+        return findEntryByUuid(QUuid::fromRfc4122(QByteArray::fromHex(term.toLatin1())));
+    }
 
-    for (const Group* group : groups) {
+    Entry* result = nullptr;
+    forEachEntry([&term, referenceType, &result](Entry* entry) {
         bool found = false;
-        const QList<Entry*>& entryList = group->entries();
-        for (Entry* entry : entryList) {
-            switch (referenceType) {
-            case EntryReferenceType::Unknown:
-                return nullptr;
-            case EntryReferenceType::Title:
-                found = entry->title() == term;
-                break;
-            case EntryReferenceType::UserName:
-                found = entry->username() == term;
-                break;
-            case EntryReferenceType::Password:
-                found = entry->password() == term;
-                break;
-            case EntryReferenceType::Url:
-                found = entry->url() == term;
-                break;
-            case EntryReferenceType::Notes:
-                found = entry->notes() == term;
-                break;
-            case EntryReferenceType::QUuid:
-                found = entry->uuid() == QUuid::fromRfc4122(QByteArray::fromHex(term.toLatin1()));
-                break;
-            case EntryReferenceType::CustomAttributes:
-                found = entry->attributes()->containsValue(term);
-                break;
-            }
-
-            if (found) {
-                return entry;
-            }
+        switch (referenceType) {
+        case EntryReferenceType::Unknown:
+            return false;
+        case EntryReferenceType::Title:
+            found = entry->title() == term;
+            break;
+        case EntryReferenceType::UserName:
+            found = entry->username() == term;
+            break;
+        case EntryReferenceType::Password:
+            found = entry->password() == term;
+            break;
+        case EntryReferenceType::Url:
+            found = entry->url() == term;
+            break;
+        case EntryReferenceType::Notes:
+            found = entry->notes() == term;
+            break;
+        case EntryReferenceType::QUuid:
+            // Handled above
+            break;
+        case EntryReferenceType::CustomAttributes:
+            found = entry->attributes()->containsValue(term);
+            break;
         }
-    }
 
-    return nullptr;
+        if (found) {
+            result = entry;
+        }
+        return !found;
+    });
+    return result;
 }
 
 Entry* Group::findEntryByPathRecursive(const QString& entryPath, const QString& basePath) const
@@ -800,49 +825,54 @@ QString Group::print(bool recursive, bool flatten, int depth)
 QList<const Group*> Group::groupsRecursive(bool includeSelf) const
 {
     QList<const Group*> groupList;
-    if (includeSelf) {
-        groupList.append(this);
-    }
-
-    for (const Group* group : asConst(m_children)) {
-        groupList.append(group->groupsRecursive(true));
-    }
-
+    forEachGroup([this, includeSelf, &groupList](const Group* group) {
+        if (includeSelf || group != this) {
+            groupList.append(group);
+        }
+    });
     return groupList;
 }
 
 QList<Group*> Group::groupsRecursive(bool includeSelf)
 {
     QList<Group*> groupList;
-    if (includeSelf) {
-        groupList.append(this);
-    }
-
-    for (Group* group : asConst(m_children)) {
-        groupList.append(group->groupsRecursive(true));
-    }
-
+    forEachGroup([this, includeSelf, &groupList](Group* group) {
+        if (includeSelf || group != this) {
+            groupList.append(group);
+        }
+    });
     return groupList;
 }
 
+/**
+ * Prepare forEachGroup() and forEachEntry(), the settings of the parents
+ * decide whether this group is skipped.
+ *
+ * @return false if nothing is to be visited
+ */
+bool Group::beginTraversal(TraversalFlags flags, TraversalState& state) const
+{
+    state.recycleBin = m_db ? m_db->metadata()->recycleBin() : nullptr;
+    state.searchingEnabled = !m_parent || m_parent->resolveSearchingEnabled();
+    return !flags.testFlag(SkipRecycled) || !m_parent || !m_parent->isRecycled();
+}
+
 QSet<QUuid> Group::customIconsRecursive() const
 {
     QSet<QUuid> result;
 
-    if (!iconUuid().isNull()) {
-        result.insert(iconUuid());
-    }
-
-    const QList<Entry*> entryList = entriesRecursive(true);
-    for (Entry* entry : entryList) {
+    forEachGroup([&result](const Group* group) {
+        if (!group->iconUuid().isNull()) {
+            result.insert(group->iconUuid());
+        }
+    });
+    // Compact history is not decoded for its icons
+    forEachEntry([&result](const Entry* entry) {
         if (!entry->iconUuid().isNull()) {
             result.insert(entry->iconUuid());
         }
-    }
-
-    for (Group* group : m_children) {
-        result.unite(group->customIconsRecursive());
-    }
+        result.unite(entry->historyIconUuids());
+    });
 
     return result;
 }
@@ -851,12 +881,12 @@ QList<QString> Group::usernamesRecursive(int topN) const
 {
     // Collect all usernames and sort for easy counting
     QHash<QString, int> countedUsernames;
-    for (const auto* entry : entriesRecursive()) {
+    forEachEntry([&countedUsernames](const Entry* entry) {
         const auto username = entry->username();
         if (!username.isEmpty() && !entry->isAttributeReference(EntryAttributes::UserNameKey)) {
             countedUsernames.insert(username, ++countedUsernames[username]);
         }
-    }
+    });
 
     // Sort username/frequency pairs by frequency and name
     QList<QPair<QString, int>> sortedUsernames;
@@ -885,17 +915,7 @@ QList<QString> Group::usernamesRecursive(int topN) const
 
 Group* Group::findGroupByUuid(const QUuid& uuid)
 {
-    if (uuid.isNull()) {
-        return nullptr;
-    }
-
-    for (Group* group : groupsRecursive(true)) {
-        if (group->uuid() == uuid) {
-            return group;
-        }
-    }
-
-    return nullptr;
+    return const_cast<Group*>(static_cast<const Group*>(this)->findGroupByUuid(uuid));
 }
 
 const Group* Group::findGroupByUuid(const QUuid& uuid) const
@@ -904,13 +924,23 @@ const Group* Group::findGroupByUuid(const QUuid& uuid) const
         return nullptr;
     }
 
-    for (const Group* group : groupsRecursive(true)) {
-        if (group->uuid() == uuid) {
-            return group;
+    if (isIndexed()) {
+        bool ok;
+        auto group = m_db->uuidIndex()->group(uuid, &ok);
+        if (ok) {
+            return group && containsGroup(group) ? group : nullptr;
         }
     }
 
-    return nullptr;
+    const Group* result = nullptr;
+    forEachGroup([&uuid, &result](const Group* group) {
+        if (group->uuid() == uuid) {
+            result = group;
+            return false;
+        }
+        return true;
+    });
+    return result;
 }
 
 Group* Group::findChildByName(const QString& name)
@@ -941,20 +971,32 @@ Group* Group::clone(Entry::CloneFlags entryFlags, Group::CloneFlags groupFlags)
         clonedGroup->setUuid(this->uuid());
     }
 
+    const bool exactCopy = groupFlags & Group::CloneExactCopy;
+
     clonedGroup->m_data = m_data;
-    clonedGroup->m_customData->copyDataFrom(m_customData);
+    clonedGroup->m_customData->copyDataFrom(m_customData, exactCopy);
 
     if (groupFlags & Group::CloneIncludeEntries) {
         const QList<Entry*> entryList = entries();
         for (Entry* entry : entryList) {
             Entry* clonedEntry = entry->clone(entryFlags);
             clonedEntry->setGroup(clonedGroup);
+            if (exactCopy) {
+                // Attaching the clone counts as a location change
+                clonedEntry->setTimeInfo(entry->timeInfo());
+                if (entry == m_lastTopVisibleEntry) {
+                    clonedGroup->m_lastTopVisibleEntry = clonedEntry;
+                }
+            }
         }
 
         const QList<Group*> childrenGroups = children();
         for (Group* groupChild : childrenGroups) {
             Group* clonedGroupChild = groupChild->clone(entryFlags, groupFlags);
             clonedGroupChild->setParent(clonedGroup);
+            if (exactCopy) {
+                clonedGroupChild->setTimeInfo(groupChild->timeInfo());
+            }
         }
     }
 
@@ -993,6 +1035,7 @@ void Group::addEntry(Entry* entry)
 
     m_entries << entry;
     connect(entry, &Entry::entryDataChanged, this, &Group::entryDataChanged);
+    connect(entry, &Entry::modified, this, [this, entry] { emit entryModified(entry); });
     if (m_db) {
         connect(entry, &Entry::modified, m_db, &Database::markAsModified);
     }
@@ -1068,6 +1111,11 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
         connect(this, &Group::groupAdded, db, &Database::groupAdded);
         connect(this, &Group::aboutToMove, db, &Database::groupAboutToMove);
         connect(this, &Group::groupMoved, db, &Database::groupMoved);
+        connect(this, &Group::entryAboutToAdd, db, &Database::entryAboutToAdd);
+        connect(this, &Group::entryAdded, db, &Database::entryAdded);
+        connect(this, &Group::entryAboutToRemove, db, &Database::entryAboutToRemove);
+        connect(this, &Group::entryRemoved, db, &Database::entryRemoved);
+        connect(this, &Group::entryModified, db, &Database::entryModified);
         connect(this, &Group::groupNonDataChange, db, &Database::markNonDataChange);
         connect(this, &Group::modified, db, &Database::markAsModified);
         // clang-format on
@@ -1090,6 +1138,27 @@ void Group::cleanupParent()
     }
 }
 
+/**
+ * @return true if the group is this group or one of its descendants
+ */
+bool Group::containsGroup(const Group* group) const
+{
+    for (; group; group = group->parentGroup()) {
+        if (group == this) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @return true if this group is part of the tree covered by the uuid index of its database
+ */
+bool Group::isIndexed() const
+{
+    return m_db && m_db->rootGroup() && m_db->rootGroup()->containsGroup(this);
+}
+
 void Group::recCreateDelObjects()
 {
     if (m_db) {
@@ -21,6 +21,8 @@
 
 #include <QPointer>
 
+#include <type_traits>
+
 #include "core/CustomData.h"
 #include "core/Database.h"
 #include "core/Entry.h"
@@ -51,9 +53,19 @@ public:
         CloneIncludeEntries = 4, // clone the group entries
         CloneDefault = CloneNewUuid | CloneResetTimeInfo | CloneIncludeEntries,
         CloneRenameTitle = 8, // add "- Clone" after the original title
+        CloneExactCopy = 16, // keep all timestamps of the original, used for database snapshots
     };
     Q_DECLARE_FLAGS(CloneFlags, CloneFlag)
 
+    enum TraversalFlag
+    {
+        TraverseAll = 0,
+        SkipRecycled = 1, // skip the recycle bin and everything below it
+        SkipSearchDisabled = 2, // skip groups that are excluded from searches, their children are still visited
+        IncludeHistory = 4, // forEachEntry() also visits the history items of every entry
+    };
+    Q_DECLARE_FLAGS(TraversalFlags, TraversalFlag)
+
     struct GroupData
     {
         QString name;
@@ -162,6 +174,10 @@ public:
     QSet<QUuid> customIconsRecursive() const;
     QList<QString> usernamesRecursive(int topN = -1) const;
 
+    template <class Visitor> bool forEachGroup(Visitor&& visitor, TraversalFlags flags = TraverseAll);
+    template <class Visitor> bool forEachGroup(Visitor&& visitor, TraversalFlags flags = TraverseAll) const;
+    template <class Visitor> bool forEachEntry(Visitor&& visitor, TraversalFlags flags = TraverseAll) const;
+
     Group* clone(Entry::CloneFlags entryFlags = Entry::CloneDefault,
                  Group::CloneFlags groupFlags = Group::CloneDefault) const;
 
@@ -194,6 +210,7 @@ signals:
     void entryAdded(Entry* entry);
     void entryAboutToRemove(Entry* entry);
     void entryRemoved(Entry* entry);
+    void entryModified(Entry* entry);
     void entryAboutToMoveUp(int row);
     void entryMovedUp();
     void entryAboutToMoveDown(int row);
@@ -204,13 +221,25 @@ private slots:
     void updateTimeinfo();
 
 private:
+    struct TraversalState
+    {
+        const Group* recycleBin;
+        bool searchingEnabled;
+    };
+
     template <class P, class V> bool set(P& property, const V& value);
+    template <class G, class Visitor>
+    static bool traverse(G* group, Visitor& visitor, TraversalFlags flags, TraversalState state);
+    template <class Visitor, class T> static bool visit(Visitor& visitor, T* item);
+    bool beginTraversal(TraversalFlags flags, TraversalState& state) const;
 
     void setParent(Database* db);
 
     void connectDatabaseSignalsRecursive(Database* db);
     void cleanupParent();
     void recCreateDelObjects();
+    bool containsGroup(const Group* group) const;
+    bool isIndexed() const;
 
     Entry* findEntryByPathRecursive(const QString& entryPath, const QString& basePath) const;
     Group* findGroupByPathRecursive(const QString& groupPath, const QString& basePath);
@@ -232,5 +261,93 @@ private:
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Group::CloneFlags)
+Q_DECLARE_OPERATORS_FOR_FLAGS(Group::TraversalFlags)
+
+/**
+ * Visit this group and all groups below it depth-first, in the order of groupsRecursive(true).
+ * Unlike groupsRecursive() no list is built. The tree must not be changed while it is traversed.
+ *
+ * @param visitor callable taking a group, it may return false to stop the traversal
+ * @param flags groups to skip
+ * @return false if the visitor stopped the traversal
+ */
+template <class Visitor> bool Group::forEachGroup(Visitor&& visitor, TraversalFlags flags)
+{
+    TraversalState state;
+    return !beginTraversal(flags, state) || traverse(this, visitor, flags, state);
+}
+
+template <class Visitor> bool Group::forEachGroup(Visitor&& visitor, TraversalFlags flags) const
+{
+    TraversalState state;
+    return !beginTraversal(flags, state) || traverse(this, visitor, flags, state);
+}
+
+/**
+ * Visit the entries of this group and all groups below it, in the order of entriesRecursive().
+ *
+ * History items are visited through Entry::forEachHistoryItem(), so compact history is not
+ * materialized and the visitor must take a const entry and must not keep pointers to history items.
+ *
+ * @param visitor callable taking an entry, it may return false to stop the traversal
+ * @param flags groups to skip and whether to include history items
+ * @return false if the visitor stopped the traversal
+ */
+template <class Visitor> bool Group::forEachEntry(Visitor&& visitor, TraversalFlags flags) const
+{
+    return forEachGroup(
+        [&visitor, flags](const Group* group) {
+            for (Entry* entry : group->m_entries) {
+                if (!visit(visitor, entry)) {
+                    return false;
+                }
+            }
+            if constexpr (std::is_invocable_v<Visitor&, const Entry*>) {
+                if (flags.testFlag(IncludeHistory)) {
+                    for (const Entry* entry : group->m_entries) {
+                        if (!entry->forEachHistoryItem(
+                                [&visitor](const Entry* historyItem) { return visit(visitor, historyItem); })) {
+                            return false;
+                        }
+                    }
+                }
+            } else {
+                Q_ASSERT(!flags.testFlag(IncludeHistory));
+            }
+            return true;
+        },
+        flags);
+}
+
+template <class G, class Visitor>
+bool Group::traverse(G* group, Visitor& visitor, TraversalFlags flags, TraversalState state)
+{
+    if (flags.testFlag(SkipRecycled) && group == state.recycleBin) {
+        return true;
+    }
+    if (group->m_data.searchingEnabled != Inherit) {
+        state.searchingEnabled = group->m_data.searchingEnabled == Enable;
+    }
+    if ((state.searchingEnabled || !flags.testFlag(SkipSearchDisabled)) && !visit(visitor, group)) {
+        return false;
+    }
+
+    for (G* child : asConst(group->m_children)) {
+        if (!traverse(child, visitor, flags, state)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Visitor, class T> bool Group::visit(Visitor& visitor, T* item)
+{
+    if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, T*>>) {
+        visitor(item);
+        return true;
+    } else {
+        return visitor(item);
+    }
+}
 
 #endif // KEEPASSX_GROUP_H
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GroupSettingsCache.h"
+
+/**
+ * @param key custom data key
+ * @return Enable or Disable if the group or a parent sets the key, Inherit otherwise
+ */
+Group::TriState EffectiveGroupSettings::customDataTriState(const QString& key) const
+{
+    const auto it = customData.constFind(key);
+    if (it == customData.constEnd()) {
+        return Group::Inherit;
+    }
+    return it.value() == TRUE_STR ? Group::Enable : Group::Disable;
+}
+
+/**
+ * @param key custom data key
+ * @return value set by the group or its closest parent, empty if none sets the key
+ */
+QString EffectiveGroupSettings::customDataString(const QString& key) const
+{
+    return customData.value(key);
+}
+
+GroupSettingsCache::GroupSettingsCache(Database* db)
+    : QObject(db)
+{
+    connect(db, &Database::groupDataChanged, this, &GroupSettingsCache::invalidateGroup);
+    connect(db, &Database::groupAboutToRemove, this, &GroupSettingsCache::invalidateGroup);
+    connect(db, &Database::groupAboutToMove, this, &GroupSettingsCache::groupAboutToMove);
+    connect(db, &Database::groupMoved, this, &GroupSettingsCache::groupMoved);
+}
+
+/**
+ * Effective settings of a group, same as resolving every setting on the group.
+ *
+ * @param group group that is part of the database owning this cache
+ * @return settings including those inherited from the parents
+ */
+EffectiveGroupSettings GroupSettingsCache::settings(const Group* group)
+{
+    {
+        QReadLocker locker(&m_lock);
+        const auto it = m_settings.constFind(group);
+        if (it != m_settings.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    return resolve(group);
+}
+
+void GroupSettingsCache::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_settings.clear();
+}
+
+void GroupSettingsCache::invalidateGroup(Group* group)
+{
+    QWriteLocker locker(&m_lock);
+    if (m_settings.isEmpty()) {
+        return;
+    }
+
+    group->forEachGroup([this](const Group* child) { m_settings.remove(child); });
+}
+
+void GroupSettingsCache::groupAboutToMove(Group* group)
+{
+    m_movingGroup = group;
+    invalidateGroup(group);
+}
+
+void GroupSettingsCache::groupMoved()
+{
+    // A lookup between both signals still resolves through the old parent
+    if (m_movingGroup) {
+        invalidateGroup(m_movingGroup);
+        m_movingGroup.clear();
+    }
+}
+
+const EffectiveGroupSettings& GroupSettingsCache::resolve(const Group* group)
+{
+    const auto it = m_settings.constFind(group);
+    if (it != m_settings.constEnd()) {
+        return it.value();
+    }
+
+    EffectiveGroupSettings settings;
+    if (group->parentGroup()) {
+        settings = resolve(group->parentGroup());
+    }
+
+    if (group->searchingEnabled() != Group::Inherit) {
+        settings.searchingEnabled = group->searchingEnabled() == Group::Enable;
+    }
+    if (group->autoTypeEnabled() != Group::Inherit) {
+        settings.autoTypeEnabled = group->autoTypeEnabled() == Group::Enable;
+    }
+
+    const auto customData = group->customData();
+    for (const auto& key : customData->keys()) {
+        settings.customData.insert(key, customData->value(key));
+    }
+
+    return m_settings.insert(group, settings).value();
+}
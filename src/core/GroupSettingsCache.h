@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_GROUPSETTINGSCACHE_H
+#define KEEPASSXC_GROUPSETTINGSCACHE_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QReadWriteLock>
+
+#include "core/Group.h"
+
+/**
+ * Settings of a group after applying the inheritance from its parents.
+ */
+struct EffectiveGroupSettings
+{
+    bool searchingEnabled = true;
+    bool autoTypeEnabled = true;
+    // Custom data of the group and its parents, the value closest to the group wins
+    QHash<QString, QString> customData;
+
+    Group::TriState customDataTriState(const QString& key) const;
+    QString customDataString(const QString& key) const;
+};
+
+/**
+ * Memoized effective settings of the groups in a database.
+ *
+ * Resolving an inherited setting walks up to the root group with a custom data
+ * lookup per level. The cache resolves every group once from the settings of
+ * its parent, a group without own custom data shares the map of its parent.
+ * Changing the settings of a group or moving it drops the cached settings of
+ * the group and everything below it.
+ *
+ * Lookups are thread-safe.
+ */
+class GroupSettingsCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GroupSettingsCache(Database* db);
+
+    EffectiveGroupSettings settings(const Group* group);
+    void clear();
+
+private slots:
+    void invalidateGroup(Group* group);
+    void groupAboutToMove(Group* group);
+    void groupMoved();
+
+private:
+    const EffectiveGroupSettings& resolve(const Group* group);
+
+    QReadWriteLock m_lock;
+    QHash<const Group*, EffectiveGroupSettings> m_settings;
+    QPointer<Group> m_movingGroup;
+};
+
+#endif // KEEPASSXC_GROUPSETTINGSCACHE_H
@@ -17,95 +17,483 @@
 
 #include "HibpOffline.h"
 
+#include "config-keepassx.h"
+#include "core/Global.h"
 #include "core/Group.h"
 
 #include <QCryptographicHash>
+#include <QFile>
+#include <QFileDevice>
 #include <QProcess>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#ifdef HAVE_OKON
+#include <okon.h>
+#endif
 
 namespace HibpOffline
 {
     const std::size_t SHA1_BYTES = 20;
 
-    enum class ParseResult
-    {
-        Ok,
-        Eof,
-        Error
-    };
+    // Binary index: magic and format version, followed by records of the
+    // raw SHA-1 and the big-endian 32 bit leak count, sorted by SHA-1
+    const QByteArray INDEX_MAGIC("KPXCHIBP");
+    const quint32 INDEX_VERSION = 1;
+    const qint64 INDEX_HEADER_SIZE = 16;
+    const qint64 INDEX_RECORD_SIZE = SHA1_BYTES + sizeof(quint32);
+
+    // Smaller text files are streamed, checking their sort order would not pay off
+    const qint64 MIN_SORTED_SEARCH_SIZE = 1024 * 1024;
+    const int SORT_ORDER_SAMPLES = 64;
 
-    ParseResult parseHibpLine(QIODevice& input, QByteArray& sha1, int& count)
+    const int MAX_LINE_LENGTH = 128;
+
+    int hexValue(char c)
     {
-        QByteArray hexSha1(SHA1_BYTES * 2, '\0');
-        const qint64 rc = input.read(hexSha1.data(), hexSha1.size());
-        if (rc == 0) {
-            return ParseResult::Eof;
-        } else if (rc != hexSha1.size()) {
-            return ParseResult::Error;
+        if ('0' <= c && c <= '9') {
+            return c - '0';
+        } else if ('a' <= c && c <= 'f') {
+            return c - 'a' + 10;
+        } else if ('A' <= c && c <= 'F') {
+            return c - 'A' + 10;
         }
+        return -1;
+    }
 
-        sha1 = QByteArray::fromHex(hexSha1);
+    /**
+     * Parse a single line of the HIBP file of the form <hex SHA-1>:<count>.
+     *
+     * @param begin start of the line
+     * @param end end of the line, excluding the line break
+     * @param sha1 receives the raw SHA-1, must hold SHA1_BYTES bytes
+     * @param count receives the leak count
+     * @return true if the line is well formed
+     */
+    bool parseHibpLine(const char* begin, const char* end, char* sha1, int& count)
+    {
+        if (end - begin < static_cast<qint64>(SHA1_BYTES * 2 + 2) || begin[SHA1_BYTES * 2] != ':') {
+            return false;
+        }
 
-        char c;
-        if (!input.getChar(&c) || c != ':') {
-            return ParseResult::Error;
+        for (std::size_t i = 0; i < SHA1_BYTES; ++i) {
+            const int high = hexValue(begin[2 * i]);
+            const int low = hexValue(begin[2 * i + 1]);
+            if (high < 0 || low < 0) {
+                return false;
+            }
+            sha1[i] = static_cast<char>(high << 4 | low);
         }
 
         count = 0;
-        while (true) {
-            if (!input.getChar(&c)) {
-                return ParseResult::Error;
+        for (const char* c = begin + SHA1_BYTES * 2 + 1; c != end; ++c) {
+            if (!('0' <= *c && *c <= '9') || count > (std::numeric_limits<int>::max() - 9) / 10) {
+                return false;
             }
+            count *= 10;
+            count += (*c - '0');
+        }
+
+        return true;
+    }
 
-            if (c == '\n' || c == '\r') {
-                break;
+    /**
+     * Lines of the mapped text file, tolerating CR LF line breaks.
+     */
+    class MappedLines
+    {
+    public:
+        MappedLines(const char* data, qint64 size)
+            : m_data(data)
+            , m_size(size)
+        {
+        }
+
+        qint64 lineStart(qint64 pos) const
+        {
+            while (pos > 0 && m_data[pos - 1] != '\n') {
+                --pos;
             }
+            return pos;
+        }
 
-            if (!('0' <= c && c <= '9')) {
-                return ParseResult::Error;
+        qint64 nextLineStart(qint64 pos) const
+        {
+            const auto* lineBreak = static_cast<const char*>(std::memchr(m_data + pos, '\n', m_size - pos));
+            return lineBreak ? lineBreak - m_data + 1 : m_size;
+        }
+
+        bool parse(qint64 pos, char* sha1, int& count) const
+        {
+            auto end = nextLineStart(pos);
+            while (end > pos && (m_data[end - 1] == '\n' || m_data[end - 1] == '\r')) {
+                --end;
             }
+            return parseHibpLine(m_data + pos, m_data + end, sha1, count);
+        }
 
-            count *= 10;
-            count += (c - '0');
+    private:
+        const char* m_data;
+        qint64 m_size;
+    };
+
+    /**
+     * Check whether the text file is sorted by SHA-1 as the official "ordered by hash"
+     * downloads are. Only a sample of evenly spaced lines is compared.
+     */
+    bool looksSortedByHash(const MappedLines& lines, qint64 size)
+    {
+        char previous[SHA1_BYTES] = {};
+        char sha1[SHA1_BYTES];
+        int count;
+        for (int i = 0; i < SORT_ORDER_SAMPLES; ++i) {
+            const auto pos = lines.lineStart(size / SORT_ORDER_SAMPLES * i);
+            if (!lines.parse(pos, sha1, count) || std::memcmp(previous, sha1, SHA1_BYTES) > 0) {
+                return false;
+            }
+            std::memcpy(previous, sha1, SHA1_BYTES);
+        }
+        return true;
+    }
+
+    /**
+     * Binary search for a SHA-1 in a text file sorted by hash.
+     *
+     * @return leak count, 0 if not found and -1 on parse error
+     */
+    int searchSorted(const MappedLines& lines, qint64 size, const QByteArray& wanted)
+    {
+        char sha1[SHA1_BYTES];
+        int count;
+
+        // Find the first line with a hash not less than the wanted one, both bounds are line starts
+        qint64 low = 0;
+        qint64 high = size;
+        while (low < high) {
+            const auto pos = lines.lineStart(low + (high - low) / 2);
+            if (!lines.parse(pos, sha1, count)) {
+                return -1;
+            }
+            if (std::memcmp(sha1, wanted.constData(), SHA1_BYTES) < 0) {
+                low = lines.nextLineStart(pos);
+            } else {
+                high = pos;
+            }
+        }
+
+        if (low < size && lines.parse(low, sha1, count) && std::memcmp(sha1, wanted.constData(), SHA1_BYTES) == 0) {
+            return count;
+        }
+        return 0;
+    }
+
+    /**
+     * Binary search for a SHA-1 in the records of a binary index.
+     *
+     * @return leak count or 0 if not found
+     */
+    int searchIndex(const uchar* records, qint64 recordCount, const QByteArray& wanted)
+    {
+        qint64 low = 0;
+        qint64 high = recordCount;
+        while (low < high) {
+            const auto mid = low + (high - low) / 2;
+            if (std::memcmp(records + mid * INDEX_RECORD_SIZE, wanted.constData(), SHA1_BYTES) < 0) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        const auto* record = records + low * INDEX_RECORD_SIZE;
+        if (low < recordCount && std::memcmp(record, wanted.constData(), SHA1_BYTES) == 0) {
+            return static_cast<int>(qFromBigEndian<quint32>(record + SHA1_BYTES));
+        }
+        return 0;
+    }
+
+    /**
+     * @return true if the data starts like a binary index, error is set if it cannot be used
+     */
+    bool isIndex(const uchar* data, qint64 size, QString* error)
+    {
+        const int magicSize = static_cast<int>(qMin<qint64>(size, INDEX_MAGIC.size()));
+        if (QByteArray::fromRawData(reinterpret_cast<const char*>(data), magicSize) != INDEX_MAGIC) {
+            return false;
         }
 
-        while (1 == input.peek(&c, 1) && (c == '\n' || c == '\r')) {
-            input.getChar(&c);
+        if (size < INDEX_HEADER_SIZE || qFromBigEndian<quint32>(data + INDEX_MAGIC.size()) != INDEX_VERSION
+            || (size - INDEX_HEADER_SIZE) % INDEX_RECORD_SIZE != 0) {
+            *error = QObject::tr("Unsupported or corrupted HIBP index file");
         }
+        return true;
+    }
+
+    /**
+     * Look up all vault hashes in a memory-mapped HIBP text file sorted by hash
+     * or in a binary index.
+     *
+     * @return false if the file has to be streamed instead
+     */
+    bool mappedReport(QFileDevice& file,
+                      const QMultiHash<QByteArray, const Entry*>& entriesBySha1,
+                      QList<QPair<const Entry*, int>>& findings,
+                      QString* error)
+    {
+        const auto size = file.size();
+        uchar* data = size > 0 ? file.map(0, size) : nullptr;
+        if (!data) {
+            return false;
+        }
+
+        // Reporting in hash order matches the order of the findings when streaming a sorted file
+        auto hashes = entriesBySha1.uniqueKeys();
+        std::sort(hashes.begin(), hashes.end(), [](const QByteArray& a, const QByteArray& b) {
+            return std::memcmp(a.constData(), b.constData(), SHA1_BYTES) < 0;
+        });
 
-        return ParseResult::Ok;
+        const auto initialFindings = findings.size();
+        bool handled = true;
+        if (isIndex(data, size, error)) {
+            if (error->isEmpty()) {
+                const auto recordCount = (size - INDEX_HEADER_SIZE) / INDEX_RECORD_SIZE;
+                for (const auto& sha1 : asConst(hashes)) {
+                    const auto count = searchIndex(data + INDEX_HEADER_SIZE, recordCount, sha1);
+                    if (count > 0) {
+                        for (const auto* entry : entriesBySha1.values(sha1)) {
+                            findings.append({entry, count});
+                        }
+                    }
+                }
+            }
+        } else {
+            MappedLines lines(reinterpret_cast<const char*>(data), size);
+            handled = size >= MIN_SORTED_SEARCH_SIZE && looksSortedByHash(lines, size);
+            for (int i = 0; handled && i < hashes.size(); ++i) {
+                const auto count = searchSorted(lines, size, hashes.at(i));
+                if (count < 0) {
+                    *error = QObject::tr("HIBP file: parse error");
+                } else if (count > 0) {
+                    for (const auto* entry : entriesBySha1.values(hashes.at(i))) {
+                        findings.append({entry, count});
+                    }
+                }
+                handled = count >= 0;
+            }
+            // Parse errors are reported with their line number when streaming
+            if (!handled) {
+                findings.erase(findings.begin() + initialFindings, findings.end());
+                error->clear();
+            }
+        }
+
+        file.unmap(data);
+        return handled;
     }
 
+    /**
+     * Read the next non-empty line of a HIBP text file.
+     *
+     * @return length of the line without line break, 0 at the end of the input and -1 on error
+     */
+    qint64 readHibpLine(QIODevice& input, char* buffer)
+    {
+        while (!input.atEnd()) {
+            auto length = input.readLine(buffer, MAX_LINE_LENGTH);
+            if (length < 0) {
+                return -1;
+            }
+            if (length == MAX_LINE_LENGTH - 1 && buffer[length - 1] != '\n') {
+                // Line too long to be valid
+                return -1;
+            }
+            while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r')) {
+                --length;
+            }
+            if (length > 0) {
+                return length;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Check every vault password against the HIBP file.
+     *
+     * Files sorted by hash (the "ordered by hash" downloads) and binary indexes
+     * created by buildIndex() are memory-mapped and binary-searched. Any other
+     * input is streamed line by line.
+     */
     bool
     report(QSharedPointer<Database> db, QIODevice& hibpInput, QList<QPair<const Entry*, int>>& findings, QString* error)
     {
         QMultiHash<QByteArray, const Entry*> entriesBySha1;
-        for (const auto* entry : db->rootGroup()->entriesRecursive()) {
-            if (!entry->isRecycled()) {
+        db->rootGroup()->forEachEntry(
+            [&entriesBySha1](const Entry* entry) {
                 const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
                 entriesBySha1.insert(sha1, entry);
-            }
+            },
+            Group::SkipRecycled);
+
+        if (!hibpInput.isReadable()) {
+            *error = QObject::tr("Failed to read HIBP file: %1").arg(hibpInput.errorString());
+            return false;
         }
 
-        QByteArray sha1;
-        for (quint64 lineNum = 1;; ++lineNum) {
-            int count = 0;
+        auto file = qobject_cast<QFileDevice*>(&hibpInput);
+        if (file && mappedReport(*file, entriesBySha1, findings, error)) {
+            return error->isEmpty();
+        }
 
-            switch (parseHibpLine(hibpInput, sha1, count)) {
-            case ParseResult::Eof:
+        char line[MAX_LINE_LENGTH];
+        char sha1[SHA1_BYTES];
+        int count = 0;
+        for (quint64 lineNum = 1;; ++lineNum) {
+            const auto length = readHibpLine(hibpInput, line);
+            if (length == 0) {
                 return true;
-            case ParseResult::Error:
+            } else if (length < 0 || !parseHibpLine(line, line + length, sha1, count)) {
                 *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
                 return false;
-            default:
-                break;
             }
 
-            for (const auto* entry : entriesBySha1.values(sha1)) {
+            for (const auto* entry : entriesBySha1.values(QByteArray::fromRawData(sha1, SHA1_BYTES))) {
                 findings.append({entry, count});
             }
         }
     }
 
+    /**
+     * Convert a HIBP text file sorted by hash into the binary index format
+     * understood by report(). The index is about half the size of the text
+     * file and does not need any parsing when searched.
+     *
+     * @param hibpInput HIBP text file, sorted by hash
+     * @param indexOutput device to write the index to
+     * @param error receives the error message on failure
+     * @return true on success
+     */
+    bool buildIndex(QIODevice& hibpInput, QIODevice& indexOutput, QString* error)
+    {
+        if (!hibpInput.isReadable()) {
+            *error = QObject::tr("Failed to read HIBP file: %1").arg(hibpInput.errorString());
+            return false;
+        }
+
+        QByteArray header(INDEX_MAGIC);
+        header.resize(INDEX_HEADER_SIZE);
+        qToBigEndian<quint32>(INDEX_VERSION, header.data() + INDEX_MAGIC.size());
+        qToBigEndian<quint32>(0, header.data() + INDEX_MAGIC.size() + sizeof(quint32));
+        if (indexOutput.write(header) != header.size()) {
+            *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
+            return false;
+        }
+
+        char line[MAX_LINE_LENGTH];
+        char previous[SHA1_BYTES] = {};
+        char record[INDEX_RECORD_SIZE];
+        int count = 0;
+        for (quint64 lineNum = 1;; ++lineNum) {
+            const auto length = readHibpLine(hibpInput, line);
+            if (length == 0) {
+                return true;
+            } else if (length < 0 || !parseHibpLine(line, line + length, record, count)) {
+                *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
+                return false;
+            }
+
+            if (lineNum > 1 && std::memcmp(previous, record, SHA1_BYTES) >= 0) {
+                *error = QObject::tr("HIBP file, line %1: file is not sorted by hash").arg(lineNum);
+                return false;
+            }
+            std::memcpy(previous, record, SHA1_BYTES);
+
+            qToBigEndian<quint32>(count, record + SHA1_BYTES);
+            if (indexOutput.write(record, INDEX_RECORD_SIZE) != INDEX_RECORD_SIZE) {
+                *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
+                return false;
+            }
+        }
+    }
+
+    // okon exit codes, negative values mark lookups that did not run to completion
+    const int OKON_LEAKED = 1;
+    const int OKON_DATABASE_ERROR = 2;
+    const int OKON_START_FAILED = -1;
+    const int OKON_NOT_FINISHED = -2;
+    const int OKON_SKIPPED = -3;
+
+    struct OkonLookup
+    {
+        QByteArray sha1;
+        int exitCode = OKON_SKIPPED;
+    };
+
+#ifdef HAVE_OKON
+    /**
+     * Search the okon file in-process, the library returns the same codes as okon-cli.
+     */
+    void okonLookupAll(QVector<OkonLookup>& lookups, const QString& okonDatabase)
+    {
+        const auto path = QFile::encodeName(okonDatabase);
+        for (auto& lookup : lookups) {
+            const int result = okon_exists_binary(lookup.sha1.constData(), path.constData());
+            lookup.exitCode = (result == 0 || result == OKON_LEAKED) ? result : OKON_DATABASE_ERROR;
+            if (lookup.exitCode == OKON_DATABASE_ERROR) {
+                return;
+            }
+        }
+    }
+#else
+    int okonLookup(const QString& okon, const QString& okonDatabase, const QByteArray& sha1)
+    {
+        QProcess okonProcess;
+        okonProcess.start(okon, {"--path", okonDatabase, "--hash", QString::fromLatin1(sha1.toHex())});
+        if (!okonProcess.waitForStarted()) {
+            return OKON_START_FAILED;
+        }
+
+        if (!okonProcess.waitForFinished()) {
+            okonProcess.kill();
+            okonProcess.waitForFinished();
+            return OKON_NOT_FINISHED;
+        }
+
+        return okonProcess.exitCode();
+    }
+
+    /**
+     * Start okon-cli for every hash, it only accepts a single hash per invocation.
+     * The processes run concurrently on the global thread pool.
+     */
+    void okonLookupAll(QVector<OkonLookup>& lookups, const QString& okon, const QString& okonDatabase)
+    {
+        std::atomic<bool> failed(false);
+        QtConcurrent::blockingMap(lookups, [&](OkonLookup& lookup) {
+            // Stop starting new processes once one of them failed
+            if (!failed) {
+                lookup.exitCode = okonLookup(okon, okonDatabase, lookup.sha1);
+                if (lookup.exitCode < 0 || lookup.exitCode == OKON_DATABASE_ERROR) {
+                    failed = true;
+                }
+            }
+        });
+    }
+#endif
+
+    /**
+     * Check every vault password against an okon file.
+     *
+     * Every distinct password is looked up once. When built with the okon
+     * library the file is searched in-process and okon-cli is not needed,
+     * otherwise one okon-cli process is started per distinct password.
+     * Findings are reported in the order of the entries.
+     */
     bool okonReport(QSharedPointer<Database> db,
                     const QString& okon,
                     const QString& okonDatabase,
@@ -117,30 +505,45 @@ namespace HibpOffline
             return false;
         }
 
-        QProcess okonProcess;
-
-        for (const auto* entry : db->rootGroup()->entriesRecursive()) {
-            if (!entry->isRecycled()) {
+        QList<QPair<const Entry*, int>> entries;
+        QHash<QByteArray, int> lookupIndex;
+        QVector<OkonLookup> lookups;
+        db->rootGroup()->forEachEntry(
+            [&](const Entry* entry) {
                 const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
-                okonProcess.start(okon, {"--path", okonDatabase, "--hash", QString::fromLatin1(sha1.toHex())});
-                if (!okonProcess.waitForStarted()) {
-                    *error = QObject::tr("Could not start okon process: %1").arg(okon);
-                    return false;
+                auto it = lookupIndex.constFind(sha1);
+                if (it == lookupIndex.constEnd()) {
+                    it = lookupIndex.insert(sha1, lookups.size());
+                    lookups.append({sha1});
                 }
+                entries.append({entry, it.value()});
+            },
+            Group::SkipRecycled);
 
-                if (!okonProcess.waitForFinished()) {
-                    *error = QObject::tr("Error: okon process did not finish");
-                    return false;
-                }
+#ifdef HAVE_OKON
+        Q_UNUSED(okon);
+        okonLookupAll(lookups, okonDatabase);
+#else
+        okonLookupAll(lookups, okon, okonDatabase);
+#endif
 
-                switch (okonProcess.exitCode()) {
-                case 1:
-                    findings.append({entry, -1});
-                    break;
-                case 2:
-                    *error = QObject::tr("Failed to load okon processed database: %1").arg(okonDatabase);
-                    return false;
-                }
+        for (const auto& lookup : asConst(lookups)) {
+            switch (lookup.exitCode) {
+            case OKON_START_FAILED:
+                *error = QObject::tr("Could not start okon process: %1").arg(okon);
+                return false;
+            case OKON_NOT_FINISHED:
+                *error = QObject::tr("Error: okon process did not finish");
+                return false;
+            case OKON_DATABASE_ERROR:
+                *error = QObject::tr("Failed to load okon processed database: %1").arg(okonDatabase);
+                return false;
+            }
+        }
+
+        for (const auto& entry : asConst(entries)) {
+            if (lookups.at(entry.second).exitCode == OKON_LEAKED) {
+                findings.append({entry.first, -1});
             }
         }
 
@@ -32,6 +32,8 @@ namespace HibpOffline
                 QList<QPair<const Entry*, int>>& findings,
                 QString* error);
 
+    bool buildIndex(QIODevice& hibpInput, QIODevice& indexOutput, QString* error);
+
     bool okonReport(QSharedPointer<Database> db,
                     const QString& okon,
                     const QString& okonDatabase,
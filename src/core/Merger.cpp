@@ -312,7 +312,6 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
 {
     Q_UNUSED(mergeMethod);
     const auto targetHistoryItems = targetEntry->historyItems();
-    const auto sourceHistoryItems = sourceEntry->historyItems();
     const int comparison = compare(sourceEntry->timeInfo().lastModificationTime(),
                                    targetEntry->timeInfo().lastModificationTime(),
                                    CompareItemIgnoreMilliseconds);
@@ -332,7 +331,8 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
         }
         merged[modificationTime] = historyItem->clone(Entry::CloneNoFlags);
     }
-    for (Entry* historyItem : sourceHistoryItems) {
+    // The source history is only read, so compact history does not need to be materialized
+    sourceEntry->forEachHistoryItem([&](const Entry* historyItem) {
         // Items with same modification-time changes will be regarded as same (like KeePass2)
         const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
         if (merged.contains(modificationTime)
@@ -350,7 +350,8 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
         if (!merged.contains(modificationTime)) {
             merged[modificationTime] = historyItem->clone(Entry::CloneNoFlags);
         }
-    }
+        return true;
+    });
 
     const QDateTime targetModificationTime = Clock::serialized(targetEntry->timeInfo().lastModificationTime());
     const QDateTime sourceModificationTime = Clock::serialized(sourceEntry->timeInfo().lastModificationTime());
@@ -485,7 +486,7 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
             // keep deleted group since it was changed after deletion date
             continue;
         }
-        if (!group->entriesRecursive(false).isEmpty() || !group->groupsRecursive(false).isEmpty()) {
+        if (!group->isEmpty()) {
             // keep deleted group since it contains undeleted content
             continue;
         }
@@ -80,6 +80,7 @@ void Metadata::clear()
     m_customIconsOrder.clear();
     m_customIconsHashes.clear();
     m_customData->clear();
+    emit customIconsCleared();
 }
 
 template <class P, class V> bool Metadata::set(P& property, const V& value)
@@ -117,6 +118,28 @@ void Metadata::copyAttributesFrom(const Metadata* other)
     m_data = other->m_data;
 }
 
+void Metadata::copyFrom(const Metadata* other, Group* rootGroup)
+{
+    auto findGroup = [rootGroup](const Group* group) -> Group* {
+        return group && rootGroup ? rootGroup->findGroupByUuid(group->uuid()) : nullptr;
+    };
+
+    m_data = other->m_data;
+    m_customIconsOrder = other->m_customIconsOrder;
+    m_customIcons = other->m_customIcons;
+    m_customIconsHashes = other->m_customIconsHashes;
+    m_recycleBin = findGroup(other->m_recycleBin);
+    m_recycleBinChanged = other->m_recycleBinChanged;
+    m_entryTemplatesGroup = findGroup(other->m_entryTemplatesGroup);
+    m_entryTemplatesGroupChanged = other->m_entryTemplatesGroupChanged;
+    m_lastSelectedGroup = findGroup(other->m_lastSelectedGroup);
+    m_lastTopVisibleGroup = findGroup(other->m_lastTopVisibleGroup);
+    m_masterKeyChanged = other->m_masterKeyChanged;
+    m_settingsChanged = other->m_settingsChanged;
+    m_customData->copyDataFrom(other->m_customData, true);
+    emit customIconsCleared();
+}
+
 QString Metadata::generator() const
 {
     return m_data.generator;
@@ -384,6 +407,7 @@ void Metadata::addCustomIcon(const QUuid& uuid, const CustomIconData& iconData)
     m_customIconsHashes[hash] = uuid;
     Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
 
+    emit customIconChanged(uuid);
     emitModified();
 }
 
@@ -410,6 +434,7 @@ void Metadata::removeCustomIcon(const QUuid& uuid)
     m_customIconsOrder.removeAll(uuid);
     Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
     dynamic_cast<Database*>(parent())->addDeletedObject(uuid);
+    emit customIconChanged(uuid);
     emitModified();
 }
 
@@ -166,6 +166,15 @@ public:
      * - Settings changed date
      */
     void copyAttributesFrom(const Metadata* other);
+    /*
+     * Copy everything from other, group pointers are resolved
+     * by uuid below rootGroup
+     */
+    void copyFrom(const Metadata* other, Group* rootGroup);
+
+signals:
+    void customIconChanged(const QUuid& uuid);
+    void customIconsCleared();
 
 private:
     template <class P, class V> bool set(P& property, const V& value);
@@ -15,7 +15,9 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QCryptographicHash>
 #include <QString>
+#include <QtConcurrent>
 
 #include "Clock.h"
 #include "Group.h"
@@ -33,6 +35,11 @@ PasswordHealth::PasswordHealth(double entropy)
 }
 
 PasswordHealth::PasswordHealth(const QString& pwd)
+{
+    init(estimateEntropy(pwd));
+}
+
+double PasswordHealth::estimateEntropy(const QString& pwd)
 {
     auto entropy = 0.0;
     entropy += ZxcvbnMatch(pwd.left(ZXCVBN_ESTIMATE_THRESHOLD).toUtf8(), nullptr, nullptr);
@@ -41,7 +48,7 @@ PasswordHealth::PasswordHealth(const QString& pwd)
         auto average = entropy / ZXCVBN_ESTIMATE_THRESHOLD;
         entropy += average * (pwd.length() - ZXCVBN_ESTIMATE_THRESHOLD);
     }
-    init(entropy);
+    return entropy;
 }
 
 void PasswordHealth::init(double entropy)
@@ -110,19 +117,72 @@ PasswordHealth::Quality PasswordHealth::quality() const
     return Quality::Excellent;
 }
 
+/**
+ * Get the entropy of a password, estimating it only if it is not cached yet.
+ */
+double PasswordHealthCache::entropy(const QString& pwd)
+{
+    const auto key = fingerprint(pwd);
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_entropy.constFind(key);
+        if (it != m_entropy.constEnd()) {
+            return it.value();
+        }
+    }
+
+    const auto entropy = PasswordHealth::estimateEntropy(pwd);
+
+    QMutexLocker locker(&m_mutex);
+    m_entropy.insert(key, entropy);
+    return entropy;
+}
+
+/**
+ * Estimate the entropy of all passwords that are not cached yet, concurrently.
+ */
+void PasswordHealthCache::estimate(const QStringList& passwords)
+{
+    QStringList missing;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const auto& pwd : passwords) {
+            if (!m_entropy.contains(fingerprint(pwd))) {
+                missing << pwd;
+            }
+        }
+    }
+
+    missing.removeDuplicates();
+    QtConcurrent::blockingMap(missing, [this](const QString& pwd) { entropy(pwd); });
+}
+
+void PasswordHealthCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entropy.clear();
+}
+
+QByteArray PasswordHealthCache::fingerprint(const QString& pwd)
+{
+    return QCryptographicHash::hash(pwd.toUtf8(), QCryptographicHash::Sha256);
+}
+
 /**
  * This class provides additional information about password health
  * than can be derived from the password itself (re-use, expiry).
  */
 HealthChecker::HealthChecker(QSharedPointer<Database> db)
+    : m_db(std::move(db))
 {
     // Build the cache of re-used passwords
-    for (const auto* entry : db->rootGroup()->entriesRecursive()) {
-        if (!entry->isRecycled() && !entry->isAttributeReference("Password")) {
-            m_reuse[entry->password()]
-                << QObject::tr("Used in %1/%2").arg(entry->group()->hierarchy().join('/'), entry->title());
-        }
-    }
+    m_db->rootGroup()->forEachEntry(
+        [this](const Entry* entry) {
+            if (!entry->isAttributeReference("Password")) {
+                m_reuse[entry->password()] << entry;
+            }
+        },
+        Group::SkipRecycled);
 }
 
 /**
@@ -140,7 +200,7 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
 
     // First analyse the password itself
     const auto pwd = entry->password();
-    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(pwd));
+    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(m_db->passwordHealthCache()->entropy(pwd)));
 
     // Second, if the password is in the database more than once,
     // reduce the score accordingly
@@ -152,7 +212,8 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
         health->addScoreReason(QObject::tr("Password is used %1 time(s)", "", count).arg(QString::number(count)));
         // Add the first 20 uses of the password to prevent the details display from growing too large
         for (int i = 0; i < used.size(); ++i) {
-            health->addScoreDetails(used[i]);
+            health->addScoreDetails(
+                QObject::tr("Used in %1/%2").arg(used[i]->group()->hierarchy().join('/'), used[i]->title()));
             if (i == 19) {
                 health->addScoreDetails("…");
                 break;
@@ -202,3 +263,20 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
     // Return the result
     return health;
 }
+
+QList<QSharedPointer<PasswordHealth>> HealthChecker::evaluate(const QList<const Entry*>& entries) const
+{
+    QStringList passwords;
+    passwords.reserve(entries.size());
+    for (const auto* entry : entries) {
+        passwords << entry->password();
+    }
+    m_db->passwordHealthCache()->estimate(passwords);
+
+    QList<QSharedPointer<PasswordHealth>> results;
+    results.reserve(entries.size());
+    for (const auto* entry : entries) {
+        results << evaluate(entry);
+    }
+    return results;
+}
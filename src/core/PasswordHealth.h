@@ -19,6 +19,7 @@
 #define KEEPASSX_PASSWORDHEALTH_H
 
 #include <QHash>
+#include <QMutex>
 #include <QSharedPointer>
 
 class Database;
@@ -37,6 +38,8 @@ public:
 
     void init(double entropy);
 
+    static double estimateEntropy(const QString& pwd);
+
     /*
      * The password score is defined to be the greater the better
      * (more secure) the password is. It doesn't have a dimension,
@@ -97,6 +100,27 @@ private:
     QStringList m_scoreDetails;
 };
 
+/**
+ * Entropy estimates of the passwords of a database, keyed by a fingerprint
+ * of the password so that only new or changed passwords have to be scored.
+ * The cache is owned by the database and cleared when its data is released.
+ *
+ * @see Database::passwordHealthCache()
+ */
+class PasswordHealthCache
+{
+public:
+    double entropy(const QString& pwd);
+    void estimate(const QStringList& passwords);
+    void clear();
+
+private:
+    static QByteArray fingerprint(const QString& pwd);
+
+    QMutex m_mutex;
+    QHash<QByteArray, double> m_entropy;
+};
+
 /**
  * Password health check for all entries of a database.
  *
@@ -109,10 +133,13 @@ public:
 
     // Get the health status of an entry in the database
     QSharedPointer<PasswordHealth> evaluate(const Entry* entry) const;
+    // Get the health status of several entries, new passwords are scored concurrently
+    QList<QSharedPointer<PasswordHealth>> evaluate(const QList<const Entry*>& entries) const;
 
 private:
+    QSharedPointer<Database> m_db;
     // To determine password re-use: first = password, second = entries that use it
-    QHash<QString, QStringList> m_reuse;
+    QHash<QString, QList<const Entry*>> m_reuse;
 };
 
 #endif // KEEPASSX_PASSWORDHEALTH_H
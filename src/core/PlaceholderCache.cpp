@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PlaceholderCache.h"
+
+#include "core/Database.h"
+#include "core/Entry.h"
+
+#include <QRegularExpression>
+
+namespace
+{
+    // Same limit as the recursive placeholder resolution in Entry
+    const int MaximumDepth = 10;
+
+    QString referencedAttributeKey(const QString& wantedField)
+    {
+        const auto field = wantedField.toLower();
+        if (field == QLatin1String("t")) {
+            return EntryAttributes::TitleKey;
+        } else if (field == QLatin1String("u")) {
+            return EntryAttributes::UserNameKey;
+        } else if (field == QLatin1String("p")) {
+            return EntryAttributes::PasswordKey;
+        } else if (field == QLatin1String("a")) {
+            return EntryAttributes::URLKey;
+        } else if (field == QLatin1String("n")) {
+            return EntryAttributes::NotesKey;
+        }
+        return {};
+    }
+} // namespace
+
+PlaceholderCache::PlaceholderCache(Database* db)
+    : QObject(db)
+{
+    connect(db, &Database::entryModified, this, &PlaceholderCache::invalidateEntry);
+    connect(db, &Database::entryAdded, this, &PlaceholderCache::invalidateEntry);
+    connect(db, &Database::entryRemoved, this, &PlaceholderCache::invalidateEntry);
+    connect(db, &Database::groupAboutToAdd, this, &PlaceholderCache::clear);
+    connect(db, &Database::groupAboutToRemove, this, &PlaceholderCache::clear);
+}
+
+/**
+ * Resolve all placeholders in an attribute of the given entry.
+ *
+ * @param entry entry that is part of the database owning this cache
+ * @param key attribute key
+ * @return resolved attribute value
+ */
+QString PlaceholderCache::resolve(const Entry* entry, const QString& key)
+{
+    const auto uuid = entry->uuid();
+    quint64 generation;
+    {
+        QReadLocker locker(&m_lock);
+        generation = m_generation;
+        const auto it = m_values.constFind(uuid);
+        if (it != m_values.constEnd()) {
+            const auto valueIt = it->constFind(key);
+            if (valueIt != it->constEnd()) {
+                return valueIt.value();
+            }
+        }
+    }
+
+    const auto value = entry->attributes()->value(key);
+    const auto resolved = entry->resolveMultiplePlaceholders(value);
+
+    QSet<QUuid> dependencies;
+    if (uuid.isNull() || !collectDependencies(entry, value, dependencies, 0)) {
+        return resolved;
+    }
+
+    QWriteLocker locker(&m_lock);
+    // The value was resolved without holding the lock, it may already be stale
+    if (generation != m_generation) {
+        return resolved;
+    }
+    m_values[uuid].insert(key, resolved);
+    for (const auto& dependency : asConst(dependencies)) {
+        if (dependency.isNull()) {
+            m_globalDependents.insert(uuid);
+        } else if (dependency != uuid) {
+            m_dependents[dependency].insert(uuid);
+        }
+    }
+
+    return resolved;
+}
+
+void PlaceholderCache::clear()
+{
+    QWriteLocker locker(&m_lock);
+    ++m_generation;
+    m_values.clear();
+    m_dependents.clear();
+    m_globalDependents.clear();
+}
+
+void PlaceholderCache::invalidateEntry(Entry* entry)
+{
+    QWriteLocker locker(&m_lock);
+    ++m_generation;
+    if (m_values.isEmpty()) {
+        return;
+    }
+
+    // References searched by value may resolve to a different entry now
+    auto stale = m_globalDependents;
+    m_globalDependents.clear();
+
+    // Dependencies are collected transitively, so the direct dependents are all we need
+    stale.insert(entry->uuid());
+    stale.unite(m_dependents.take(entry->uuid()));
+
+    for (const auto& uuid : asConst(stale)) {
+        m_values.remove(uuid);
+    }
+}
+
+/**
+ * Collect the entries the resolved value depends on, following references and
+ * field placeholders the same way Entry resolves them. A null uuid marks a
+ * dependency on a reference that is searched by value.
+ *
+ * @return false if the value must not be cached
+ */
+bool PlaceholderCache::collectDependencies(const Entry* entry,
+                                           const QString& value,
+                                           QSet<QUuid>& dependencies,
+                                           int depth)
+{
+    static const QRegularExpression placeholderRegEx(R"(\{[^}]+\})");
+
+    if (depth >= MaximumDepth) {
+        return false;
+    }
+
+    auto matches = placeholderRegEx.globalMatch(value);
+    while (matches.hasNext()) {
+        const auto placeholder = matches.next().captured();
+
+        QString fieldKey;
+        switch (entry->placeholderType(placeholder)) {
+        case Entry::PlaceholderType::Title:
+            fieldKey = EntryAttributes::TitleKey;
+            break;
+        case Entry::PlaceholderType::UserName:
+            fieldKey = EntryAttributes::UserNameKey;
+            break;
+        case Entry::PlaceholderType::Password:
+            fieldKey = EntryAttributes::PasswordKey;
+            break;
+        case Entry::PlaceholderType::Notes:
+            fieldKey = EntryAttributes::NotesKey;
+            break;
+        case Entry::PlaceholderType::Url:
+        case Entry::PlaceholderType::UrlWithoutScheme:
+        case Entry::PlaceholderType::UrlScheme:
+        case Entry::PlaceholderType::UrlHost:
+        case Entry::PlaceholderType::UrlPort:
+        case Entry::PlaceholderType::UrlPath:
+        case Entry::PlaceholderType::UrlQuery:
+        case Entry::PlaceholderType::UrlFragment:
+        case Entry::PlaceholderType::UrlUserInfo:
+        case Entry::PlaceholderType::UrlUserName:
+        case Entry::PlaceholderType::UrlPassword:
+            fieldKey = EntryAttributes::URLKey;
+            break;
+        case Entry::PlaceholderType::CustomAttribute:
+            // Custom attribute values are inserted as they are
+            break;
+        case Entry::PlaceholderType::Reference: {
+            const auto match = EntryAttributes::matchReference(placeholder);
+            if (!match.hasMatch()) {
+                break;
+            }
+
+            const auto searchIn = match.captured(EntryAttributes::SearchInGroupName);
+            if (searchIn.compare(QLatin1String("I"), Qt::CaseInsensitive) == 0) {
+                const auto searchText = match.captured(EntryAttributes::SearchTextGroupName);
+                dependencies.insert(QUuid::fromRfc4122(QByteArray::fromHex(searchText.toLatin1())));
+            } else {
+                dependencies.insert(QUuid());
+            }
+
+            const auto target = entry->resolveReference(placeholder);
+            if (target) {
+                dependencies.insert(target->uuid());
+                const auto targetKey = referencedAttributeKey(match.captured(EntryAttributes::WantedFieldGroupName));
+                if (!targetKey.isEmpty()
+                    && !collectDependencies(target, target->attributes()->value(targetKey), dependencies, depth + 1)) {
+                    return false;
+                }
+            }
+            break;
+        }
+        default:
+            // Time dependent, location dependent or unknown placeholders
+            return false;
+        }
+
+        if (!fieldKey.isEmpty()
+            && !collectDependencies(entry, entry->attributes()->value(fieldKey), dependencies, depth + 1)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_PLACEHOLDERCACHE_H
+#define KEEPASSXC_PLACEHOLDERCACHE_H
+
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QUuid>
+
+class Database;
+class Entry;
+
+/**
+ * Memoized placeholder resolution for the attributes of all entries in a database.
+ *
+ * Cached values are keyed by entry UUID and attribute key. While caching a value
+ * the references it follows are recorded, so a change to an entry only drops the
+ * values of that entry and of the entries that reference it. References that
+ * search by field value instead of UUID may resolve to a different entry after
+ * any change, values depending on them are dropped on every change.
+ *
+ * Values containing time dependent placeholders (date/time, TOTP) or placeholders
+ * depending on the database file location are never cached.
+ *
+ * Lookups are thread-safe so parallel searches can share the cache. Values are
+ * resolved without holding the lock, a value is only cached if the cache was not
+ * invalidated in the meantime.
+ */
+class PlaceholderCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PlaceholderCache(Database* db);
+
+    QString resolve(const Entry* entry, const QString& key);
+    void clear();
+
+private slots:
+    void invalidateEntry(Entry* entry);
+
+private:
+    bool collectDependencies(const Entry* entry, const QString& value, QSet<QUuid>& dependencies, int depth);
+
+    QReadWriteLock m_lock;
+    // bumped on every invalidation, values resolved across a change are not cached
+    quint64 m_generation = 0;
+    // entry uuid -> attribute key -> resolved value
+    QHash<QUuid, QHash<QString, QString>> m_values;
+    // entry uuid -> entries with cached values that depend on it
+    QHash<QUuid, QSet<QUuid>> m_dependents;
+    // entries with cached values that depend on references searched by value
+    QSet<QUuid> m_globalDependents;
+};
+
+#endif // KEEPASSXC_PLACEHOLDERCACHE_H
@@ -31,6 +31,7 @@
 #include <QCoreApplication>
 #include <QElapsedTimer>
 #include <QEventLoop>
+#include <QFile>
 #include <QFileInfo>
 #include <QIODevice>
 #include <QLocale>
@@ -42,7 +43,11 @@
 #include <cmath>
 
 #ifdef Q_OS_WIN
-#include <windows.h> // for Sleep()
+#include <windows.h> // for Sleep() and GlobalMemoryStatusEx()
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
 #endif
 
 namespace Tools
@@ -278,6 +283,58 @@ namespace Tools
         }
     }
 
+    /**
+     * Physical memory that can be allocated without swapping, including memory
+     * the system would reclaim from caches.
+     *
+     * @return available memory in bytes, 0 if it cannot be determined
+     */
+    quint64 availableMemory()
+    {
+#ifdef Q_OS_WIN
+        MEMORYSTATUSEX status;
+        status.dwLength = sizeof(status);
+        if (GlobalMemoryStatusEx(&status)) {
+            return status.ullAvailPhys;
+        }
+        return 0;
+#elif defined(Q_OS_MACOS)
+        vm_statistics64_data_t stats;
+        mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+        if (host_statistics64(mach_host_self(), HOST_VM_INFO64, reinterpret_cast<host_info64_t>(&stats), &count)
+            == KERN_SUCCESS) {
+            return (static_cast<quint64>(stats.free_count) + stats.inactive_count) * vm_kernel_page_size;
+        }
+        return 0;
+#else
+#ifdef Q_OS_LINUX
+        // The free pages exclude the page cache, MemAvailable estimates what is reclaimable
+        QFile meminfo("/proc/meminfo");
+        if (meminfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            const auto lines = meminfo.readAll().split('\n');
+            for (const auto& line : lines) {
+                if (line.startsWith("MemAvailable:")) {
+                    bool ok;
+                    const auto kib = line.mid(13).replace("kB", "").trimmed().toULongLong(&ok);
+                    if (ok) {
+                        return kib * 1024;
+                    }
+                    break;
+                }
+            }
+        }
+#endif
+#ifdef _SC_AVPHYS_PAGES
+        const long pages = sysconf(_SC_AVPHYS_PAGES);
+        const long pageSize = sysconf(_SC_PAGE_SIZE);
+        if (pages > 0 && pageSize > 0) {
+            return static_cast<quint64>(pages) * static_cast<quint64>(pageSize);
+        }
+#endif
+        return 0;
+#endif
+    }
+
     /****************************************************************************
      *
      * Copyright (C) 2020 Giuseppe D'Angelo <dangelog@gmail.com>.
@@ -41,6 +41,7 @@ namespace Tools
     bool isAsciiString(const QString& str);
     void sleep(int ms);
     void wait(int ms);
+    quint64 availableMemory();
     QString uuidToHex(const QUuid& uuid);
     QUuid hexToUuid(const QString& uuid);
     bool isValidUuid(const QString& uuidStr);
@@ -0,0 +1,223 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UuidIndex.h"
+
+#include "core/Database.h"
+#include "core/Group.h"
+
+UuidIndex::UuidIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+{
+    connect(db, &Database::entryAdded, this, &UuidIndex::addEntry);
+    connect(db, &Database::entryRemoved, this, &UuidIndex::removeEntry);
+    connect(db, &Database::entryModified, this, &UuidIndex::updateEntry);
+    connect(db, &Database::groupAboutToAdd, this, &UuidIndex::addGroup);
+    connect(db, &Database::groupAboutToRemove, this, &UuidIndex::removeGroup);
+    connect(db, &Database::groupDataChanged, this, &UuidIndex::updateGroup);
+}
+
+/**
+ * Find the entry with the given uuid.
+ *
+ * @param uuid entry uuid
+ * @param ok set to false if the index cannot answer, e.g. for duplicate uuids
+ * @return the entry or nullptr if there is none or ok is false
+ */
+Entry* UuidIndex::entry(const QUuid& uuid, bool* ok)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_built) {
+        build();
+    }
+    return lookup(m_entries, uuid, ok);
+}
+
+/**
+ * Find the group with the given uuid.
+ *
+ * @param uuid group uuid
+ * @param ok set to false if the index cannot answer, e.g. for duplicate uuids
+ * @return the group or nullptr if there is none or ok is false
+ */
+Group* UuidIndex::group(const QUuid& uuid, bool* ok)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_built) {
+        build();
+    }
+    return lookup(m_groups, uuid, ok);
+}
+
+/**
+ * Drop the index, it will be rebuilt from the database on next use.
+ */
+void UuidIndex::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_groups.clear();
+    m_entryUuids.clear();
+    m_groupUuids.clear();
+    m_built = false;
+}
+
+void UuidIndex::addEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_built) {
+        insertEntry(entry);
+    }
+}
+
+void UuidIndex::removeEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_built) {
+        eraseEntry(entry);
+    }
+}
+
+void UuidIndex::updateEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_built && m_entryUuids.value(entry) != entry->uuid()) {
+        eraseEntry(entry);
+        insertEntry(entry);
+    }
+}
+
+void UuidIndex::addGroup(Group* group)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_built) {
+        return;
+    }
+
+    group->forEachGroup([this](Group* child) {
+        insertGroup(child);
+        for (auto entry : child->entries()) {
+            insertEntry(entry);
+        }
+    });
+}
+
+void UuidIndex::removeGroup(Group* group)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_built) {
+        return;
+    }
+
+    group->forEachGroup([this](Group* child) {
+        eraseGroup(child);
+        for (auto entry : child->entries()) {
+            eraseEntry(entry);
+        }
+    });
+}
+
+void UuidIndex::updateGroup(Group* group)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_built && m_groupUuids.value(group) != group->uuid()) {
+        eraseGroup(group);
+        insertGroup(group);
+    }
+}
+
+void UuidIndex::build()
+{
+    m_entries.clear();
+    m_groups.clear();
+    m_entryUuids.clear();
+    m_groupUuids.clear();
+
+    if (m_db->rootGroup()) {
+        m_db->rootGroup()->forEachGroup([this](Group* group) {
+            insertGroup(group);
+            for (auto entry : group->entries()) {
+                insertEntry(entry);
+            }
+        });
+    }
+
+    m_built = true;
+}
+
+void UuidIndex::insertEntry(Entry* entry)
+{
+    if (m_entryUuids.contains(entry)) {
+        return;
+    }
+
+    const auto uuid = entry->uuid();
+    m_entries.insert(uuid, entry);
+    m_entryUuids.insert(entry, uuid);
+}
+
+void UuidIndex::eraseEntry(Entry* entry)
+{
+    const auto it = m_entryUuids.find(entry);
+    if (it != m_entryUuids.end()) {
+        m_entries.remove(it.value(), entry);
+        m_entryUuids.erase(it);
+    }
+}
+
+void UuidIndex::insertGroup(Group* group)
+{
+    if (m_groupUuids.contains(group)) {
+        return;
+    }
+
+    const auto uuid = group->uuid();
+    m_groups.insert(uuid, group);
+    m_groupUuids.insert(group, uuid);
+}
+
+void UuidIndex::eraseGroup(Group* group)
+{
+    const auto it = m_groupUuids.find(group);
+    if (it != m_groupUuids.end()) {
+        m_groups.remove(it.value(), group);
+        m_groupUuids.erase(it);
+    }
+}
+
+template <class T> T* UuidIndex::lookup(const QMultiHash<QUuid, T*>& hash, const QUuid& uuid, bool* ok)
+{
+    if (ok) {
+        *ok = true;
+    }
+
+    auto it = hash.constFind(uuid);
+    if (it == hash.constEnd()) {
+        return nullptr;
+    }
+
+    T* object = it.value();
+    // Duplicate uuids, or a uuid changed without a modified signal (e.g. while loading)
+    if ((++it != hash.constEnd() && it.key() == uuid) || object->uuid() != uuid) {
+        if (ok) {
+            *ok = false;
+        }
+        return nullptr;
+    }
+    return object;
+}
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_UUIDINDEX_H
+#define KEEPASSXC_UUIDINDEX_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QUuid>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Maps the UUIDs of all groups and entries in a database to the objects.
+ *
+ * The index is built on first use and then kept up to date from the entry and
+ * group signals of the database. History items are not indexed.
+ *
+ * Databases may contain duplicate UUIDs, in that case the lookup reports that
+ * it cannot answer so callers can fall back to searching the tree in order.
+ *
+ * Lookups are thread-safe so they can be used while resolving references
+ * during a parallel search.
+ */
+class UuidIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UuidIndex(Database* db);
+
+    Entry* entry(const QUuid& uuid, bool* ok = nullptr);
+    Group* group(const QUuid& uuid, bool* ok = nullptr);
+    void invalidate();
+
+private slots:
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+    void updateEntry(Entry* entry);
+    void addGroup(Group* group);
+    void removeGroup(Group* group);
+    void updateGroup(Group* group);
+
+private:
+    void build();
+    void insertEntry(Entry* entry);
+    void eraseEntry(Entry* entry);
+    void insertGroup(Group* group);
+    void eraseGroup(Group* group);
+
+    template <class T> static T* lookup(const QMultiHash<QUuid, T*>& hash, const QUuid& uuid, bool* ok);
+
+    Database* m_db;
+    QMutex m_mutex;
+    bool m_built = false;
+    QMultiHash<QUuid, Entry*> m_entries;
+    QMultiHash<QUuid, Group*> m_groups;
+    // Objects are removed by the uuid they were indexed with, it may have changed since
+    QHash<const Entry*, QUuid> m_entryUuids;
+    QHash<const Group*, QUuid> m_groupUuids;
+};
+
+#endif // KEEPASSXC_UUIDINDEX_H
@@ -17,12 +17,21 @@
 
 #include "AesKdf.h"
 
+#include <QThread>
 #include <QtConcurrent>
 
 #include "crypto/CryptoHash.h"
 #include "crypto/SymmetricCipher.h"
+#include "crypto/kdf/KdfBenchmark.h"
 #include "format/KeePass2.h"
 
+namespace
+{
+    const int AesBlockSize = 16;
+    // Below this the thread hand-off costs more than it saves
+    const int ParallelRoundsThreshold = 10000;
+} // namespace
+
 AesKdf::AesKdf()
     : Kdf::Kdf(KeePass2::KDF_AES_KDBX4)
 {
@@ -71,8 +80,27 @@ bool AesKdf::transformKeyRaw(const QByteArray& key, const QByteArray& seed, int
         return false;
     }
 
-    auto out = key;
-    SymmetricCipher::aesKdf(seed, rounds, out);
+    // The key is encrypted in ECB mode, so both blocks are transformed independently of each other
+    QByteArray out;
+    if (key.size() == 2 * AesBlockSize && rounds >= ParallelRoundsThreshold && QThread::idealThreadCount() > 1) {
+        auto left = key.left(AesBlockSize);
+        auto right = key.mid(AesBlockSize);
+        // If the pool is busy, waiting for the future runs the task on this thread
+        auto future = QtConcurrent::run([&seed, rounds, &right] {
+            return SymmetricCipher::aesKdf(seed, rounds, right);
+        });
+        bool ok = SymmetricCipher::aesKdf(seed, rounds, left);
+        if (!future.result() || !ok) {
+            return false;
+        }
+        out = left + right;
+    } else {
+        out = key;
+        if (!SymmetricCipher::aesKdf(seed, rounds, out)) {
+            return false;
+        }
+    }
+
     *result = CryptoHash::hash(out, CryptoHash::Sha256);
     return true;
 }
@@ -84,22 +112,7 @@ QSharedPointer<Kdf> AesKdf::clone() const
 
 int AesKdf::benchmark(int msec) const
 {
-    QByteArray key(16, '\x7E');
-    QByteArray seed(32, '\x4B');
-
-    int trials = 3;
-    int rounds = 1000000;
-
-    QElapsedTimer timer;
-    timer.start();
-    for (int i = 0; i < trials; ++i) {
-        QByteArray result;
-        if (!transformKeyRaw(key, seed, rounds, &result)) {
-            return rounds;
-        }
-    }
-
-    return static_cast<int>(rounds * trials * static_cast<float>(msec) / timer.elapsed());
+    return KdfBenchmark::calibrate(*this, msec, static_cast<int>(KDF_DEFAULT_ROUNDS));
 }
 
 QString AesKdf::toString() const
@@ -17,11 +17,11 @@
 
 #include "Argon2Kdf.h"
 
-#include <QElapsedTimer>
 #include <QThread>
 
 #include <argon2.h>
 
+#include "crypto/kdf/KdfBenchmark.h"
 #include "format/KeePass2.h"
 
 /**
@@ -195,16 +195,7 @@ QSharedPointer<Kdf> Argon2Kdf::clone() const
 
 int Argon2Kdf::benchmark(int msec) const
 {
-    QByteArray key = QByteArray(16, '\x7E');
-
-    QElapsedTimer timer;
-    timer.start();
-
-    if (transform(key, key)) {
-        return static_cast<int>(rounds() * (static_cast<float>(msec) / timer.elapsed()));
-    }
-
-    return 1;
+    return KdfBenchmark::calibrate(*this, msec, 1);
 }
 
 QString Argon2Kdf::toString() const
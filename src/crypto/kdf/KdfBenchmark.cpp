@@ -0,0 +1,288 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KdfBenchmark.h"
+
+#include "core/Config.h"
+#include "core/Tools.h"
+#include "crypto/kdf/Argon2Kdf.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSysInfo>
+#include <QThread>
+
+#include <algorithm>
+
+namespace
+{
+    // Shorter transforms are dominated by timer resolution and scheduling noise
+    const qint64 MinSampleNs = 50 * 1000 * 1000;
+    // Leaves room for sampling at twice the rounds
+    const int MaxProbeRounds = 1 << 29;
+    const qint64 CacheExpirySecs = 30 * 24 * 60 * 60;
+    // Tuned Argon2 parameters stay within 64 MiB to 1 GiB and a quarter of the currently available memory
+    const quint64 MinTunedMemory = 1 << 16;
+    const quint64 MaxTunedMemory = 1 << 20;
+    const int AvailableMemoryShare = 4;
+    // Fewer passes over the memory weaken Argon2 more than the extra memory strengthens it
+    const int MinTunedRounds = 3;
+
+    qint64 timeTransform(const Kdf& kdf, bool* ok)
+    {
+        const QByteArray key(32, '\x7E');
+        QByteArray result;
+
+        QElapsedTimer timer;
+        timer.start();
+        *ok = *ok && kdf.transform(key, result);
+        return timer.nsecsElapsed();
+    }
+
+    qint64 medianTime(const Kdf& kdf, int samples, bool* ok)
+    {
+        QVector<qint64> times;
+        for (int i = 0; i < samples && *ok; ++i) {
+            times << timeTransform(kdf, ok);
+        }
+        if (!*ok || times.isEmpty()) {
+            *ok = false;
+            return 0;
+        }
+        std::sort(times.begin(), times.end());
+        return times.at(times.size() / 2);
+    }
+} // namespace
+
+bool KdfBenchmark::Result::isValid() const
+{
+    return roundNs > 0;
+}
+
+/**
+ * @param msec target duration of a transform
+ * @return number of rounds that take about the target duration
+ */
+int KdfBenchmark::Result::roundsFor(int msec) const
+{
+    const double rounds = (msec * 1e6 - overheadNs) / roundNs;
+    return static_cast<int>(qBound(1.0, rounds, static_cast<double>(INT_MAX - 1)));
+}
+
+/**
+ * @param rounds number of rounds
+ * @return expected duration of a transform in milliseconds
+ */
+int KdfBenchmark::Result::estimateMs(int rounds) const
+{
+    return qRound((overheadNs + roundNs * rounds) / 1e6);
+}
+
+/**
+ * Measure the cost of the KDF with its current parameters, rounds and seed are ignored.
+ *
+ * @param kdf key derivation function to measure
+ * @param samples number of samples to take the median of
+ * @param useCache if false, measure even if a result is cached
+ * @return measured cost, invalid if the transform failed
+ */
+KdfBenchmark::Result KdfBenchmark::measure(const Kdf& kdf, int samples, bool useCache)
+{
+    const auto key = cacheKey(kdf);
+    if (useCache) {
+        const auto cached = cachedResult(key);
+        if (cached.isValid()) {
+            return cached;
+        }
+    }
+
+    auto probe = kdf.clone();
+    bool ok = true;
+    int rounds = 1;
+    probe->setRounds(rounds);
+    auto elapsed = timeTransform(*probe, &ok);
+    while (ok && elapsed < MinSampleNs && rounds < MaxProbeRounds) {
+        // Aim a bit above the minimum, but grow at least twofold since the first runs are the least accurate
+        const auto factor = qBound<qint64>(2, MinSampleNs * 3 / 2 / qMax<qint64>(elapsed, 1), 1000);
+        rounds = static_cast<int>(qMin<qint64>(rounds * factor, MaxProbeRounds));
+        probe->setRounds(rounds);
+        elapsed = timeTransform(*probe, &ok);
+    }
+
+    samples = qMax(samples, 1);
+    const auto single = medianTime(*probe, samples, &ok);
+    probe->setRounds(rounds * 2);
+    const auto twice = medianTime(*probe, samples, &ok);
+    if (!ok) {
+        return {};
+    }
+
+    Result result;
+    if (twice > single) {
+        result.roundNs = static_cast<double>(twice - single) / rounds;
+        result.overheadNs = qMax(0.0, single - result.roundNs * rounds);
+    } else {
+        // Noise swamped the difference, assume the cost is linear in the rounds
+        result.roundNs = static_cast<double>(single) / rounds;
+    }
+
+    storeResult(key, result);
+    return result;
+}
+
+/**
+ * Determine the number of rounds for a target transform duration.
+ *
+ * @param kdf key derivation function to calibrate
+ * @param msec target duration
+ * @param fallbackRounds returned if the KDF cannot be measured
+ * @return number of rounds
+ */
+int KdfBenchmark::calibrate(const Kdf& kdf, int msec, int fallbackRounds)
+{
+    const auto result = measure(kdf);
+    return result.isValid() ? result.roundsFor(msec) : fallbackRounds;
+}
+
+/**
+ * Measure an Argon2 KDF for every combination of the given memory sizes and parallelism.
+ * Combinations the KDF does not accept are skipped.
+ *
+ * @param kdf KDF providing the remaining parameters
+ * @param memories memory sizes in KiB
+ * @param parallelisms numbers of lanes
+ * @param samples number of samples to take the median of
+ * @return measurements, ordered by memory first
+ */
+QList<KdfBenchmark::Argon2Point> KdfBenchmark::sweepArgon2(const Argon2Kdf& kdf,
+                                                           const QList<quint64>& memories,
+                                                           const QList<quint32>& parallelisms,
+                                                           int samples)
+{
+    QList<Argon2Point> points;
+    for (auto memory : memories) {
+        for (auto parallelism : parallelisms) {
+            auto probe = kdf.clone().staticCast<Argon2Kdf>();
+            if (!probe->setMemory(memory) || !probe->setParallelism(parallelism)) {
+                continue;
+            }
+            points.append({memory, parallelism, measure(*probe, samples, false)});
+        }
+    }
+    return points;
+}
+
+/**
+ * Choose Argon2 parameters for this computer: one lane per CPU thread and as much
+ * memory as possible while at least three rounds still fit into the target time.
+ *
+ * @param kdf KDF to change the parallelism, memory and rounds of
+ * @param msec target duration of a transform
+ * @return measurement for the chosen parameters, invalid if the KDF could not be measured
+ */
+KdfBenchmark::Result KdfBenchmark::tuneArgon2(Argon2Kdf& kdf, int msec)
+{
+    kdf.setParallelism(static_cast<quint32>(qMax(QThread::idealThreadCount(), 1)));
+
+    auto budget = MaxTunedMemory;
+    const auto availableMemory = Tools::availableMemory() / 1024;
+    if (availableMemory > 0) {
+        budget = qBound(MinTunedMemory, availableMemory / AvailableMemoryShare, MaxTunedMemory);
+    }
+
+    auto memory = MinTunedMemory;
+    kdf.setMemory(memory);
+    auto result = measure(kdf);
+    if (!result.isValid()) {
+        return {};
+    }
+
+    // Doubling the memory about halves the rounds that fit into the target time
+    while (memory * 2 <= budget && result.roundsFor(msec) >= 2 * MinTunedRounds) {
+        kdf.setMemory(memory * 2);
+        const auto doubled = measure(kdf);
+        if (!doubled.isValid() || doubled.roundsFor(msec) < MinTunedRounds) {
+            kdf.setMemory(memory);
+            break;
+        }
+        memory *= 2;
+        result = doubled;
+    }
+
+    kdf.setRounds(result.roundsFor(msec));
+    return result;
+}
+
+/**
+ * Forget all cached results, so the next measurement of every KDF runs again.
+ */
+void KdfBenchmark::clearCache()
+{
+    config()->remove(Config::KdfBenchmarkCache);
+}
+
+QString KdfBenchmark::cacheKey(const Kdf& kdf)
+{
+    QStringList parts = {QSysInfo::machineHostName(),
+                         QSysInfo::currentCpuArchitecture(),
+                         QString::number(QThread::idealThreadCount()),
+                         kdf.uuid().toString()};
+    if (const auto* argon2 = dynamic_cast<const Argon2Kdf*>(&kdf)) {
+        parts << QString::number(argon2->version(), 16) << QString::number(argon2->memory())
+              << QString::number(argon2->parallelism());
+    }
+    return parts.join('/');
+}
+
+KdfBenchmark::Result KdfBenchmark::cachedResult(const QString& key)
+{
+    const auto entry = config()->get(Config::KdfBenchmarkCache).toMap().value(key).toList();
+    if (entry.size() != 3 || QDateTime::currentSecsSinceEpoch() - entry.at(2).toLongLong() > CacheExpirySecs) {
+        return {};
+    }
+
+    Result result;
+    result.roundNs = entry.at(0).toDouble();
+    result.overheadNs = entry.at(1).toDouble();
+    return result;
+}
+
+void KdfBenchmark::storeResult(const QString& key, const Result& result)
+{
+    const auto now = QDateTime::currentSecsSinceEpoch();
+    const QVariantList entry = {result.roundNs, result.overheadNs, now};
+    auto store = [key, entry, now] {
+        auto cache = config()->get(Config::KdfBenchmarkCache).toMap();
+        for (auto it = cache.begin(); it != cache.end();) {
+            const auto cached = it.value().toList();
+            if (cached.size() != 3 || now - cached.at(2).toLongLong() > CacheExpirySecs) {
+                it = cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        cache.insert(key, entry);
+        config()->set(Config::KdfBenchmarkCache, cache);
+    };
+
+    // Benchmarks usually run on the thread pool, but the config must only be changed from its own thread
+    if (QThread::currentThread() == config()->thread()) {
+        store();
+    } else {
+        QMetaObject::invokeMethod(config(), store);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_KDFBENCHMARK_H
+#define KEEPASSXC_KDFBENCHMARK_H
+
+#include <QList>
+#include <QString>
+
+class Argon2Kdf;
+class Kdf;
+
+/**
+ * Measures how long a key derivation takes on this machine.
+ *
+ * The KDF is first run with a growing number of rounds until a single
+ * transform is long enough to be timed reliably, which also warms up caches
+ * and CPU clocks. The median of several samples at that number of rounds and
+ * at twice as many separates the cost per round from the fixed cost of every
+ * transform (e.g. allocating and filling Argon2 memory).
+ *
+ * Results are cached per host and KDF parameters (except rounds and seed) in
+ * the local configuration, so calibrating the same KDF again is immediate.
+ */
+class KdfBenchmark
+{
+public:
+    struct Result
+    {
+        double roundNs = 0;
+        double overheadNs = 0;
+
+        bool isValid() const;
+        int roundsFor(int msec) const;
+        int estimateMs(int rounds) const;
+    };
+
+    struct Argon2Point
+    {
+        quint64 memory;
+        quint32 parallelism;
+        Result result;
+    };
+
+    static Result measure(const Kdf& kdf, int samples = DefaultSamples, bool useCache = true);
+    static int calibrate(const Kdf& kdf, int msec, int fallbackRounds);
+    static QList<Argon2Point> sweepArgon2(const Argon2Kdf& kdf,
+                                          const QList<quint64>& memories,
+                                          const QList<quint32>& parallelisms,
+                                          int samples = DefaultSamples);
+    static Result tuneArgon2(Argon2Kdf& kdf, int msec);
+    static void clearCache();
+
+    static const int DefaultSamples = 3;
+
+private:
+    static QString cacheKey(const Kdf& kdf);
+    static Result cachedResult(const QString& key);
+    static void storeResult(const QString& key, const Result& result);
+};
+
+#endif // KEEPASSXC_KDFBENCHMARK_H
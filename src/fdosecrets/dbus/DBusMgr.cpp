@@ -405,18 +405,49 @@ namespace FdoSecrets
             .arg(otherService);
     }
 
-    bool DBusMgr::registerObject(const QString& path, DBusObject* obj, bool primary)
+    bool DBusMgr::registerObject(const QString& path,
+                                 DBusObject* obj,
+                                 bool primary,
+                                 QDBusConnection::VirtualObjectRegisterOption option)
     {
-        if (!m_conn.registerVirtualObject(path, this)) {
+        if (!m_conn.registerVirtualObject(path, this, option)) {
             qDebug() << "failed to register" << obj << "at" << path;
             return false;
         }
+        addObject(path, obj, primary);
+        return true;
+    }
+
+    void DBusMgr::addObject(const QString& path, DBusObject* obj, bool primary)
+    {
         connect(obj, &DBusObject::destroyed, this, &DBusMgr::unregisterObject);
         m_objects.insert(path, obj);
         if (primary) {
             obj->setObjectPath(path);
         }
-        return true;
+    }
+
+    /**
+     * Find the object at the path. Items are created by their collection
+     * the first time their path is used.
+     */
+    DBusObject* DBusMgr::findObject(const QString& path) const
+    {
+        auto obj = m_objects.value(path, nullptr);
+        if (obj) {
+            return obj;
+        }
+
+        auto parsed = parsePath(path);
+        if (parsed.type != PathType::Item) {
+            return nullptr;
+        }
+        auto collPath = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, parsed.parentId);
+        auto coll = qobject_cast<Collection*>(m_objects.value(collPath, nullptr));
+        if (!coll) {
+            return nullptr;
+        }
+        return coll->itemForUuid(Tools::hexToUuid(parsed.id));
     }
 
     bool DBusMgr::registerObject(Service* service)
@@ -447,12 +478,13 @@ namespace FdoSecrets
     {
         auto name = encodePath(coll->name());
         auto path = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, name);
-        if (!registerObject(path, coll)) {
+        // the collection also receives the messages to its items, so they can be created on demand
+        if (!registerObject(path, coll, true, QDBusConnection::SubPath)) {
             // try again with a suffix
             name.append(QString("_%1").arg(Tools::uuidToHex(QUuid::createUuid()).left(4)));
             path = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, name);
 
-            if (!registerObject(path, coll)) {
+            if (!registerObject(path, coll, true, QDBusConnection::SubPath)) {
                 qDebug() << "Failed to register database on DBus under name" << name;
                 emit error(tr("Failed to register database on DBus under the name '%1'").arg(name));
                 return false;
@@ -460,8 +492,12 @@ namespace FdoSecrets
         }
 
         connect(coll, &Collection::itemCreated, this, &DBusMgr::emitItemCreated);
-        connect(coll, &Collection::itemChanged, this, &DBusMgr::emitItemChanged);
-        connect(coll, &Collection::itemDeleted, this, &DBusMgr::emitItemDeleted);
+        connect(coll, &Collection::itemChanged, this, [this, coll](const QDBusObjectPath& itemPath) {
+            emitItemChanged(coll, itemPath);
+        });
+        connect(coll, &Collection::itemDeleted, this, [this, coll](const QDBusObjectPath& itemPath) {
+            emitItemDeleted(coll, itemPath);
+        });
 
         return true;
     }
@@ -479,10 +515,12 @@ namespace FdoSecrets
     bool DBusMgr::registerObject(Item* item)
     {
         auto path = DBUS_PATH_TEMPLATE_ITEM.arg(item->collection()->objectPath().path(), item->backend()->uuidToHex());
-        if (!registerObject(path, item)) {
+        // the path is already served by the collection, see registerObject(Collection*)
+        if (m_objects.contains(path)) {
             emit error(tr("Failed to register item on DBus at path '%1'").arg(path));
             return false;
         }
+        addObject(path, item, true);
         return true;
     }
 
@@ -501,9 +539,12 @@ namespace FdoSecrets
 
     void DBusMgr::unregisterObject(DBusObject* obj)
     {
-        auto count = m_objects.remove(obj->objectPath().path());
+        auto path = obj->objectPath().path();
+        auto count = m_objects.remove(path);
         if (count > 0) {
-            m_conn.unregisterObject(obj->objectPath().path());
+            if (parsePath(path).type != PathType::Item) {
+                m_conn.unregisterObject(path);
+            }
             obj->setObjectPath("/");
         }
     }
@@ -566,11 +607,10 @@ namespace FdoSecrets
         }
     }
 
-    void DBusMgr::emitItemChanged(Item* item)
+    void DBusMgr::emitItemChanged(Collection* coll, const QDBusObjectPath& itemPath)
     {
-        auto coll = item->collection();
         QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
+        args += QVariant::fromValue(itemPath);
         // send on primary path
         sendDBusSignal(
             coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemChanged"), args);
@@ -581,11 +621,10 @@ namespace FdoSecrets
         }
     }
 
-    void DBusMgr::emitItemDeleted(Item* item)
+    void DBusMgr::emitItemDeleted(Collection* coll, const QDBusObjectPath& itemPath)
     {
-        auto coll = item->collection();
         QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
+        args += QVariant::fromValue(itemPath);
         // send on primary path
         sendDBusSignal(
             coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemDeleted"), args);
@@ -169,7 +169,7 @@ namespace FdoSecrets
             if (path.path() == QStringLiteral("/")) {
                 return nullptr;
             }
-            auto obj = qobject_cast<T*>(m_objects.value(path.path(), nullptr));
+            auto obj = qobject_cast<T*>(findObject(path.path()));
             if (!obj) {
                 qDebug() << "object not found at path" << path.path();
                 qDebug() << m_objects;
@@ -210,8 +210,8 @@ namespace FdoSecrets
         void emitCollectionChanged(Collection* coll);
         void emitCollectionDeleted(Collection* coll);
         void emitItemCreated(Item* item);
-        void emitItemChanged(Item* item);
-        void emitItemDeleted(Item* item);
+        void emitItemChanged(Collection* coll, const QDBusObjectPath& itemPath);
+        void emitItemDeleted(Collection* coll, const QDBusObjectPath& itemPath);
         void emitPromptCompleted(bool dismissed, QVariant result);
 
         void dbusServiceUnregistered(const QString& service);
@@ -253,7 +253,12 @@ namespace FdoSecrets
             }
         };
         static ParsedPath parsePath(const QString& path);
-        bool registerObject(const QString& path, DBusObject* obj, bool primary = true);
+        bool registerObject(const QString& path,
+                            DBusObject* obj,
+                            bool primary = true,
+                            QDBusConnection::VirtualObjectRegisterOption option = QDBusConnection::SingleNode);
+        void addObject(const QString& path, DBusObject* obj, bool primary);
+        DBusObject* findObject(const QString& path) const;
 
         // method dispatching
         struct MethodData
@@ -29,6 +29,28 @@
 #include <QEventLoop>
 #include <QFileInfo>
 
+#include <algorithm>
+
+namespace
+{
+    // Path of group indices from the root followed by the index of the entry, ordered like a tree traversal
+    QVector<int> treePosition(Entry* entry)
+    {
+        QVector<int> position;
+        auto group = entry->group();
+        if (!group) {
+            return position;
+        }
+
+        position << group->entries().indexOf(entry) << -1;
+        for (; group->parentGroup(); group = group->parentGroup()) {
+            position << group->parentGroup()->children().indexOf(group);
+        }
+        std::reverse(position.begin(), position.end());
+        return position;
+    }
+} // namespace
+
 namespace FdoSecrets
 {
     Collection* Collection::Create(Service* parent, DatabaseWidget* backend)
@@ -113,13 +135,23 @@ namespace FdoSecrets
         return {};
     }
 
-    DBusResult Collection::items(QList<Item*>& items) const
+    DBusResult Collection::items(QList<QDBusObjectPath>& items) const
     {
         auto ret = ensureBackend();
         if (ret.err()) {
             return ret;
         }
-        items = m_items;
+        // list the paths only, items are created when a client uses them
+        if (m_exposedGroup && !backendLocked()) {
+            items.reserve(m_entryAttributes.size());
+            m_exposedGroup->forEachEntry(
+                [this, &items](const Entry* entry) {
+                    if (m_entryAttributes.contains(entry)) {
+                        items << itemPath(entry);
+                    }
+                },
+                Group::SkipRecycled);
+        }
         return {};
     }
 
@@ -229,18 +261,18 @@ namespace FdoSecrets
         // shortcut logic for Uuid/Path attributes, as they can uniquely identify an item.
         if (attributes.contains(ItemAttributes::UuidKey)) {
             auto uuid = QUuid::fromRfc4122(QByteArray::fromHex(attributes.value(ItemAttributes::UuidKey).toLatin1()));
-            auto entry = m_exposedGroup->findEntryByUuid(uuid);
-            if (entry) {
-                items += m_entryToItem.value(entry);
+            auto item = itemForEntry(m_exposedGroup->findEntryByUuid(uuid));
+            if (item) {
+                items << item;
             }
             return {};
         }
 
         if (attributes.contains(ItemAttributes::PathKey)) {
             auto path = attributes.value(ItemAttributes::PathKey);
-            auto entry = m_exposedGroup->findEntryByPath(path);
-            if (entry) {
-                items += m_entryToItem.value(entry);
+            auto item = itemForEntry(m_exposedGroup->findEntryByPath(path));
+            if (item) {
+                items << item;
             }
             return {};
         }
@@ -253,11 +285,19 @@ namespace FdoSecrets
         constexpr auto caseSensitive = false;
         constexpr auto skipProtected = true;
         constexpr auto forceSearch = true;
-        const auto foundEntries =
-            EntrySearcher(caseSensitive, skipProtected).search(terms, m_exposedGroup, forceSearch);
+        EntrySearcher searcher(caseSensitive, skipProtected);
+        QList<Entry*> foundEntries;
+        QList<Entry*> candidates;
+        if (indexCandidates(attributes, candidates)) {
+            // the index only narrows down the entries, the terms still decide which ones match
+            foundEntries = searcher.searchEntries(terms, candidates);
+        } else {
+            searcher.setParallel(true);
+            foundEntries = searcher.search(terms, m_exposedGroup, forceSearch);
+        }
         items.reserve(foundEntries.size());
         for (const auto& entry : foundEntries) {
-            const auto item = m_entryToItem.value(entry);
+            const auto item = itemForEntry(entry);
             // it's possible that we don't have a corresponding item for the entry
             // this can happen when the recycle bin is below the exposed group.
             if (item) {
@@ -267,6 +307,53 @@ namespace FdoSecrets
         return {};
     }
 
+    /**
+     * Look up the exposed entries whose custom attributes may match the attributes exactly
+     * @param attributes attributes to search for
+     * @param candidates receives the entries that need to be verified, in tree order
+     * @return false if none of the attributes is indexed
+     */
+    bool Collection::indexCandidates(const StringStringMap& attributes, QList<Entry*>& candidates) const
+    {
+        QSet<Entry*> entries;
+        bool indexed = false;
+        for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+            // default attributes are matched with placeholders resolved, so they are not indexed
+            if (EntryAttributes::isDefaultAttribute(it.key())) {
+                continue;
+            }
+
+            const auto matches = m_attributeIndex.value({it.key(), it.value()});
+            if (indexed) {
+                entries.intersect(matches);
+            } else {
+                entries = matches;
+                indexed = true;
+            }
+        }
+
+        if (!indexed) {
+            return false;
+        }
+
+        entries.unite(m_protectedEntries);
+        // keep the tree order of a full search, clients use the first match
+        QVector<QPair<QVector<int>, Entry*>> ordered;
+        ordered.reserve(entries.size());
+        for (auto entry : asConst(entries)) {
+            ordered.append({treePosition(entry), entry});
+        }
+        std::sort(
+            ordered.begin(), ordered.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+        candidates.clear();
+        candidates.reserve(ordered.size());
+        for (const auto& candidate : asConst(ordered)) {
+            candidates << candidate.second;
+        }
+        return true;
+    }
+
     EntrySearcher::SearchTerm Collection::attributeToTerm(const QString& key, const QString& value)
     {
         static QMap<QString, EntrySearcher::Field> attrKeyToField{
@@ -462,11 +549,9 @@ namespace FdoSecrets
             onDatabaseExposedGroupChanged();
         });
 
-        // Add items for existing entry
-        const auto entries = m_exposedGroup->entriesRecursive(false);
-        for (const auto& entry : entries) {
-            onEntryAdded(entry, false);
-        }
+        // Only index the existing entries, their items are created when a client asks for them.
+        // Registering an item per entry up front stalls unlocking large databases.
+        m_exposedGroup->forEachEntry([this](Entry* entry) { indexEntry(entry); }, Group::SkipRecycled);
 
         // Do not connect to Database::modified signal because we only want signals for the subset under m_exposedGroup
         connect(m_backend->database()->metadata(), &Metadata::modified, this, &Collection::collectionChanged);
@@ -488,38 +573,133 @@ namespace FdoSecrets
         }
     }
 
-    void Collection::onEntryAdded(Entry* entry, bool emitSignal)
+    void Collection::onEntryAdded(Entry* entry)
     {
         if (entry->isRecycled()) {
             return;
         }
 
-        auto item = Item::Create(this, entry);
-        if (!item) {
+        indexEntry(entry);
+        auto item = itemForEntry(entry);
+        if (item) {
+            emit itemCreated(item);
+        }
+    }
+
+    void Collection::onEntryModified(Entry* entry)
+    {
+        if (!m_entryAttributes.contains(entry)) {
             return;
         }
 
+        indexEntry(entry);
+        if (!m_entryToItem.contains(entry)) {
+            // existing items report their own changes, clients may know the path of the others
+            emit itemChanged(itemPath(entry));
+        }
+    }
+
+    void Collection::onEntryAboutToRemove(Entry* entry)
+    {
+        if (!m_entryAttributes.contains(entry)) {
+            return;
+        }
+
+        auto item = m_entryToItem.value(entry, nullptr);
+        unindexEntry(entry);
+        if (item) {
+            // the item reports its deletion
+            item->removeFromDBus();
+        } else {
+            // clients may know the path even if the item was never created
+            emit itemDeleted(itemPath(entry));
+        }
+    }
+
+    /**
+     * Find the item of an exposed entry, creating it on first use
+     * @param entry entry in the exposed group
+     * @return the item, or nullptr if the entry is not exposed
+     */
+    Item* Collection::itemForEntry(Entry* entry)
+    {
+        if (!entry || !m_entryAttributes.contains(entry)) {
+            return nullptr;
+        }
+
+        auto item = m_entryToItem.value(entry, nullptr);
+        if (item) {
+            return item;
+        }
+
+        item = Item::Create(this, entry);
+        if (!item) {
+            return nullptr;
+        }
+
         m_items << item;
         m_entryToItem[entry] = item;
 
-        // forward delete signals
-        connect(entry->group(), &Group::entryAboutToRemove, item, [item](Entry* toBeRemoved) {
-            if (item->backend() == toBeRemoved) {
-                item->removeFromDBus();
-            }
-        });
-
         // relay signals
-        connect(item, &Item::itemChanged, this, [this, item]() { emit itemChanged(item); });
+        connect(item, &Item::itemChanged, this, [this, item]() { emit itemChanged(item->objectPath()); });
         connect(item, &Item::itemAboutToDelete, this, [this, item]() {
             m_items.removeAll(item);
             m_entryToItem.remove(item->backend());
-            emit itemDeleted(item);
+            emit itemDeleted(item->objectPath());
         });
 
-        if (emitSignal) {
-            emit itemCreated(item);
+        return item;
+    }
+
+    /**
+     * Find the item at a path below this collection, see DBusMgr::pathToObject
+     * @param uuid uuid of the entry
+     * @return the item, or nullptr if there is no such exposed entry
+     */
+    Item* Collection::itemForUuid(const QUuid& uuid)
+    {
+        if (!m_exposedGroup || backendLocked()) {
+            return nullptr;
+        }
+        return itemForEntry(m_exposedGroup->findEntryByUuid(uuid));
+    }
+
+    QDBusObjectPath Collection::itemPath(const Entry* entry) const
+    {
+        return QDBusObjectPath(DBUS_PATH_TEMPLATE_ITEM.arg(objectPath().path(), entry->uuidToHex()));
+    }
+
+    void Collection::indexEntry(Entry* entry)
+    {
+        // the attributes may have changed, so drop what the entry was indexed with before
+        unindexEntry(entry);
+
+        QList<QPair<QString, QString>> indexed;
+        const auto attributes = entry->attributes();
+        for (const auto& key : attributes->customKeys()) {
+            if (attributes->isProtected(key)) {
+                m_protectedEntries.insert(entry);
+                continue;
+            }
+            const QPair<QString, QString> attribute(key, attributes->value(key));
+            m_attributeIndex[attribute].insert(entry);
+            indexed << attribute;
+        }
+        m_entryAttributes.insert(entry, indexed);
+    }
+
+    void Collection::unindexEntry(Entry* entry)
+    {
+        for (const auto& attribute : m_entryAttributes.take(entry)) {
+            auto it = m_attributeIndex.find(attribute);
+            if (it != m_attributeIndex.end()) {
+                it->remove(entry);
+                if (it->isEmpty()) {
+                    m_attributeIndex.erase(it);
+                }
+            }
         }
+        m_protectedEntries.remove(entry);
     }
 
     void Collection::connectGroupSignalRecursive(Group* group)
@@ -529,7 +709,9 @@ namespace FdoSecrets
         }
 
         connect(group, &Group::modified, this, &Collection::collectionChanged);
-        connect(group, &Group::entryAdded, this, [this](Entry* entry) { onEntryAdded(entry, true); });
+        connect(group, &Group::entryAdded, this, &Collection::onEntryAdded);
+        connect(group, &Group::entryModified, this, &Collection::onEntryModified);
+        connect(group, &Group::entryAboutToRemove, this, &Collection::onEntryAboutToRemove);
 
         const auto children = group->children();
         for (const auto& cg : children) {
@@ -607,6 +789,9 @@ namespace FdoSecrets
         }
 
         m_items.clear();
+        m_attributeIndex.clear();
+        m_entryAttributes.clear();
+        m_protectedEntries.clear();
     }
 
     QString Collection::backendFilePath() const
@@ -52,7 +52,7 @@ namespace FdoSecrets
          */
         static Collection* Create(Service* parent, DatabaseWidget* backend);
 
-        Q_INVOKABLE DBUS_PROPERTY DBusResult items(QList<Item*>& items) const;
+        Q_INVOKABLE DBUS_PROPERTY DBusResult items(QList<QDBusObjectPath>& items) const;
 
         Q_INVOKABLE DBUS_PROPERTY DBusResult label(QString& label) const;
         Q_INVOKABLE DBusResult setLabel(const QString& label);
@@ -72,8 +72,9 @@ namespace FdoSecrets
 
     signals:
         void itemCreated(Item* item);
-        void itemDeleted(Item* item);
-        void itemChanged(Item* item);
+        // only the path is passed, items are not created for every entry
+        void itemDeleted(const QDBusObjectPath& itemPath);
+        void itemChanged(const QDBusObjectPath& itemPath);
 
         void collectionChanged();
         void collectionAboutToDelete();
@@ -110,6 +111,9 @@ namespace FdoSecrets
 
         static EntrySearcher::SearchTerm attributeToTerm(const QString& key, const QString& value);
 
+        Item* itemForEntry(Entry* entry);
+        Item* itemForUuid(const QUuid& uuid);
+
     public slots:
         // expose some methods for Prompt to use
 
@@ -139,7 +143,13 @@ namespace FdoSecrets
         friend class DeleteCollectionPrompt;
         friend class CreateCollectionPrompt;
 
-        void onEntryAdded(Entry* entry, bool emitSignal);
+        void onEntryAdded(Entry* entry);
+        void onEntryModified(Entry* entry);
+        void onEntryAboutToRemove(Entry* entry);
+        QDBusObjectPath itemPath(const Entry* entry) const;
+        void indexEntry(Entry* entry);
+        void unindexEntry(Entry* entry);
+        bool indexCandidates(const StringStringMap& attributes, QList<Entry*>& candidates) const;
         void populateContents();
         void connectGroupSignalRecursive(Group* group);
         void cleanupConnections();
@@ -171,8 +181,16 @@ namespace FdoSecrets
         QPointer<Group> m_exposedGroup;
 
         QSet<QString> m_aliases;
+        // Items are only created for the entries clients have used, see itemForEntry
         QList<Item*> m_items;
         QMap<const Entry*, Item*> m_entryToItem;
+
+        // Exact match index of the custom attributes, see searchItems
+        QHash<QPair<QString, QString>, QSet<Entry*>> m_attributeIndex;
+        // Attributes of every exposed entry, as they were indexed
+        QHash<const Entry*, QList<QPair<QString, QString>>> m_entryAttributes;
+        // Entries with protected custom attributes, the search skips these attributes instead of comparing them
+        QSet<Entry*> m_protectedEntries;
     };
 
 } // namespace FdoSecrets
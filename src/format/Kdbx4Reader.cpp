@@ -21,12 +21,14 @@
 #include <QJsonObject>
 
 #include "core/AsyncTask.h"
+#include "core/AttachmentBlob.h"
 #include "core/Endian.h"
 #include "core/Group.h"
 #include "crypto/CryptoHash.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/HmacBlockStream.h"
+#include "streams/PipelineStream.h"
 #include "streams/StoreDataStream.h"
 #include "streams/SymmetricCipherStream.h"
 #include "streams/qtiocompressor.h"
@@ -101,19 +103,34 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
     }
     // clang-format on
 
+    // Verify and decrypt the next blocks while the current ones are decompressed and parsed
+    PipelineStream decryptStage(&cipherStream);
+    decryptStage.setObjectName("decrypt");
+    if (!decryptStage.open(QIODevice::ReadOnly)) {
+        raiseError(decryptStage.errorString());
+        return false;
+    }
+
     QIODevice* xmlDevice = nullptr;
     QScopedPointer<QtIOCompressor> ioCompressor;
+    QScopedPointer<PipelineStream> decompressStage;
 
     if (db->compressionAlgorithm() == Database::CompressionNone) {
-        xmlDevice = &cipherStream;
+        xmlDevice = &decryptStage;
     } else {
-        ioCompressor.reset(new QtIOCompressor(&cipherStream));
+        ioCompressor.reset(new QtIOCompressor(&decryptStage));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::ReadOnly)) {
             raiseError(ioCompressor->errorString());
             return false;
         }
-        xmlDevice = ioCompressor.data();
+        decompressStage.reset(new PipelineStream(ioCompressor.data()));
+        decompressStage->setObjectName("decompress");
+        if (!decompressStage->open(QIODevice::ReadOnly)) {
+            raiseError(decompressStage->errorString());
+            return false;
+        }
+        xmlDevice = decompressStage.data();
     }
 
     while (readInnerHeaderField(xmlDevice) && !hasError()) {
@@ -295,7 +312,8 @@ bool Kdbx4Reader::readInnerHeaderField(QIODevice* device)
             return false;
         }
         auto data = fieldData.mid(1);
-        m_binaryPool.insert(QString::number(m_binaryPool.size()), data);
+        fieldData.clear();
+        m_binaryPool.insert(QString::number(m_binaryPool.size()), AttachmentBlob::create(data));
         break;
     }
     }
@@ -438,7 +456,7 @@ QVariantMap Kdbx4Reader::readVariantMap(QIODevice* device)
 /**
  * @return mapping from attachment keys to binary data
  */
-QHash<QString, QByteArray> Kdbx4Reader::binaryPool() const
+QHash<QString, QSharedPointer<const AttachmentBlob>> Kdbx4Reader::binaryPool() const
 {
     return m_binaryPool;
 }
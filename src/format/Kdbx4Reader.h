@@ -20,6 +20,8 @@
 
 #include "format/KdbxReader.h"
 
+class AttachmentBlob;
+
 /**
  * KDBX4 reader implementation.
  */
@@ -32,7 +34,7 @@ public:
                           const QByteArray& headerData,
                           QSharedPointer<const CompositeKey> key,
                           Database* db) override;
-    QHash<QString, QByteArray> binaryPool() const;
+    QHash<QString, QSharedPointer<const AttachmentBlob>> binaryPool() const;
 
 protected:
     bool readHeaderField(StoreDataStream& headerStream, Database* db) override;
@@ -41,7 +43,7 @@ private:
     bool readInnerHeaderField(QIODevice* device);
     QVariantMap readVariantMap(QIODevice* device);
 
-    QHash<QString, QByteArray> m_binaryPool;
+    QHash<QString, QSharedPointer<const AttachmentBlob>> m_binaryPool;
 };
 
 #endif // KEEPASSX_KDBX4READER_H
@@ -24,6 +24,7 @@
 #include "crypto/Random.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/HmacBlockStream.h"
+#include "streams/PipelineStream.h"
 #include "streams/SymmetricCipherStream.h"
 #include "streams/qtiocompressor.h"
 
@@ -131,19 +132,34 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
         return false;
     }
 
+    // Encrypt and authenticate previous blocks while the next ones are generated and compressed
+    QScopedPointer<PipelineStream> encryptStage(new PipelineStream(cipherStream.data()));
+    encryptStage->setObjectName("encrypt");
+    if (!encryptStage->open(QIODevice::WriteOnly)) {
+        raiseError(encryptStage->errorString());
+        return false;
+    }
+
     QIODevice* outputDevice = nullptr;
     QScopedPointer<QtIOCompressor> ioCompressor;
+    QScopedPointer<PipelineStream> compressStage;
 
     if (db->compressionAlgorithm() == Database::CompressionNone) {
-        outputDevice = cipherStream.data();
+        outputDevice = encryptStage.data();
     } else {
-        ioCompressor.reset(new QtIOCompressor(cipherStream.data()));
+        ioCompressor.reset(new QtIOCompressor(encryptStage.data()));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::WriteOnly)) {
             raiseError(ioCompressor->errorString());
             return false;
         }
-        outputDevice = ioCompressor.data();
+        compressStage.reset(new PipelineStream(ioCompressor.data()));
+        compressStage->setObjectName("compress");
+        if (!compressStage->open(QIODevice::WriteOnly)) {
+            raiseError(compressStage->errorString());
+            return false;
+        }
+        outputDevice = compressStage.data();
     }
 
     Q_ASSERT(outputDevice);
@@ -157,6 +173,9 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
 
     // Write attachments to the inner header
     auto idxMap = writeAttachments(outputDevice, db);
+    if (hasError()) {
+        return false;
+    }
 
     CHECK_RETURN_FALSE(writeInnerHeaderField(outputDevice, KeePass2::InnerHeaderFieldID::End, QByteArray()));
 
@@ -171,9 +190,21 @@ bool Kdbx4Writer::writeDatabase(QIODevice* device, Database* db)
 
     // Explicitly close/reset streams so they are flushed and we can detect
     // errors. QIODevice::close() resets errorString() etc.
+    if (compressStage) {
+        if (!compressStage->reset()) {
+            raiseError(compressStage->errorString());
+            return false;
+        }
+        compressStage->close();
+    }
     if (ioCompressor) {
         ioCompressor->close();
     }
+    if (!encryptStage->reset()) {
+        raiseError(encryptStage->errorString());
+        return false;
+    }
+    encryptStage->close();
     if (!cipherStream->reset()) {
         raiseError(cipherStream->errorString());
         return false;
@@ -213,42 +244,38 @@ bool Kdbx4Writer::writeInnerHeaderField(QIODevice* device, KeePass2::InnerHeader
 
 KdbxXmlWriter::BinaryIdxMap Kdbx4Writer::writeAttachments(QIODevice* device, Database* db)
 {
-    const QList<Entry*> allEntries = db->rootGroup()->entriesRecursive(true);
-    QHash<QByteArray, qint64> writtenAttachments;
+    // Attachments are deduplicated by namespace and content hash, the hash is cached by the shared blob
+    QHash<QPair<const Group*, QByteArray>, qint64> writtenAttachments;
     KdbxXmlWriter::BinaryIdxMap idxMap;
     qint64 nextIdx = 0;
 
-    for (const Entry* entry : allEntries) {
-        const QList<QString> attachmentKeys = entry->attachments()->keys();
-        for (const QString& key : attachmentKeys) {
-            QByteArray data("\x01");
-            data.append(entry->attachments()->value(key));
-
-            CryptoHash hash(CryptoHash::Sha256);
-#ifdef WITH_XC_KEESHARE
-            // Namespace KeeShare attachments so they don't get deduplicated together with attachments
-            // from other databases. Prevents potential filesize side channels.
-            auto group = entry->group();
-            if (!group && entry->historyOwner()) {
-                group = entry->historyOwner()->group();
+    db->rootGroup()->forEachEntry(
+        [&](const Entry* entry) -> bool {
+            const auto hashNamespace = KdbxXmlWriter::attachmentNamespace(entry);
+            const QList<QString> attachmentKeys = entry->attachments()->keys();
+            for (const QString& key : attachmentKeys) {
+                const auto blob = entry->attachments()->blob(key);
+                const auto hashKey = qMakePair(hashNamespace, blob->hash());
+                if (hashKey.second.isEmpty()) {
+                    raiseError(tr("Unable to calculate the hash of attachment \"%1\"").arg(key));
+                    return false;
+                }
+
+                // Deduplicate attachments with the same hash
+                auto it = writtenAttachments.constFind(hashKey);
+                if (it == writtenAttachments.constEnd()) {
+                    QByteArray data("\x01");
+                    data.append(blob->data());
+                    if (!writeInnerHeaderField(device, KeePass2::InnerHeaderFieldID::Binary, data)) {
+                        return false;
+                    }
+                    it = writtenAttachments.insert(hashKey, nextIdx++);
+                }
+                idxMap.insert(qMakePair(hashNamespace, blob.data()), it.value());
             }
-            if (group && group->isShared()) {
-                hash.addData(group->uuid().toByteArray());
-            } else {
-                hash.addData(db->uuid().toByteArray());
-            }
-#endif
-            hash.addData(data);
-
-            // Deduplicate attachments with the same hash
-            const auto hashResult = hash.result();
-            if (!writtenAttachments.contains(hashResult)) {
-                writeInnerHeaderField(device, KeePass2::InnerHeaderFieldID::Binary, data);
-                writtenAttachments.insert(hashResult, nextIdx++);
-            }
-            idxMap.insert(qMakePair(entry, key), writtenAttachments[hashResult]);
-        }
-    }
+            return true;
+        },
+        Group::IncludeHistory);
 
     return idxMap;
 }
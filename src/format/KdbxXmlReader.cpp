@@ -17,6 +17,7 @@
 
 #include "KdbxXmlReader.h"
 #include "KeePass2RandomStream.h"
+#include "core/AttachmentBlob.h"
 #include "core/Clock.h"
 #include "core/Endian.h"
 #include "core/Global.h"
@@ -41,7 +42,7 @@ KdbxXmlReader::KdbxXmlReader(quint32 version)
  * @param version KDBX version
  * @param binaryPool binary pool
  */
-KdbxXmlReader::KdbxXmlReader(quint32 version, QHash<QString, QByteArray> binaryPool)
+KdbxXmlReader::KdbxXmlReader(quint32 version, QHash<QString, QSharedPointer<const AttachmentBlob>> binaryPool)
     : m_kdbxVersion(version)
     , m_binaryPool(std::move(binaryPool))
 {
@@ -134,10 +135,15 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
         qWarning("KdbxXmlReader::readDatabase: found unused key \"%s\"", qPrintable(key));
     }
 
+    // Share one blob per binary between all entries and history items referencing it
     QMultiHash<QString, QPair<Entry*, QString>>::const_iterator i;
     for (i = m_binaryMap.constBegin(); i != m_binaryMap.constEnd(); ++i) {
         const QPair<Entry*, QString>& target = i.value();
-        target.first->attachments()->set(target.second, m_binaryPool[i.key()]);
+        auto& blob = m_binaryPool[i.key()];
+        if (!blob) {
+            blob = AttachmentBlob::create(QByteArray());
+        }
+        target.first->attachments()->set(target.second, blob);
     }
 
     m_meta->setUpdateDatetime(true);
@@ -155,6 +161,9 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
         for (Entry* histEntry : historyItems) {
             histEntry->setUpdateTimeinfo(true);
         }
+
+        // Nobody holds the history items yet, keep them compact until they are requested
+        iEntry.value()->compactHistory();
     }
 }
 
@@ -399,7 +408,7 @@ void KdbxXmlReader::parseBinaries()
             qWarning("KdbxXmlReader::parseBinaries: overwriting binary item \"%s\"", qPrintable(id));
         }
 
-        m_binaryPool.insert(id, data);
+        m_binaryPool.insert(id, AttachmentBlob::create(data));
     }
 }
 
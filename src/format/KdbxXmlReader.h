@@ -25,6 +25,7 @@
 #include <QMultiHash>
 #include <QXmlStreamReader>
 
+class AttachmentBlob;
 class QIODevice;
 class Group;
 class Entry;
@@ -40,7 +41,7 @@ class KdbxXmlReader
 
 public:
     explicit KdbxXmlReader(quint32 version);
-    explicit KdbxXmlReader(quint32 version, QHash<QString, QByteArray> binaryPool);
+    explicit KdbxXmlReader(quint32 version, QHash<QString, QSharedPointer<const AttachmentBlob>> binaryPool);
     virtual ~KdbxXmlReader() = default;
 
     virtual QSharedPointer<Database> readDatabase(const QString& filename);
@@ -109,7 +110,7 @@ protected:
     QHash<QUuid, Group*> m_groups;
     QHash<QUuid, Entry*> m_entries;
 
-    QHash<QString, QByteArray> m_binaryPool;
+    QHash<QString, QSharedPointer<const AttachmentBlob>> m_binaryPool;
     QMultiHash<QString, QPair<Entry*, QString>> m_binaryMap;
     QByteArray m_headerHash;
 
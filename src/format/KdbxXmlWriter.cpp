@@ -22,7 +22,6 @@
 #include <QMap>
 
 #include "core/Endian.h"
-#include "crypto/CryptoHash.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/qtiocompressor.h"
 
@@ -57,8 +56,8 @@ void KdbxXmlWriter::writeDatabase(QIODevice* device,
     m_xml.setAutoFormattingIndent(-1); // 1 tab
     m_xml.setCodec("UTF-8");
 
-    if (m_kdbxVersion < KeePass2::FILE_VERSION_4) {
-        fillBinaryIdxMap();
+    if (m_kdbxVersion < KeePass2::FILE_VERSION_4 && !fillBinaryIdxMap()) {
+        return;
     }
 
     m_xml.setDevice(device);
@@ -93,44 +92,61 @@ QString KdbxXmlWriter::errorString()
     return m_errorStr;
 }
 
+/**
+ * Namespace in which the attachments of an entry are deduplicated.
+ * KeeShare attachments are not deduplicated together with attachments from
+ * other databases. Prevents potential filesize side channels.
+ *
+ * @param entry entry or history item
+ * @return shared group of the entry or nullptr for the database namespace
+ */
+const Group* KdbxXmlWriter::attachmentNamespace(const Entry* entry)
+{
+#ifdef WITH_XC_KEESHARE
+    auto group = entry->group();
+    if (!group && entry->historyOwner()) {
+        group = entry->historyOwner()->group();
+    }
+    if (group && group->isShared()) {
+        return group;
+    }
+#else
+    Q_UNUSED(entry);
+#endif
+    return nullptr;
+}
+
 /**
  * Generate a map of entry attachments to deduplicated attachment index IDs.
  * This is basically duplicated code from Kdbx4Writer.cpp for KDBX 3 compatibility.
  * I don't have a good solution for getting rid of this duplication without getting rid of KDBX 3.
+ *
+ * @return false if an attachment could not be hashed
  */
-void KdbxXmlWriter::fillBinaryIdxMap()
+bool KdbxXmlWriter::fillBinaryIdxMap()
 {
-    const QList<Entry*> allEntries = m_db->rootGroup()->entriesRecursive(true);
-    QHash<QByteArray, qint64> writtenAttachments;
+    QHash<QPair<const Group*, QByteArray>, qint64> writtenAttachments;
     qint64 nextIdx = 0;
 
-    for (Entry* entry : allEntries) {
-        const QList<QString> attachmentKeys = entry->attachments()->keys();
-        for (const QString& key : attachmentKeys) {
-            QByteArray data = entry->attachments()->value(key);
-            CryptoHash hash(CryptoHash::Sha256);
-#ifdef WITH_XC_KEESHARE
-            // Namespace KeeShare attachments so they don't get deduplicated together with attachments
-            // from other databases. Prevents potential filesize side channels.
-            auto group = entry->group();
-            if (!group && entry->historyOwner()) {
-                group = entry->historyOwner()->group();
-            }
-            if (group && group->isShared()) {
-                hash.addData(group->uuid().toByteArray());
-            } else {
-                hash.addData(m_db->uuid().toByteArray());
-            }
-#endif
-            hash.addData(data);
-
-            const auto hashResult = hash.result();
-            if (!writtenAttachments.contains(hashResult)) {
-                writtenAttachments.insert(hashResult, nextIdx++);
+    return m_db->rootGroup()->forEachEntry(
+        [&](const Entry* entry) -> bool {
+            const auto hashNamespace = attachmentNamespace(entry);
+            const QList<QString> attachmentKeys = entry->attachments()->keys();
+            for (const QString& key : attachmentKeys) {
+                const auto blob = entry->attachments()->blob(key);
+                const auto hashKey = qMakePair(hashNamespace, blob->hash());
+                if (hashKey.second.isEmpty()) {
+                    raiseError(tr("Unable to calculate the hash of attachment \"%1\"").arg(key));
+                    return false;
+                }
+                if (!writtenAttachments.contains(hashKey)) {
+                    writtenAttachments.insert(hashKey, nextIdx++);
+                }
+                m_binaryIdxMap.insert(qMakePair(hashNamespace, blob.data()), writtenAttachments.value(hashKey));
             }
-            m_binaryIdxMap.insert(qMakePair(entry, key), writtenAttachments.value(hashResult));
-        }
-    }
+            return true;
+        },
+        Group::IncludeHistory);
 }
 
 void KdbxXmlWriter::writeMetadata()
@@ -222,7 +238,7 @@ void KdbxXmlWriter::writeBinaries()
     QMap<qint64, QByteArray> binaries;
     for (auto i = m_binaryIdxMap.constBegin(); i != m_binaryIdxMap.constEnd(); ++i) {
         if (!binaries.contains(i.value())) {
-            binaries.insert(i.value(), i.key().first->attachments()->value(i.key().second));
+            binaries.insert(i.value(), i.key().second->data());
         }
     }
 
@@ -465,7 +481,9 @@ void KdbxXmlWriter::writeEntry(const Entry* entry)
         writeString("Key", key);
 
         m_xml.writeStartElement("Value");
-        m_xml.writeAttribute("Ref", QString::number(m_binaryIdxMap[qMakePair(entry, key)]));
+        const auto blob = entry->attachments()->blob(key);
+        m_xml.writeAttribute("Ref",
+                             QString::number(m_binaryIdxMap.value(qMakePair(attachmentNamespace(entry), blob.data()))));
         m_xml.writeEndElement();
 
         m_xml.writeEndElement();
@@ -515,10 +533,10 @@ void KdbxXmlWriter::writeEntryHistory(const Entry* entry)
 {
     m_xml.writeStartElement("History");
 
-    const QList<Entry*>& historyItems = entry->historyItems();
-    for (const Entry* item : historyItems) {
+    entry->forEachHistoryItem([this](const Entry* item) {
         writeEntry(item);
-    }
+        return true;
+    });
 
     m_xml.writeEndElement();
 }
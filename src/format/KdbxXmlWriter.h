@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_KDBXXMLWRITER_H
 #define KEEPASSX_KDBXXMLWRITER_H
 
+#include <QCoreApplication>
 #include <QDateTime>
 #include <QXmlStreamWriter>
 
@@ -29,11 +30,16 @@ class KeePass2RandomStream;
 
 class KdbxXmlWriter
 {
+    Q_DECLARE_TR_FUNCTIONS(KdbxXmlWriter)
+
 public:
     /**
-     * Map of entry + attachment key to KDBX 4 inner header binary index.
+     * Map of attachment namespace + attachment content to KDBX 4 inner header binary index.
+     * The map does not refer to entries, so history items can be written from temporary copies.
      */
-    typedef QHash<QPair<const Entry*, QString>, qint64> BinaryIdxMap;
+    typedef QHash<QPair<const Group*, const AttachmentBlob*>, qint64> BinaryIdxMap;
+
+    static const Group* attachmentNamespace(const Entry* entry);
 
     explicit KdbxXmlWriter(quint32 version);
     explicit KdbxXmlWriter(quint32 version, KdbxXmlWriter::BinaryIdxMap binaryIdxMap);
@@ -49,7 +55,7 @@ public:
     QString errorString();
 
 private:
-    void fillBinaryIdxMap();
+    bool fillBinaryIdxMap();
 
     void writeMetadata();
     void writeMemoryProtection();
@@ -88,8 +88,12 @@ quint32 KeePass2Writer::kdbxVersionRequired(Database const* db, bool ignoreCurre
                 VERSION_MAX(version, KeePass2::FILE_VERSION_4_1)
             }
 
-            for (const auto* historyItem : entry->historyItems()) {
-                if (historyItem->customData() && !historyItem->customData()->isEmpty()) {
+            // Decoding compact history is only needed while the version can still change
+            if (version < KeePass2::FILE_VERSION_4) {
+                const bool historyHasCustomData = !entry->forEachHistoryItem([](const Entry* historyItem) {
+                    return !historyItem->customData() || historyItem->customData()->isEmpty();
+                });
+                if (historyHasCustomData) {
                     VERSION_MAX(version, KeePass2::FILE_VERSION_4)
                 }
             }
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CustomIconCache.h"
+
+#include "core/AsyncTask.h"
+#include "core/Database.h"
+#include "core/Metadata.h"
+
+#include <QGuiApplication>
+#include <QIcon>
+
+namespace
+{
+    // Custom icons are scaled to this size before the QIcon picks the requested size
+    const int BaseIconSize = 64;
+
+    struct PendingIcon
+    {
+        QUuid uuid;
+        QByteArray data;
+        QImage image;
+    };
+} // namespace
+
+CustomIconCache::CustomIconCache(const Database* db)
+    : m_db(db)
+{
+    connect(db->metadata(), &Metadata::customIconChanged, this, &CustomIconCache::invalidate);
+    connect(db->metadata(), &Metadata::customIconsCleared, this, &CustomIconCache::clear);
+}
+
+/**
+ * Get the pixmap of a custom icon, decoding the icon only on first use.
+ *
+ * @param uuid custom icon uuid
+ * @param size requested icon size
+ * @return pixmap for the current device pixel ratio or a null pixmap if the icon does not exist
+ */
+QPixmap CustomIconCache::pixmap(const QUuid& uuid, IconSize size)
+{
+    if (!m_db || !m_db->metadata()->hasCustomIcon(uuid)) {
+        return {};
+    }
+
+    const QPair<int, int> key(static_cast<int>(size), qRound(qGuiApp->devicePixelRatio() * 100));
+    auto& pixmaps = m_pixmaps[uuid];
+    auto it = pixmaps.constFind(key);
+    if (it != pixmaps.constEnd()) {
+        return it.value();
+    }
+
+    auto image = m_images.value(uuid);
+    if (image.isNull()) {
+        image = decode(m_db->metadata()->customIcon(uuid).data);
+        m_images.insert(uuid, image);
+    }
+
+    // Generate QIcon with pre-baked resolutions
+    auto pixmap = QIcon(QPixmap::fromImage(image)).pixmap(databaseIcons()->iconSize(size));
+    pixmaps.insert(key, pixmap);
+    return pixmap;
+}
+
+/**
+ * Decode all custom icons that are not cached yet in the background.
+ * Pixmaps are still created on first use since they must be created on the GUI thread.
+ * Emits preloaded() once the decoded icons are cached.
+ */
+void CustomIconCache::preload()
+{
+    if (!m_db || m_preloading) {
+        return;
+    }
+
+    auto pending = QSharedPointer<QVector<PendingIcon>>::create();
+    const auto metadata = m_db->metadata();
+    for (const auto& uuid : metadata->customIconsOrder()) {
+        if (!m_images.contains(uuid)) {
+            pending->append({uuid, metadata->customIcon(uuid).data, {}});
+        }
+    }
+    if (pending->isEmpty()) {
+        return;
+    }
+
+    m_preloading = true;
+    AsyncTask::runThenCallback(
+        [pending] {
+            QtConcurrent::blockingMap(*pending, [](PendingIcon& icon) { icon.image = decode(icon.data); });
+            return true;
+        },
+        this,
+        [this, pending](bool) {
+            m_preloading = false;
+            // The database may have been closed while decoding
+            if (m_db) {
+                const auto metadata = m_db->metadata();
+                for (const auto& icon : asConst(*pending)) {
+                    // Skip icons that were replaced or removed while decoding
+                    if (m_images.contains(icon.uuid) || !metadata->hasCustomIcon(icon.uuid)
+                        || metadata->customIcon(icon.uuid).data != icon.data) {
+                        continue;
+                    }
+                    m_images.insert(icon.uuid, icon.image);
+                }
+            }
+            emit preloaded();
+        });
+}
+
+void CustomIconCache::invalidate(const QUuid& uuid)
+{
+    m_images.remove(uuid);
+    m_pixmaps.remove(uuid);
+}
+
+void CustomIconCache::clear()
+{
+    m_images.clear();
+    m_pixmaps.clear();
+}
+
+QImage CustomIconCache::decode(const QByteArray& data)
+{
+    return QImage::fromData(data).scaled(BaseIconSize, BaseIconSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
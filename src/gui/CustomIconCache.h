@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_CUSTOMICONCACHE_H
+#define KEEPASSXC_CUSTOMICONCACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+#include <QUuid>
+
+#include "gui/DatabaseIcons.h"
+
+class Database;
+
+/**
+ * Decoded custom icons of a single database.
+ *
+ * Decoding the stored image data and scaling it is by far the most expensive
+ * part of painting a custom icon, so the decoded image is kept per icon uuid
+ * and the final pixmap per icon size and device pixel ratio. Entries are
+ * dropped when the icon is added, removed or the metadata is cleared.
+ *
+ * The cache must only be used from the GUI thread.
+ */
+class CustomIconCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CustomIconCache(const Database* db);
+
+    QPixmap pixmap(const QUuid& uuid, IconSize size);
+    void preload();
+
+signals:
+    void preloaded();
+
+private slots:
+    void invalidate(const QUuid& uuid);
+    void clear();
+
+private:
+    static QImage decode(const QByteArray& data);
+
+    // The cache is deleted later than the database, see Icons::customIconCache()
+    QPointer<const Database> m_db;
+    QHash<QUuid, QImage> m_images;
+    QHash<QUuid, QHash<QPair<int, int>, QPixmap>> m_pixmaps;
+    bool m_preloading = false;
+};
+
+#endif // KEEPASSXC_CUSTOMICONCACHE_H
@@ -43,6 +43,7 @@
 #include "gui/EntryPreviewWidget.h"
 #include "gui/FileDialog.h"
 #include "gui/GuiTools.h"
+#include "gui/Icons.h"
 #include "gui/MainWindow.h"
 #include "gui/MessageBox.h"
 #include "gui/TotpDialog.h"
@@ -228,6 +229,7 @@ DatabaseWidget::DatabaseWidget(QSharedPointer<Database> db, QWidget* parent)
     connect(m_autosaveTimer, SIGNAL(timeout()), this, SLOT(onAutosaveDelayTimeout()));
 
     m_searchLimitGroup = config()->get(Config::SearchLimitGroup).toBool();
+    m_entrySearcher->setParallel(true);
 
 #ifdef WITH_XC_KEESHARE
     // We need to reregister the database to allow exports
@@ -1259,6 +1261,7 @@ void DatabaseWidget::connectDatabaseSignals()
     connect(m_db.data(), &Database::modified, this, &DatabaseWidget::databaseModified);
     connect(m_db.data(), &Database::modified, this, &DatabaseWidget::onDatabaseModified);
     connect(m_db.data(), &Database::databaseSaved, this, &DatabaseWidget::databaseSaved);
+    connect(m_db.data(), &Database::backgroundSaveFinished, this, &DatabaseWidget::onBackgroundSaveFinished);
     connect(m_db.data(), &Database::databaseFileChanged, this, &DatabaseWidget::reloadDatabaseFile);
     connect(m_db.data(), &Database::databaseNonDataChanged, this, &DatabaseWidget::databaseNonDataChanged);
     connect(m_db.data(), &Database::databaseNonDataChanged, this, &DatabaseWidget::onDatabaseNonDataChanged);
@@ -1276,6 +1279,7 @@ void DatabaseWidget::loadDatabase(bool accepted)
         replaceDatabase(openWidget->database());
         switchToMainView();
         processAutoOpen();
+        Icons::preloadCustomIcons(m_db.data());
 
         restoreGroupEntryFocus(m_groupBeforeLock, m_entryBeforeLock);
 
@@ -1776,7 +1780,7 @@ void DatabaseWidget::onDatabaseModified()
         return;
     }
     if (!m_blockAutoSave && autosaveAfterEveryChangeConfig) {
-        save();
+        autosave();
     } else {
         // Only block once, then reset
         m_blockAutoSave = false;
@@ -1792,7 +1796,7 @@ void DatabaseWidget::onAutosaveDelayTimeout()
         return;
     }
     if (!m_blockAutoSave) {
-        save();
+        autosave();
     } else {
         // Only block once, then reset
         m_blockAutoSave = false;
@@ -2292,19 +2296,8 @@ bool DatabaseWidget::save()
         return true;
     }
 
-    if (m_saveAttempts > 2 && config()->get(Config::UseAtomicSaves).toBool()) {
-        // Saving failed 3 times, issue a warning and attempt to resolve
-        auto result = MessageBox::question(this,
-                                           tr("Disable safe saves?"),
-                                           tr("KeePassXC has failed to save the database multiple times. "
-                                              "This is likely caused by file sync services holding a lock on "
-                                              "the save file.\nDisable safe saves and try again?"),
-                                           MessageBox::Disable | MessageBox::Cancel,
-                                           MessageBox::Disable);
-        if (result == MessageBox::Disable) {
-            config()->set(Config::UseAtomicSaves, false);
-            return save();
-        }
+    if (askToDisableSafeSaves()) {
+        return save();
     }
 
     showMessage(tr("Writing the database failed: %1").arg(errorMessage),
@@ -2364,34 +2357,8 @@ bool DatabaseWidget::performSave(QString& errorMessage, const QString& fileName)
     m_tagView->setDisabled(true);
     QApplication::processEvents();
 
-    Database::SaveAction saveAction = Database::Atomic;
-    if (!config()->get(Config::UseAtomicSaves).toBool()) {
-        if (config()->get(Config::UseDirectWriteSaves).toBool()) {
-            saveAction = Database::DirectWrite;
-        } else {
-            saveAction = Database::TempFile;
-        }
-    }
-
-    QString backupFilePath;
-    if (config()->get(Config::BackupBeforeSave).toBool()) {
-        backupFilePath = config()->get(Config::BackupFilePathPattern).toString();
-        // Fall back to default
-        if (backupFilePath.isEmpty()) {
-            backupFilePath = config()->getDefault(Config::BackupFilePathPattern).toString();
-        }
-
-        QFileInfo dbFileInfo(m_db->filePath());
-        backupFilePath = Tools::substituteBackupFilePath(backupFilePath, dbFileInfo.canonicalFilePath());
-        if (!backupFilePath.isNull()) {
-            // Note that we cannot guarantee that backupFilePath is actually a valid filename. QT currently provides
-            // no function for this. Moreover, we don't check if backupFilePath is a file and not a directory.
-            // If this isn't the case, just let the backup fail.
-            if (QDir::isRelativePath(backupFilePath)) {
-                backupFilePath = QDir::cleanPath(dbFileInfo.absolutePath() + QDir::separator() + backupFilePath);
-            }
-        }
-    }
+    auto saveAction = this->saveAction();
+    auto backupFilePath = this->backupFilePath();
 
     bool ok;
     if (fileName.isEmpty()) {
@@ -2412,6 +2379,116 @@ bool DatabaseWidget::performSave(QString& errorMessage, const QString& fileName)
     return ok;
 }
 
+/**
+ * Save the database in the background while it stays editable. Used for
+ * autosaves, errors are reported once the save has finished.
+ */
+void DatabaseWidget::autosave()
+{
+    // Never allow saving a locked database; it causes corruption
+    if (isLocked()) {
+        return;
+    }
+
+    // Read-only and new databases ask for filename
+    if (m_db->filePath().isEmpty()) {
+        save();
+        return;
+    }
+
+    QString errorMessage;
+    if (!m_db->saveInBackground(saveAction(), backupFilePath(), &errorMessage)) {
+        onBackgroundSaveFinished(false, errorMessage);
+        return;
+    }
+
+    m_autosaveTimer->stop(); // stop autosave delay to avoid triggering another save
+}
+
+void DatabaseWidget::onBackgroundSaveFinished(bool ok, const QString& errorMessage)
+{
+    if (ok) {
+        m_saveAttempts = 0;
+        return;
+    }
+
+    // Don't retry on the modification caused by the failed save
+    m_blockAutoSave = true;
+    ++m_saveAttempts;
+
+    if (askToDisableSafeSaves()) {
+        save();
+        return;
+    }
+
+    showMessage(tr("Writing the database failed: %1").arg(errorMessage),
+                MessageWidget::Error,
+                true,
+                MessageWidget::LongAutoHideTimeout);
+}
+
+/**
+ * Ask to disable safe saves after saving failed 3 times with them.
+ *
+ * @return true if safe saves were disabled and the save should be retried
+ */
+bool DatabaseWidget::askToDisableSafeSaves()
+{
+    if (m_saveAttempts <= 2 || !config()->get(Config::UseAtomicSaves).toBool()) {
+        return false;
+    }
+
+    // Saving failed 3 times, issue a warning and attempt to resolve
+    auto result = MessageBox::question(this,
+                                       tr("Disable safe saves?"),
+                                       tr("KeePassXC has failed to save the database multiple times. "
+                                          "This is likely caused by file sync services holding a lock on "
+                                          "the save file.\nDisable safe saves and try again?"),
+                                       MessageBox::Disable | MessageBox::Cancel,
+                                       MessageBox::Disable);
+    if (result != MessageBox::Disable) {
+        return false;
+    }
+    config()->set(Config::UseAtomicSaves, false);
+    return true;
+}
+
+Database::SaveAction DatabaseWidget::saveAction() const
+{
+    if (config()->get(Config::UseAtomicSaves).toBool()) {
+        return Database::Atomic;
+    }
+    if (config()->get(Config::UseDirectWriteSaves).toBool()) {
+        return Database::DirectWrite;
+    }
+    return Database::TempFile;
+}
+
+QString DatabaseWidget::backupFilePath() const
+{
+    if (!config()->get(Config::BackupBeforeSave).toBool()) {
+        return {};
+    }
+
+    QString backupFilePath = config()->get(Config::BackupFilePathPattern).toString();
+    // Fall back to default
+    if (backupFilePath.isEmpty()) {
+        backupFilePath = config()->getDefault(Config::BackupFilePathPattern).toString();
+    }
+
+    QFileInfo dbFileInfo(m_db->filePath());
+    backupFilePath = Tools::substituteBackupFilePath(backupFilePath, dbFileInfo.canonicalFilePath());
+    if (!backupFilePath.isNull()) {
+        // Note that we cannot guarantee that backupFilePath is actually a valid filename. QT currently provides
+        // no function for this. Moreover, we don't check if backupFilePath is a file and not a directory.
+        // If this isn't the case, just let the backup fail.
+        if (QDir::isRelativePath(backupFilePath)) {
+            backupFilePath = QDir::cleanPath(dbFileInfo.absolutePath() + QDir::separator() + backupFilePath);
+        }
+    }
+    return backupFilePath;
+}
+
 /**
  * Save copy of database under a new user-selected filename.
  *
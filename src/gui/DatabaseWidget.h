@@ -272,6 +272,7 @@ private slots:
     void onDatabaseModified();
     void onDatabaseNonDataChanged();
     void onAutosaveDelayTimeout();
+    void onBackgroundSaveFinished(bool ok, const QString& errorMessage);
     void connectDatabaseSignals();
     void loadDatabase(bool accepted);
     void unlockDatabase(bool accepted);
@@ -291,6 +292,10 @@ private:
     void openDatabaseFromEntry(const Entry* entry, bool inBackground = true);
     void performIconDownloads(const QList<Entry*>& entries, bool force = false, bool downloadInBackground = false);
     bool performSave(QString& errorMessage, const QString& fileName = {});
+    bool askToDisableSafeSaves();
+    void autosave();
+    Database::SaveAction saveAction() const;
+    QString backupFilePath() const;
 
     QSharedPointer<Database> m_db;
 
@@ -22,6 +22,7 @@
 #include "Application.h"
 #include "core/Clock.h"
 #include "core/Config.h"
+#include "core/GroupSettingsCache.h"
 #include "core/Totp.h"
 #include "gui/Font.h"
 #include "gui/Icons.h"
@@ -501,10 +502,17 @@ void EntryPreviewWidget::updateGroupHeaderLine()
 void EntryPreviewWidget::updateGroupGeneralTab()
 {
     Q_ASSERT(m_currentGroup);
-    const QString searchingText = m_currentGroup->resolveSearchingEnabled() ? tr("Enabled") : tr("Disabled");
+    EffectiveGroupSettings settings;
+    if (const auto db = m_currentGroup->database()) {
+        settings = db->groupSettingsCache()->settings(m_currentGroup);
+    } else {
+        settings.searchingEnabled = m_currentGroup->resolveSearchingEnabled();
+        settings.autoTypeEnabled = m_currentGroup->resolveAutoTypeEnabled();
+    }
+    const QString searchingText = settings.searchingEnabled ? tr("Enabled") : tr("Disabled");
     m_ui->groupSearchingLabel->setText(searchingText);
 
-    const QString autotypeText = m_currentGroup->resolveAutoTypeEnabled() ? tr("Enabled") : tr("Disabled");
+    const QString autotypeText = settings.autoTypeEnabled ? tr("Enabled") : tr("Disabled");
     m_ui->groupAutotypeLabel->setText(autotypeText);
 
     const TimeInfo groupTime = m_currentGroup->timeInfo();
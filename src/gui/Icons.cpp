@@ -27,6 +27,7 @@
 #include "config-keepassx.h"
 #include "core/Config.h"
 #include "core/Database.h"
+#include "gui/CustomIconCache.h"
 #include "gui/DatabaseIcons.h"
 #include "gui/MainWindow.h"
 #include "gui/osutils/OSUtils.h"
@@ -215,10 +216,37 @@ QPixmap Icons::customIconPixmap(const Database* db, const QUuid& uuid, IconSize
     if (!db->metadata()->hasCustomIcon(uuid)) {
         return {};
     }
-    // Generate QIcon with pre-baked resolutions
-    auto icon = QImage::fromData(db->metadata()->customIcon(uuid).data);
-    auto basePixmap = QPixmap::fromImage(icon.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-    return QIcon(basePixmap).pixmap(databaseIcons()->iconSize(size));
+    return instance()->customIconCache(db)->pixmap(uuid, size);
+}
+
+/**
+ * Decode all custom icons of the database in the background,
+ * so the views do not have to decode them while painting.
+ *
+ * @param db database that was just unlocked
+ */
+void Icons::preloadCustomIcons(const Database* db)
+{
+    if (db && !db->metadata()->customIconsOrder().isEmpty()) {
+        instance()->customIconCache(db)->preload();
+    }
+}
+
+CustomIconCache* Icons::customIconCache(const Database* db)
+{
+    auto cache = m_customIconCaches.value(db);
+    if (!cache) {
+        cache = new CustomIconCache(db);
+        m_customIconCaches.insert(db, cache);
+        QObject::connect(db, &QObject::destroyed, cache, [this, db] {
+            // Another database may be created at the same address before the cache is deleted
+            auto cache = m_customIconCaches.take(db);
+            if (cache) {
+                cache->deleteLater();
+            }
+        });
+    }
+    return cache;
 }
 
 QHash<QUuid, QPixmap> Icons::customIconsPixmaps(const Database* db, IconSize size)
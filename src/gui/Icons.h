@@ -24,6 +24,8 @@
 #include <core/Database.h>
 #include <gui/DatabaseIcons.h>
 
+class CustomIconCache;
+
 class Icons
 {
 public:
@@ -38,6 +40,7 @@ public:
     static QHash<QUuid, QPixmap> customIconsPixmaps(const Database* db, IconSize size = IconSize::Default);
     static QPixmap entryIconPixmap(const Entry* entry, IconSize size = IconSize::Default);
     static QPixmap groupIconPixmap(const Group* group, IconSize size = IconSize::Default);
+    static void preloadCustomIcons(const Database* db);
 
     static QByteArray saveToBytes(const QImage& image);
     static QString imageFormatsFilter();
@@ -47,9 +50,12 @@ public:
 private:
     Icons();
 
+    CustomIconCache* customIconCache(const Database* db);
+
     static Icons* m_instance;
 
     QHash<QString, QIcon> m_iconCache;
+    QHash<const Database*, CustomIconCache*> m_customIconCaches;
 
     Q_DISABLE_COPY(Icons)
 };
@@ -23,14 +23,13 @@
 #include "core/Global.h"
 #include "core/Metadata.h"
 #include "crypto/kdf/Argon2Kdf.h"
+#include "crypto/kdf/KdfBenchmark.h"
 #include "format/KeePass2.h"
 #include "format/KeePass2Writer.h"
 #include "gui/MessageBox.h"
 
 #include <QPushButton>
 
-const char* DatabaseSettingsWidgetEncryption::CD_DECRYPTION_TIME_PREFERENCE_KEY = "KPXC_DECRYPTION_TIME_PREFERENCE";
-
 #define IS_ARGON2(uuid) (uuid == KeePass2::KDF_ARGON2D || uuid == KeePass2::KDF_ARGON2ID)
 #define IS_AES_KDF(uuid) (uuid == KeePass2::KDF_AES_KDBX3 || uuid == KeePass2::KDF_AES_KDBX4)
 
@@ -51,7 +50,11 @@ DatabaseSettingsWidgetEncryption::DatabaseSettingsWidgetEncryption(QWidget* pare
 {
     m_ui->setupUi(this);
 
-    connect(m_ui->transformBenchmarkButton, SIGNAL(clicked()), SLOT(benchmarkTransformRounds()));
+    connect(m_ui->transformBenchmarkButton, &QToolButton::clicked, this, [this] {
+        // An explicit benchmark measures again, e.g. after a hardware or power mode change
+        KdfBenchmark::clearCache();
+        benchmarkTransformRounds();
+    });
     connect(m_ui->kdfComboBox, SIGNAL(currentIndexChanged(int)), SLOT(updateKdfFields()));
     connect(m_ui->compatibilitySelection, SIGNAL(currentIndexChanged(int)), SLOT(loadKdfAlgorithms()));
     m_ui->formatCannotBeChanged->setVisible(false);
@@ -75,6 +78,7 @@ DatabaseSettingsWidgetEncryption::DatabaseSettingsWidgetEncryption(QWidget* pare
 
     // Conditions under which a key re-transformation is needed
     connect(m_ui->decryptionTimeSlider, SIGNAL(valueChanged(int)), SLOT(markDirty()));
+    connect(m_ui->tuneKdfCheckBox, SIGNAL(toggled(bool)), SLOT(markDirty()));
     connect(m_ui->compatibilitySelection, SIGNAL(currentIndexChanged(int)), SLOT(markDirty()));
     connect(m_ui->algorithmComboBox, SIGNAL(currentIndexChanged(int)), SLOT(markDirty()));
     connect(m_ui->kdfComboBox, SIGNAL(currentIndexChanged(int)), SLOT(markDirty()));
@@ -119,8 +123,8 @@ void DatabaseSettingsWidgetEncryption::initialize()
     // and set the slider to it, otherwise just state that the time is unchanged
     // (we cannot infer the time from the raw KDF settings)
     auto* cd = m_db->metadata()->customData();
-    if (cd->hasKey(CD_DECRYPTION_TIME_PREFERENCE_KEY)) {
-        int decryptionTime = qMax(100, cd->value(CD_DECRYPTION_TIME_PREFERENCE_KEY).toInt());
+    if (cd->hasKey(CustomData::DecryptionTimePreference)) {
+        int decryptionTime = qMax(100, cd->value(CustomData::DecryptionTimePreference).toInt());
         showBasicEncryption(decryptionTime);
     } else if (isNewDatabase) {
         showBasicEncryption();
@@ -284,8 +288,17 @@ bool DatabaseSettingsWidgetEncryption::saveSettings()
         QApplication::setOverrideCursor(Qt::BusyCursor);
 
         int time = m_ui->decryptionTimeSlider->value() * 100;
-        int rounds = AsyncTask::runAndWaitForFuture([&kdf, time]() { return kdf->benchmark(time); });
-        kdf->setRounds(rounds);
+        auto argon2Kdf = kdf.dynamicCast<Argon2Kdf>();
+        bool tuned = false;
+        if (argon2Kdf && m_ui->tuneKdfCheckBox->isChecked()) {
+            tuned = AsyncTask::runAndWaitForFuture(
+                [&argon2Kdf, time]() { return KdfBenchmark::tuneArgon2(*argon2Kdf, time).isValid(); });
+        }
+        if (!tuned) {
+            // Also calibrates the rounds for the memory and parallelism left by a failed tuning
+            int rounds = AsyncTask::runAndWaitForFuture([&kdf, time]() { return kdf->benchmark(time); });
+            kdf->setRounds(rounds);
+        }
 
         // TODO: we should probably use AsyncTask::runAndWaitForFuture() here,
         //       but not without making Database thread-safe
@@ -293,7 +306,7 @@ bool DatabaseSettingsWidgetEncryption::saveSettings()
 
         QApplication::restoreOverrideCursor();
 
-        m_db->metadata()->customData()->set(CD_DECRYPTION_TIME_PREFERENCE_KEY, QString("%1").arg(time));
+        m_db->metadata()->customData()->set(CustomData::DecryptionTimePreference, QString("%1").arg(time));
 
         return ok;
     }
@@ -336,7 +349,7 @@ bool DatabaseSettingsWidgetEncryption::saveSettings()
 
     // remove a stored decryption time from custom data when advanced settings are used
     // we don't know it until we actually run the KDF
-    m_db->metadata()->customData()->remove(CD_DECRYPTION_TIME_PREFERENCE_KEY);
+    m_db->metadata()->customData()->remove(CustomData::DecryptionTimePreference);
 
     // Save kdf parameters
     auto kdf = KeePass2::uuidToKdf(kdfChoice);
@@ -64,7 +64,6 @@ private:
         KDBX4,
         KDBX3
     };
-    static const char* CD_DECRYPTION_TIME_PREFERENCE_KEY;
 
     bool m_isDirty = false;
     bool m_initWithAdvanced = false;
@@ -91,20 +91,22 @@ void DatabaseSettingsWidgetMaintenance::removeSingleCustomIcon(QSharedPointer<Da
 {
     QUuid iconUuid = m_customIconModel->uuidFromIndex(index);
 
-    const QList<Entry*> allEntries = database->rootGroup()->entriesRecursive(true);
     QList<Entry*> entriesWithSelectedIcon;
-    QList<Entry*> historicEntriesWithSelectedIcon;
+    QList<Entry*> entriesWithSelectedIconInHistory;
 
-    for (Entry* entry : allEntries) {
+    database->rootGroup()->forEachEntry([&](Entry* entry) {
         if (iconUuid == entry->iconUuid()) {
-            // Check if this is a history entry (no assigned group)
-            if (!entry->group()) {
-                historicEntriesWithSelectedIcon << entry;
-            } else {
-                entriesWithSelectedIcon << entry;
-            }
+            entriesWithSelectedIcon << entry;
         }
-    }
+        // Only the history of entries that use the icon is materialized later on
+        entry->forEachHistoryItem([&](const Entry* historyItem) {
+            if (iconUuid == historyItem->iconUuid()) {
+                entriesWithSelectedIconInHistory << entry;
+                return false;
+            }
+            return true;
+        });
+    });
 
     const QList<Group*> allGroups = database->rootGroup()->groupsRecursive(true);
     QList<Group*> groupsWithSameIcon;
@@ -145,10 +147,14 @@ void DatabaseSettingsWidgetMaintenance::removeSingleCustomIcon(QSharedPointer<Da
     }
 
     // Remove the icon from history entries
-    for (Entry* entry : asConst(historicEntriesWithSelectedIcon)) {
-        entry->setUpdateTimeinfo(false);
-        entry->setIcon(0);
-        entry->setUpdateTimeinfo(true);
+    for (Entry* entry : asConst(entriesWithSelectedIconInHistory)) {
+        for (Entry* historyItem : entry->historyItems()) {
+            if (iconUuid == historyItem->iconUuid()) {
+                historyItem->setUpdateTimeinfo(false);
+                historyItem->setIcon(0);
+                historyItem->setUpdateTimeinfo(true);
+            }
+        }
     }
 
     // Remove the icon from the database
@@ -162,21 +168,20 @@ void DatabaseSettingsWidgetMaintenance::purgeUnusedCustomIcons()
         return;
     }
 
-    QList<Entry*> historyEntries;
-    QSet<QUuid> historicIcons;
+    // Entries by the icons used in their history
+    QHash<QUuid, QSet<Entry*>> historicIcons;
     QSet<QUuid> iconsInUse;
 
-    const QList<Entry*> allEntries = database->rootGroup()->entriesRecursive(true);
-    for (Entry* entry : allEntries) {
-        if (!entry->group()) {
-            // Icons exclusively in use by historic entries (no
-            // group assigned) are also purged from the database
-            historyEntries << entry;
-            historicIcons << entry->iconUuid();
-        } else {
-            iconsInUse << entry->iconUuid();
-        }
-    }
+    database->rootGroup()->forEachEntry([&](Entry* entry) {
+        iconsInUse << entry->iconUuid();
+        // Icons exclusively in use by historic entries are also purged from the database
+        entry->forEachHistoryItem([&](const Entry* historyItem) {
+            if (!historyItem->iconUuid().isNull()) {
+                historicIcons[historyItem->iconUuid()].insert(entry);
+            }
+            return true;
+        });
+    });
 
     const QList<Group*> allGroups = database->rootGroup()->groupsRecursive(true);
     for (Group* group : allGroups) {
@@ -190,9 +195,10 @@ void DatabaseSettingsWidgetMaintenance::purgeUnusedCustomIcons()
             continue;
         }
 
-        if (historicIcons.contains(iconUuid)) {
-            // Remove the icon from history entries using this icon
-            for (Entry* historicEntry : asConst(historyEntries)) {
+        // Remove the icon from history entries using this icon
+        const auto historyOwners = historicIcons.value(iconUuid);
+        for (Entry* entry : historyOwners) {
+            for (Entry* historicEntry : entry->historyItems()) {
                 if (historicEntry->iconUuid() != iconUuid) {
                     continue;
                 }
@@ -887,7 +887,7 @@ void EditEntryWidget::loadEntry(Entry* entry,
     setReadOnly(m_history);
 
     setCurrentPage(0);
-    setPageHidden(m_historyWidget, m_history || m_entry->historyItems().count() < 1);
+    setPageHidden(m_historyWidget, m_history || m_entry->historyCount() < 1);
 #ifdef WITH_XC_SSHAGENT
     setPageHidden(m_sshAgentWidget, !sshAgent()->isEnabled());
 #endif
@@ -1188,7 +1188,7 @@ bool EditEntryWidget::commitEntry()
     // End entry update
 
     m_historyModel->setEntries(m_entry->historyItems(), m_entry);
-    setPageHidden(m_historyWidget, m_history || m_entry->historyItems().count() < 1);
+    setPageHidden(m_historyWidget, m_history || m_entry->historyCount() < 1);
     m_advancedUi->attachmentsWidget->linkAttachments(m_entry->attachments());
 
     showMessage(tr("Entry updated successfully."), MessageWidget::Positive);
@@ -137,7 +137,7 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             }
             break;
         case Title:
-            result = entry->resolveMultiplePlaceholders(entry->title());
+            result = entry->resolvedAttribute(EntryAttributes::TitleKey);
             if (attr->isReference(EntryAttributes::TitleKey)) {
                 result.prepend(tr("Ref: ", "Reference abbreviation"));
             }
@@ -146,7 +146,7 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             if (config()->get(Config::GUI_HideUsernames).toBool()) {
                 result = EntryModel::HiddenContentDisplay;
             } else {
-                result = entry->resolveMultiplePlaceholders(entry->username());
+                result = entry->resolvedAttribute(EntryAttributes::UserNameKey);
             }
             if (attr->isReference(EntryAttributes::UserNameKey)) {
                 result.prepend(tr("Ref: ", "Reference abbreviation"));
@@ -159,7 +159,7 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             if (config()->get(Config::GUI_HidePasswords).toBool()) {
                 result = EntryModel::HiddenContentDisplay;
             } else {
-                result = entry->resolveMultiplePlaceholders(entry->password());
+                result = entry->resolvedAttribute(EntryAttributes::PasswordKey);
             }
             if (attr->isReference(EntryAttributes::PasswordKey)) {
                 result.prepend(tr("Ref: ", "Reference abbreviation"));
@@ -240,9 +240,9 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
     } else if (role == Qt::UserRole) { // Qt::UserRole is used as sort role, see EntryView::EntryView()
         switch (index.column()) {
         case Username:
-            return entry->resolveMultiplePlaceholders(entry->username());
+            return entry->resolvedAttribute(EntryAttributes::UserNameKey);
         case Password:
-            return entry->resolveMultiplePlaceholders(entry->password());
+            return entry->resolvedAttribute(EntryAttributes::PasswordKey);
         case PasswordStrength: {
             if (!entry->password().isEmpty() && !entry->excludeFromReports()) {
                 return entry->passwordHealth()->score();
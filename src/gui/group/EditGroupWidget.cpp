@@ -24,6 +24,7 @@
 #endif
 
 #include "core/Config.h"
+#include "core/GroupSettingsCache.h"
 #include "core/Metadata.h"
 #include "gui/EditWidgetIcons.h"
 #include "gui/EditWidgetProperties.h"
@@ -152,8 +153,9 @@ void EditGroupWidget::loadGroup(Group* group, bool create, const QSharedPointer<
     }
 
     if (m_group->parentGroup()) {
-        addTriStateItems(m_mainUi->searchComboBox, m_group->parentGroup()->resolveSearchingEnabled());
-        addTriStateItems(m_mainUi->autotypeComboBox, m_group->parentGroup()->resolveAutoTypeEnabled());
+        const auto parentSettings = m_db->groupSettingsCache()->settings(m_group->parentGroup());
+        addTriStateItems(m_mainUi->searchComboBox, parentSettings.searchingEnabled);
+        addTriStateItems(m_mainUi->autotypeComboBox, parentSettings.autoTypeEnabled);
     } else {
         addTriStateItems(m_mainUi->searchComboBox, true);
         addTriStateItems(m_mainUi->autotypeComboBox, true);
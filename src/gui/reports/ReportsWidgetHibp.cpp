@@ -124,14 +124,14 @@ void ReportsWidgetHibp::makeHibpTable()
 
     // Search database for passwords that we've found so far
     QList<QPair<Entry*, int>> items;
-    for (auto entry : m_db->rootGroup()->entriesRecursive()) {
-        if (!entry->isRecycled()) {
+    m_db->rootGroup()->forEachEntry(
+        [this, &items](Entry* entry) {
             const auto found = m_pwndPasswords.find(entry->password());
             if (found != m_pwndPasswords.end()) {
                 items.append({entry, found.value()});
             }
-        }
-    }
+        },
+        Group::SkipRecycled);
 
     // Sort descending by the number the password has been exposed
     std::sort(items.begin(), items.end(), [](QPair<Entry*, int>& lhs, QPair<Entry*, int>& rhs) {
@@ -253,11 +253,13 @@ void ReportsWidgetHibp::startValidation()
     // Collect all passwords in the database (unless recycled, and
     // unless empty, and unless marked as "known bad") and submit them
     // to the downloader.
-    for (const auto* entry : m_db->rootGroup()->entriesRecursive()) {
-        if (!entry->isRecycled() && !entry->password().isEmpty()) {
-            m_downloader.add(entry->password());
-        }
-    }
+    m_db->rootGroup()->forEachEntry(
+        [this](const Entry* entry) {
+            if (!entry->password().isEmpty()) {
+                m_downloader.add(entry->password());
+            }
+        },
+        Group::SkipRecycled);
 
     // Short circuit if we didn't actually add any passwords
     if (m_downloader.passwordsToValidate() == 0) {
@@ -26,6 +26,7 @@
 #include "keys/PasswordKey.h"
 
 #include <QDataStream>
+#include <QElapsedTimer>
 #include <QDebug>
 
 QUuid CompositeKey::UUID("76a7ae25-a542-4add-9849-7c06be945b94");
@@ -116,19 +117,33 @@ QByteArray CompositeKey::rawKey(const QByteArray* transformSeed, bool* ok, QStri
  *
  * @param kdf key derivation function
  * @param result transformed key hash
+ * @param transformTime if set, receives the time in ms the KDF took without the challenge-response
  * @return true on success
  */
-bool CompositeKey::transform(const Kdf& kdf, QByteArray& result, QString* error) const
+bool CompositeKey::transform(const Kdf& kdf, QByteArray& result, QString* error, qint64* transformTime) const
 {
+    QByteArray key;
     if (kdf.uuid() == KeePass2::KDF_AES_KDBX3) {
         // legacy KDBX3 AES-KDF, challenge response is added later to the hash
-        return kdf.transform(rawKey(), result);
+        key = rawKey();
+    } else {
+        QByteArray seed = kdf.seed();
+        Q_ASSERT(!seed.isEmpty());
+        bool ok = false;
+        // The challenge-response may wait for the user, it is not part of the transform time
+        key = rawKey(&seed, &ok, error);
+        if (!ok) {
+            return false;
+        }
     }
 
-    QByteArray seed = kdf.seed();
-    Q_ASSERT(!seed.isEmpty());
-    bool ok = false;
-    return kdf.transform(rawKey(&seed, &ok, error), result) && ok;
+    QElapsedTimer timer;
+    timer.start();
+    const bool transformed = kdf.transform(key, result);
+    if (transformTime) {
+        *transformTime = timer.elapsed();
+    }
+    return transformed;
 }
 
 bool CompositeKey::challenge(const QByteArray& seed, QByteArray& result, QString* error) const
@@ -39,7 +39,8 @@ public:
     QByteArray rawKey() const override;
     void setRawKey(const QByteArray& data) override;
 
-    Q_REQUIRED_RESULT bool transform(const Kdf& kdf, QByteArray& result, QString* error = nullptr) const;
+    Q_REQUIRED_RESULT bool
+    transform(const Kdf& kdf, QByteArray& result, QString* error = nullptr, qint64* transformTime = nullptr) const;
     bool challenge(const QByteArray& seed, QByteArray& result, QString* error = nullptr) const;
 
     void addKey(const QSharedPointer<Key>& key);
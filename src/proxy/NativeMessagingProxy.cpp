@@ -19,6 +19,7 @@
 #include "browser/BrowserShared.h"
 
 #include <QCoreApplication>
+#include <QFile>
 #include <QFuture>
 #include <QtConcurrent/qtconcurrentrun.h>
 
@@ -57,41 +58,45 @@ void NativeMessagingProxy::setupStandardInput()
 #endif
 #endif
 
+    // Blocking reads return as soon as the browser sent a message, unbuffered so a read
+    // never waits for more data than the frame contains
     QtConcurrent::run([this] {
-        while (std::cin.good()) {
-            if (std::cin.peek() != EOF) {
-                uint length = 0;
-                for (uint i = 0; i < sizeof(uint); ++i) {
-                    length |= getchar() << (i * 8);
-                }
-
-                QString msg;
-                msg.reserve(length);
-                for (uint i = 0; i < length; ++i) {
-                    msg.append(getchar());
-                }
-
-                if (msg.length() > 0) {
+        QFile input;
+        if (input.open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            QByteArray msg;
+            while (BrowserShared::readNativeMessage(&input, msg)) {
+                if (!msg.isEmpty()) {
                     emit stdinMessage(msg);
                 }
             }
-            QThread::msleep(100);
         }
         QCoreApplication::quit();
     });
 }
 
-void NativeMessagingProxy::transferStdinMessage(const QString& msg)
+void NativeMessagingProxy::transferStdinMessage(const QByteArray& msg)
 {
-    if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->write(msg.toUtf8(), msg.length());
-        m_localSocket->flush();
+    if (!m_localSocket || m_localSocket->state() != QLocalSocket::ConnectedState) {
+        return;
     }
+
+    if (m_framing == Framing::Unknown) {
+        m_pendingMessages << msg;
+        return;
+    }
+    writeSocketMessage(msg);
+}
+
+void NativeMessagingProxy::writeSocketMessage(const QByteArray& msg)
+{
+    m_localSocket->write(m_framing == Framing::Unframed ? msg : BrowserShared::frameNativeMessage(msg));
+    m_localSocket->flush();
 }
 
 void NativeMessagingProxy::setupLocalSocket()
 {
     m_localSocket.reset(new QLocalSocket());
+    connect(m_localSocket.data(), SIGNAL(connected()), this, SLOT(socketConnected()));
     m_localSocket->connectToServer(BrowserShared::localServerPath());
     m_localSocket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
     int socketDesc = m_localSocket->socketDescriptor();
@@ -104,16 +109,90 @@ void NativeMessagingProxy::setupLocalSocket()
     connect(m_localSocket.data(), SIGNAL(disconnected()), this, SLOT(socketDisconnected()));
 }
 
+void NativeMessagingProxy::socketConnected()
+{
+    // Ask whether KeePassXC frames its messages, the browser messages wait for the reply
+    m_localSocket->write(BrowserShared::proxyHelloMessage());
+    m_localSocket->flush();
+}
+
+/**
+ * Detect the framing from the reply to the hello and send the browser messages received until then.
+ *
+ * @return false if the reply is incomplete or invalid
+ */
+bool NativeMessagingProxy::detectFraming()
+{
+    if (m_socketBuffer.size() < static_cast<int>(sizeof(quint32))) {
+        return false;
+    }
+
+    const auto maxLength = BrowserShared::NATIVEMSG_MAX_LENGTH;
+    const auto frameSize = BrowserShared::nativeMessageFrameSize(m_socketBuffer, 0, maxLength);
+    if (m_socketBuffer.startsWith('{') && frameSize < 0) {
+        // Older versions reply with a bare error, which is not passed to the browser
+        m_framing = Framing::Unframed;
+        if (BrowserShared::isProxyHello(m_socketBuffer)) {
+            m_socketBuffer.clear();
+        }
+    } else if (frameSize > 0) {
+        m_framing = Framing::LengthPrefixed;
+        m_socketBuffer.remove(0, frameSize);
+    } else {
+        if (frameSize < 0) {
+            qWarning("Invalid message length received from KeePassXC");
+            QCoreApplication::quit();
+        }
+        return false;
+    }
+
+    const auto pending = m_pendingMessages;
+    m_pendingMessages.clear();
+    for (const auto& msg : pending) {
+        writeSocketMessage(msg);
+    }
+    return true;
+}
+
 void NativeMessagingProxy::transferSocketMessage()
 {
-    auto msg = m_localSocket->readAll();
-    if (!msg.isEmpty()) {
-        // Explicitly write the message length as 1 byte chunks
-        uint len = msg.size();
-        std::cout.write(reinterpret_cast<char*>(&len), sizeof(len));
-
-        // Write the message and flush the stream
-        std::cout << msg.toStdString() << std::flush;
+    m_socketBuffer.append(m_localSocket->readAll());
+    if (m_framing == Framing::Unknown && !detectFraming()) {
+        return;
+    }
+
+    if (m_framing == Framing::Unframed) {
+        // Every read is passed on as one message, like before the framing
+        if (!m_socketBuffer.isEmpty()) {
+            const auto frame = BrowserShared::frameNativeMessage(m_socketBuffer);
+            std::cout.write(frame.constData(), frame.size());
+            std::cout.flush();
+            m_socketBuffer.clear();
+        }
+        return;
+    }
+
+    // Messages from KeePassXC are framed like native messages, pass on the complete ones
+    int offset = 0;
+    while (true) {
+        const auto frameSize =
+            BrowserShared::nativeMessageFrameSize(m_socketBuffer, offset, BrowserShared::NATIVEMSG_MAX_LENGTH);
+        if (frameSize < 0) {
+            qWarning("Invalid message length received from KeePassXC");
+            QCoreApplication::quit();
+            return;
+        }
+        if (frameSize == 0) {
+            break;
+        }
+
+        std::cout.write(m_socketBuffer.constData() + offset, frameSize);
+        offset += frameSize;
+    }
+
+    if (offset > 0) {
+        m_socketBuffer.remove(0, offset);
+        std::cout.flush();
     }
 }
 
@@ -31,19 +31,35 @@ public:
     ~NativeMessagingProxy() override = default;
 
 signals:
-    void stdinMessage(QString msg);
+    void stdinMessage(const QByteArray& msg);
 
 public slots:
     void transferSocketMessage();
-    void transferStdinMessage(const QString& msg);
+    void transferStdinMessage(const QByteArray& msg);
+    void socketConnected();
     void socketDisconnected();
 
 private:
+    enum class Framing
+    {
+        // Waiting for the reply to the hello
+        Unknown,
+        LengthPrefixed,
+        // KeePassXC predates the framing and exchanges bare JSON documents
+        Unframed
+    };
+
     void setupStandardInput();
     void setupLocalSocket();
+    bool detectFraming();
+    void writeSocketMessage(const QByteArray& msg);
 
 private:
     QScopedPointer<QLocalSocket> m_localSocket;
+    QByteArray m_socketBuffer;
+    Framing m_framing = Framing::Unknown;
+    // Browser messages received before the framing is known
+    QList<QByteArray> m_pendingMessages;
 
     Q_DISABLE_COPY(NativeMessagingProxy)
 };
@@ -0,0 +1,305 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PipelineStream.h"
+
+#include <QElapsedTimer>
+
+Q_LOGGING_CATEGORY(lcPipelineStream, "keepassxc.streams.pipeline", QtInfoMsg)
+
+namespace
+{
+    double mibPerSecond(qint64 bytes, qint64 nsecs)
+    {
+        return nsecs > 0 ? bytes / (1024.0 * 1024.0) / (nsecs / 1e9) : 0.0;
+    }
+} // namespace
+
+PipelineStream::PipelineStream(QIODevice* baseDevice, int blockSize, int maxBlocks)
+    : LayeredStream(baseDevice)
+    , m_blockSize(qMax(blockSize, 1))
+    , m_maxBlocks(qMax(maxBlocks, 1))
+{
+}
+
+PipelineStream::~PipelineStream()
+{
+    close();
+}
+
+bool PipelineStream::open(QIODevice::OpenMode mode)
+{
+    if (!LayeredStream::open(mode)) {
+        return false;
+    }
+
+    m_blocks.clear();
+    m_block.clear();
+    m_blockPos = 0;
+    m_busy = false;
+    m_finished = false;
+    m_aborted = false;
+    m_workerError.clear();
+    m_workerBytes = 0;
+    m_workerBusyNs = 0;
+    m_workerWaitNs = 0;
+    m_waitNs = 0;
+
+    if (isWritable()) {
+        m_worker.reset(QThread::create([this] { writeBaseDevice(); }));
+    } else {
+        m_worker.reset(QThread::create([this] { readBaseDevice(); }));
+    }
+    m_worker->start();
+    return true;
+}
+
+/**
+ * In write mode, wait until all data written so far was passed to the base device.
+ *
+ * @return false if the base device failed to write the data
+ */
+bool PipelineStream::reset()
+{
+    if (!isWritable()) {
+        return LayeredStream::reset();
+    }
+
+    if (!enqueueBlock()) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(&m_mutex);
+    while ((!m_blocks.isEmpty() || m_busy) && m_workerError.isEmpty()) {
+        m_spaceAvailable.wait(&m_mutex);
+    }
+    m_waitNs += timer.nsecsElapsed();
+
+    if (!m_workerError.isEmpty()) {
+        setErrorString(m_workerError);
+        return false;
+    }
+    return true;
+}
+
+void PipelineStream::close()
+{
+    if (isWritable()) {
+        enqueueBlock();
+    }
+    stopWorker();
+    LayeredStream::close();
+}
+
+bool PipelineStream::atEnd() const
+{
+    if (m_blockPos < m_block.size()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    return m_finished && m_blocks.isEmpty();
+}
+
+qint64 PipelineStream::readData(char* data, qint64 maxSize)
+{
+    qint64 bytesRead = 0;
+
+    while (bytesRead < maxSize) {
+        if (m_blockPos >= m_block.size()) {
+            QElapsedTimer timer;
+            timer.start();
+
+            QMutexLocker locker(&m_mutex);
+            while (m_blocks.isEmpty() && !m_finished) {
+                m_blockAvailable.wait(&m_mutex);
+            }
+            m_waitNs += timer.nsecsElapsed();
+
+            if (m_blocks.isEmpty()) {
+                if (bytesRead == 0 && !m_workerError.isEmpty()) {
+                    setErrorString(m_workerError);
+                    return -1;
+                }
+                break;
+            }
+            m_block = m_blocks.dequeue();
+            m_blockPos = 0;
+            m_spaceAvailable.wakeOne();
+        }
+
+        qint64 bytesToCopy = qMin(maxSize - bytesRead, static_cast<qint64>(m_block.size() - m_blockPos));
+        memcpy(data + bytesRead, m_block.constData() + m_blockPos, static_cast<size_t>(bytesToCopy));
+        m_blockPos += static_cast<int>(bytesToCopy);
+        bytesRead += bytesToCopy;
+    }
+
+    return bytesRead;
+}
+
+qint64 PipelineStream::writeData(const char* data, qint64 maxSize)
+{
+    qint64 bytesWritten = 0;
+
+    while (bytesWritten < maxSize) {
+        if (m_block.size() >= m_blockSize && !enqueueBlock()) {
+            return -1;
+        }
+
+        qint64 bytesToCopy = qMin(maxSize - bytesWritten, static_cast<qint64>(m_blockSize - m_block.size()));
+        m_block.append(data + bytesWritten, static_cast<int>(bytesToCopy));
+        bytesWritten += bytesToCopy;
+    }
+
+    return bytesWritten;
+}
+
+/**
+ * Hand the block collected by writeData() over to the worker,
+ * waits while the queue is full.
+ *
+ * @return false if the worker failed to write previous blocks
+ */
+bool PipelineStream::enqueueBlock()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(&m_mutex);
+    while (m_blocks.size() >= m_maxBlocks && m_workerError.isEmpty()) {
+        m_spaceAvailable.wait(&m_mutex);
+    }
+    m_waitNs += timer.nsecsElapsed();
+
+    if (!m_workerError.isEmpty()) {
+        setErrorString(m_workerError);
+        return false;
+    }
+
+    if (!m_block.isEmpty()) {
+        m_blocks.enqueue(m_block);
+        m_block.clear();
+        m_blockAvailable.wakeOne();
+    }
+    return true;
+}
+
+void PipelineStream::readBaseDevice()
+{
+    QElapsedTimer timer;
+
+    while (true) {
+        timer.start();
+        QByteArray block(m_blockSize, Qt::Uninitialized);
+        qint64 bytesRead = m_baseDevice->read(block.data(), block.size());
+        m_workerBusyNs += timer.nsecsElapsed();
+
+        timer.start();
+        QMutexLocker locker(&m_mutex);
+        if (m_aborted) {
+            return;
+        }
+        if (bytesRead <= 0) {
+            if (bytesRead < 0) {
+                m_workerError = m_baseDevice->errorString();
+            }
+            m_finished = true;
+            m_blockAvailable.wakeAll();
+            return;
+        }
+
+        block.resize(static_cast<int>(bytesRead));
+        m_workerBytes += bytesRead;
+        while (m_blocks.size() >= m_maxBlocks && !m_aborted) {
+            m_spaceAvailable.wait(&m_mutex);
+        }
+        m_workerWaitNs += timer.nsecsElapsed();
+        if (m_aborted) {
+            return;
+        }
+        m_blocks.enqueue(block);
+        m_blockAvailable.wakeOne();
+    }
+}
+
+void PipelineStream::writeBaseDevice()
+{
+    QElapsedTimer timer;
+
+    while (true) {
+        QByteArray block;
+        {
+            timer.start();
+            QMutexLocker locker(&m_mutex);
+            while (m_blocks.isEmpty() && !m_finished) {
+                m_blockAvailable.wait(&m_mutex);
+            }
+            m_workerWaitNs += timer.nsecsElapsed();
+            if (m_blocks.isEmpty()) {
+                return;
+            }
+            block = m_blocks.dequeue();
+            m_busy = true;
+            m_spaceAvailable.wakeAll();
+        }
+
+        timer.start();
+        bool ok = m_baseDevice->write(block) == block.size();
+        m_workerBusyNs += timer.nsecsElapsed();
+        m_workerBytes += block.size();
+
+        QMutexLocker locker(&m_mutex);
+        m_busy = false;
+        if (!ok && m_workerError.isEmpty()) {
+            m_workerError = m_baseDevice->errorString();
+            m_blocks.clear();
+        }
+        m_spaceAvailable.wakeAll();
+    }
+}
+
+void PipelineStream::stopWorker()
+{
+    if (!m_worker) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        // A writing worker still drains the queue, a reading worker stops right away
+        m_finished = true;
+        m_aborted = true;
+        m_blockAvailable.wakeAll();
+        m_spaceAvailable.wakeAll();
+    }
+
+    m_worker->wait();
+    m_worker.reset();
+
+    qCDebug(lcPipelineStream,
+            "%s stage: %lld bytes, busy %lld ms (%.1f MiB/s), stalled %lld ms, %s stalled %lld ms",
+            qPrintable(objectName().isEmpty() ? QStringLiteral("unnamed") : objectName()),
+            m_workerBytes,
+            m_workerBusyNs / 1000000,
+            mibPerSecond(m_workerBytes, m_workerBusyNs),
+            m_workerWaitNs / 1000000,
+            isWritable() ? "producer" : "consumer",
+            m_waitNs / 1000000);
+}
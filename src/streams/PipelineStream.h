@@ -0,0 +1,100 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_PIPELINESTREAM_H
+#define KEEPASSXC_PIPELINESTREAM_H
+
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QQueue>
+#include <QScopedPointer>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "streams/LayeredStream.h"
+
+Q_DECLARE_LOGGING_CATEGORY(lcPipelineStream)
+
+/**
+ * Stream that moves all access to its base device onto a worker thread.
+ *
+ * In read mode the worker reads ahead from the base device into a bounded
+ * queue of blocks, so the layers below this stream (e.g. HMAC verification
+ * and decryption) run concurrently with the consumer of this stream (e.g.
+ * decompression and XML parsing). In write mode written data is collected
+ * into blocks that the worker writes to the base device while the producer
+ * continues. Chaining several pipeline streams turns a stack of layered
+ * streams into a pipeline with one thread per stage.
+ *
+ * The base device must not be accessed by anyone else while this stream is open.
+ *
+ * When the stream is closed, the throughput of the stage is logged to the
+ * keepassxc.streams.pipeline debug category, the stage is named by objectName().
+ */
+class PipelineStream : public LayeredStream
+{
+    Q_OBJECT
+
+public:
+    static const int DefaultBlockSize = 1024 * 1024;
+    static const int DefaultMaxBlocks = 4;
+
+    explicit PipelineStream(QIODevice* baseDevice,
+                            int blockSize = DefaultBlockSize,
+                            int maxBlocks = DefaultMaxBlocks);
+    ~PipelineStream() override;
+
+    bool open(QIODevice::OpenMode mode) override;
+    bool reset() override;
+    void close() override;
+    bool atEnd() const override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    void readBaseDevice();
+    void writeBaseDevice();
+    bool enqueueBlock();
+    void stopWorker();
+
+    const int m_blockSize;
+    const int m_maxBlocks;
+    QScopedPointer<QThread> m_worker;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_blockAvailable;
+    QWaitCondition m_spaceAvailable;
+    QQueue<QByteArray> m_blocks;
+    bool m_busy = false;
+    bool m_finished = false;
+    bool m_aborted = false;
+    QString m_workerError;
+
+    // Only accessed by the worker
+    qint64 m_workerBytes = 0;
+    qint64 m_workerBusyNs = 0;
+    qint64 m_workerWaitNs = 0;
+
+    // Only accessed by the user of the stream
+    QByteArray m_block;
+    int m_blockPos = 0;
+    qint64 m_waitNs = 0;
+};
+
+#endif // KEEPASSXC_PIPELINESTREAM_H
@@ -17,14 +17,22 @@
 
 #include "TestBrowser.h"
 
+#include "browser/BrowserHost.h"
 #include "browser/BrowserMessageBuilder.h"
 #include "browser/BrowserSettings.h"
+#include "browser/BrowserShared.h"
+#include "browser/BrowserUrlIndex.h"
 #include "core/Group.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
 
+#include <QBuffer>
+#include <QJsonDocument>
 #include <QJsonObject>
+#include <QLocalSocket>
+#include <QSignalSpy>
 #include <QTest>
+#include <QUuid>
 
 #include <botan/sodium.h>
 
@@ -396,6 +404,101 @@ void TestBrowser::testSearchEntriesWithAdditionalURLs()
     QCOMPARE(additionalResult[0]->url(), QString("https://github.com/"));
 }
 
+void TestBrowser::testUrlIndex()
+{
+    auto db = QSharedPointer<Database>::create();
+    auto* root = db->rootGroup();
+    auto* group = new Group();
+    group->setParent(root);
+
+    QStringList urls = {"https://github.com/login", "https://www.example.com", "keepassxc.org", "{REF:A@I:1234}"};
+    auto entries = createEntries(urls, root);
+    entries.first()->setGroup(group);
+
+    auto index = BrowserUrlIndex::forDatabase(db.data());
+    QVERIFY(index);
+    QCOMPARE(BrowserUrlIndex::forDatabase(db.data()), index);
+
+    // Placeholder URLs are candidates for every site, the rest only for their base domain.
+    // Candidates are in the order of the group tree, so the entries of the root group come first.
+    bool ok = false;
+    auto candidates = index->candidates("https://gist.github.com", &ok);
+    QVERIFY(ok);
+    QCOMPARE(candidates, QList<Entry*>({entries[3], entries[0]}));
+    candidates = index->candidates("https://example.com", &ok);
+    QCOMPARE(candidates, QList<Entry*>({entries[1], entries[3]}));
+
+    // Local files are not indexed
+    index->candidates("file:///home/user/login.html", &ok);
+    QVERIFY(!ok);
+
+    // Changes to the database are followed
+    entries[1]->setUrl("https://keepassxc.org/download");
+    candidates = index->candidates("https://keepassxc.org", &ok);
+    QCOMPARE(candidates, QList<Entry*>({entries[1], entries[2], entries[3]}));
+    QCOMPARE(index->candidates("https://example.com", &ok), QList<Entry*>({entries[3]}));
+
+    QStringList newUrls = {"https://example.com"};
+    auto newEntry = createEntries(newUrls, group).first();
+    QCOMPARE(index->candidates("https://example.com", &ok), QList<Entry*>({entries[3], newEntry}));
+
+    delete group;
+    QCOMPARE(index->candidates("https://example.com", &ok), QList<Entry*>({entries[3]}));
+    QCOMPARE(index->candidates("https://github.com", &ok), QList<Entry*>({entries[3]}));
+
+    // A snapshot gets a copy of the index that points at its own entries
+    auto snapshot = db->readSnapshot();
+    index->shareWith(snapshot.data());
+    candidates = BrowserUrlIndex::forDatabase(snapshot.data())->candidates("https://keepassxc.org", &ok);
+    QCOMPARE(candidates.size(), 3);
+    QCOMPARE(candidates[0]->uuid(), entries[1]->uuid());
+    QCOMPARE(candidates[0]->database(), snapshot.data());
+
+    // Entry changes are copied into a snapshot nobody holds instead of cloning the database again
+    const auto snapshotData = snapshot.data();
+    snapshot.reset();
+    entries[3]->setUrl("https://github.com");
+    snapshot = db->readSnapshot();
+    QCOMPARE(snapshot.data(), snapshotData);
+    candidates = BrowserUrlIndex::forDatabase(snapshot.data())->candidates("https://github.com", &ok);
+    QCOMPARE(candidates.size(), 1);
+    QCOMPARE(candidates[0]->uuid(), entries[3]->uuid());
+    QCOMPARE(candidates[0]->url(), QString("https://github.com"));
+    QVERIFY(BrowserUrlIndex::forDatabase(snapshot.data())->candidates("https://example.com", &ok).isEmpty());
+
+    // A snapshot that is still held is never changed
+    entries[3]->setUrl("https://example.com");
+    QCOMPARE(candidates[0]->url(), QString("https://github.com"));
+    QVERIFY(db->readSnapshot() != snapshot);
+
+    // Added and removed entries and groups are applied to a snapshot nobody holds as well
+    snapshot = db->readSnapshot();
+    const auto followedSnapshot = snapshot.data();
+    snapshot.reset();
+    auto addedGroup = new Group();
+    addedGroup->setUuid(QUuid::createUuid());
+    auto groupEntry = new Entry();
+    groupEntry->setUuid(QUuid::createUuid());
+    groupEntry->setUrl("https://example.org");
+    groupEntry->setGroup(addedGroup);
+    addedGroup->setParent(db->rootGroup());
+    auto rootEntry = new Entry();
+    rootEntry->setUuid(QUuid::createUuid());
+    rootEntry->setUrl("https://example.org/login");
+    rootEntry->setGroup(db->rootGroup());
+    snapshot = db->readSnapshot();
+    QCOMPARE(snapshot.data(), followedSnapshot);
+    QCOMPARE(BrowserUrlIndex::forDatabase(snapshot.data())->candidates("https://example.org", &ok).size(), 2);
+
+    snapshot.reset();
+    delete addedGroup;
+    snapshot = db->readSnapshot();
+    QCOMPARE(snapshot.data(), followedSnapshot);
+    candidates = BrowserUrlIndex::forDatabase(snapshot.data())->candidates("https://example.org", &ok);
+    QCOMPARE(candidates.size(), 1);
+    QCOMPARE(candidates[0]->uuid(), rootEntry->uuid());
+}
+
 void TestBrowser::testInvalidEntries()
 {
     auto db = QSharedPointer<Database>::create();
@@ -736,3 +839,154 @@ void TestBrowser::testRestrictBrowserKey()
     QCOMPARE(sorted[2]->url(), QString("https://example.com/2"));
     QCOMPARE(sorted[3]->url(), QString("https://example.com/0"));
 }
+
+void TestBrowser::testReadNativeMessage()
+{
+    const QByteArray first = R"({"action":"change-public-keys"})";
+    const QByteArray second = "{\"text\":\"\xc3\xa4\xe2\x82\xac\"}";
+
+    QBuffer input;
+    input.setData(BrowserShared::frameNativeMessage(first) + BrowserShared::frameNativeMessage(second)
+                  + BrowserShared::frameNativeMessage({}) + BrowserShared::frameNativeMessage(first).left(10));
+    QVERIFY(input.open(QIODevice::ReadOnly));
+
+    // Messages are passed on byte for byte, UTF-8 included
+    QByteArray message;
+    QVERIFY(BrowserShared::readNativeMessage(&input, message));
+    QCOMPARE(message, first);
+    QVERIFY(BrowserShared::readNativeMessage(&input, message));
+    QCOMPARE(message, second);
+    QVERIFY(BrowserShared::readNativeMessage(&input, message));
+    QVERIFY(message.isEmpty());
+
+    // A truncated frame ends the input
+    QVERIFY(!BrowserShared::readNativeMessage(&input, message));
+    QVERIFY(!BrowserShared::readNativeMessage(&input, message));
+
+    // An impossible length cannot be skipped
+    const quint32 length = BrowserShared::NATIVEMSG_MAX_INPUT_LENGTH + 1;
+    QBuffer tooLong;
+    tooLong.setData(QByteArray(reinterpret_cast<const char*>(&length), sizeof(length)) + first);
+    QVERIFY(tooLong.open(QIODevice::ReadOnly));
+    QVERIFY(!BrowserShared::readNativeMessage(&tooLong, message));
+}
+
+void TestBrowser::benchmarkProxyRoundTrip()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    const auto serverPath = QString("keepassxc-browser-test-%1").arg(QUuid::createUuid().toString(QUuid::Id128));
+    BrowserHost host;
+    QVERIFY(host.start(serverPath));
+    connect(&host, &BrowserHost::clientMessageReceived, this, [&](QLocalSocket* socket, const QJsonObject& json) {
+        host.sendClientMessage(socket, m_browserAction->processClientMessage(socket, json));
+    });
+
+    // The proxy forwards the messages it reads from the standard input to this socket
+    QLocalSocket proxySocket;
+    proxySocket.connectToServer(serverPath);
+    QVERIFY(proxySocket.waitForConnected());
+    QSignalSpy replySpy(&proxySocket, &QLocalSocket::readyRead);
+
+    QJsonObject request;
+    request["action"] = "change-public-keys";
+    request["publicKey"] = PUBLICKEY;
+    request["nonce"] = NONCE;
+    const auto frame = BrowserShared::frameNativeMessage(QJsonDocument(request).toJson(QJsonDocument::Compact));
+
+    QByteArray reply;
+    QBENCHMARK
+    {
+        QBuffer input;
+        input.setData(frame);
+        input.open(QIODevice::ReadOnly);
+        QByteArray message;
+        QVERIFY(BrowserShared::readNativeMessage(&input, message));
+        proxySocket.write(BrowserShared::frameNativeMessage(message));
+        proxySocket.flush();
+
+        reply.clear();
+        while (BrowserShared::nativeMessageFrameSize(reply, 0, BrowserShared::NATIVEMSG_MAX_LENGTH) == 0) {
+            QVERIFY(replySpy.wait());
+            reply += proxySocket.readAll();
+        }
+    }
+
+    const auto response = QJsonDocument::fromJson(reply.mid(sizeof(quint32))).object();
+    QCOMPARE(response["action"].toString(), QString("change-public-keys"));
+    QCOMPARE(response["success"].toString(), TRUE_STR);
+}
+
+void TestBrowser::testProxyMessageFraming()
+{
+    const auto serverPath = QString("keepassxc-browser-test-%1").arg(QUuid::createUuid().toString(QUuid::Id128));
+    BrowserHost host;
+    QVERIFY(host.start(serverPath));
+    QStringList nonces;
+    connect(&host, &BrowserHost::clientMessageReceived, this, [&](QLocalSocket* socket, const QJsonObject& json) {
+        nonces << json["nonce"].toString();
+        host.sendClientMessage(socket, json);
+    });
+
+    auto frame = [](const QString& nonce) {
+        QJsonObject request;
+        request["action"] = "get-logins";
+        request["nonce"] = nonce;
+        return BrowserShared::frameNativeMessage(QJsonDocument(request).toJson(QJsonDocument::Compact));
+    };
+
+    QLocalSocket proxySocket;
+    proxySocket.connectToServer(serverPath);
+    QVERIFY(proxySocket.waitForConnected());
+
+    // Two messages in one write and a message split across writes
+    const auto split = frame("3");
+    proxySocket.write(frame("1") + frame("2") + split.left(10));
+    proxySocket.flush();
+    QTRY_COMPARE(nonces, QStringList({"1", "2"}));
+    proxySocket.write(split.mid(10));
+    proxySocket.flush();
+    QTRY_COMPARE(nonces, QStringList({"1", "2", "3"}));
+
+    // Replies are framed the same way
+    QByteArray replies;
+    QTRY_VERIFY((replies += proxySocket.readAll()).size() >= frame("1").size() * 3);
+    const auto maxLength = BrowserShared::NATIVEMSG_MAX_LENGTH;
+    int offset = 0;
+    for (const auto& nonce : asConst(nonces)) {
+        const auto frameSize = BrowserShared::nativeMessageFrameSize(replies, offset, maxLength);
+        QVERIFY(frameSize > 0);
+        const auto reply = QJsonDocument::fromJson(replies.mid(offset + 4, frameSize - 4)).object();
+        QCOMPARE(reply["nonce"].toString(), nonce);
+        offset += frameSize;
+    }
+
+    // Clients without framing still get bare JSON replies
+    QLocalSocket unframedSocket;
+    unframedSocket.connectToServer(serverPath);
+    QVERIFY(unframedSocket.waitForConnected());
+    unframedSocket.write(R"({"action":"get-logins","nonce":"4"})");
+    unframedSocket.flush();
+    QTRY_COMPARE(nonces.size(), 4);
+    QByteArray reply;
+    QTRY_VERIFY(!(reply += unframedSocket.readAll()).isEmpty());
+    QCOMPARE(QJsonDocument::fromJson(reply).object()["nonce"].toString(), QString("4"));
+
+    // The proxy announces its framing with a bare hello, which is answered framed and not processed
+    QLocalSocket helloSocket;
+    helloSocket.connectToServer(serverPath);
+    QVERIFY(helloSocket.waitForConnected());
+    helloSocket.write(BrowserShared::proxyHelloMessage());
+    helloSocket.flush();
+    QByteArray helloReply;
+    QTRY_VERIFY(BrowserShared::nativeMessageFrameSize(helloReply += helloSocket.readAll(), 0, maxLength) > 0);
+    QVERIFY(BrowserShared::isProxyHello(helloReply.mid(4)));
+    helloSocket.write(frame("5"));
+    helloSocket.flush();
+    QTRY_COMPARE(nonces.size(), 5);
+    QCOMPARE(nonces.last(), QString("5"));
+}
@@ -45,11 +45,15 @@ private slots:
     void testSearchEntriesByReference();
     void testSearchEntriesWithPort();
     void testSearchEntriesWithAdditionalURLs();
+    void testUrlIndex();
     void testInvalidEntries();
     void testSubdomainsAndPaths();
     void testBestMatchingCredentials();
     void testBestMatchingWithAdditionalURLs();
     void testRestrictBrowserKey();
+    void testReadNativeMessage();
+    void testProxyMessageFraming();
+    void benchmarkProxyRoundTrip();
 
 private:
     QList<Entry*> createEntries(QStringList& urls, Group* root) const;
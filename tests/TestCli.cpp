@@ -24,6 +24,7 @@
 #include "core/Metadata.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
+#include "crypto/kdf/Argon2Kdf.h"
 #include "keys/FileKey.h"
 #include "keys/drivers/YubiKey.h"
 
@@ -33,6 +34,7 @@
 #include "cli/AttachmentExport.h"
 #include "cli/AttachmentImport.h"
 #include "cli/AttachmentRemove.h"
+#include "cli/BenchmarkKdf.h"
 #include "cli/Clip.h"
 #include "cli/DatabaseCreate.h"
 #include "cli/DatabaseEdit.h"
@@ -43,6 +45,7 @@
 #include "cli/Export.h"
 #include "cli/Generate.h"
 #include "cli/Help.h"
+#include "cli/HibpIndex.h"
 #include "cli/Import.h"
 #include "cli/List.h"
 #include "cli/Merge.h"
@@ -237,6 +240,8 @@ void TestCli::testBatchCommands()
     QVERIFY(Commands::getCommand("export"));
     QVERIFY(Commands::getCommand("generate"));
     QVERIFY(Commands::getCommand("help"));
+    QVERIFY(Commands::getCommand("hibp-index"));
+    QVERIFY(Commands::getCommand("kdf-benchmark"));
     QVERIFY(Commands::getCommand("import"));
     QVERIFY(Commands::getCommand("ls"));
     QVERIFY(Commands::getCommand("merge"));
@@ -248,7 +253,7 @@ void TestCli::testBatchCommands()
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(Commands::getCommand("search"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 26);
+    QCOMPARE(Commands::getCommands().size(), 28);
 }
 
 void TestCli::testInteractiveCommands()
@@ -269,6 +274,8 @@ void TestCli::testInteractiveCommands()
     QVERIFY(Commands::getCommand("exit"));
     QVERIFY(Commands::getCommand("generate"));
     QVERIFY(Commands::getCommand("help"));
+    QVERIFY(Commands::getCommand("hibp-index"));
+    QVERIFY(Commands::getCommand("kdf-benchmark"));
     QVERIFY(Commands::getCommand("ls"));
     QVERIFY(Commands::getCommand("merge"));
     QVERIFY(Commands::getCommand("mkdir"));
@@ -280,7 +287,7 @@ void TestCli::testInteractiveCommands()
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(Commands::getCommand("search"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 26);
+    QCOMPARE(Commands::getCommands().size(), 28);
 }
 
 void TestCli::testAdd()
@@ -450,6 +457,45 @@ void TestCli::testAnalyze()
     QCOMPARE(m_stderr->readAll(), QByteArray());
 }
 
+void TestCli::testHibpIndex()
+{
+    HibpIndex hibpIndexCmd;
+    QVERIFY(!hibpIndexCmd.name.isEmpty());
+    QVERIFY(hibpIndexCmd.getDescriptionLine().contains(hibpIndexCmd.name));
+
+    const QString hibpPath = QString(KEEPASSX_TEST_DATA_DIR).append("/hibp.txt");
+    TemporaryFile indexFile;
+    QVERIFY(indexFile.open());
+    indexFile.close();
+
+    // The sample file is ordered by prevalence
+    execCmd(hibpIndexCmd, {"hibp-index", hibpPath, indexFile.fileName()});
+    QVERIFY(m_stderr->readAll().contains("not sorted by hash"));
+
+    QFile hibpFile(hibpPath);
+    QVERIFY(hibpFile.open(QFile::ReadOnly));
+    auto lines = QString::fromLatin1(hibpFile.readAll()).toUpper().split('\n', Qt::SkipEmptyParts);
+    lines.sort();
+
+    TemporaryFile sortedFile;
+    QVERIFY(sortedFile.open());
+    sortedFile.write(lines.join('\n').toLatin1());
+    sortedFile.close();
+
+    execCmd(hibpIndexCmd, {"hibp-index", sortedFile.fileName(), indexFile.fileName()});
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QVERIFY(m_stdout->readAll().contains("Successfully created HIBP index"));
+
+    Analyze analyzeCmd;
+    setInput("a");
+    execCmd(analyzeCmd, {"analyze", "--hibp", indexFile.fileName(), m_dbFile->fileName()});
+    auto output = m_stdout->readAll();
+    QVERIFY(output.contains("Sample Entry"));
+    QVERIFY(output.contains("123"));
+    m_stderr->readLine(); // Skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+}
+
 void TestCli::testAttachmentExport()
 {
     AttachmentExport attachmentExportCmd;
@@ -853,6 +899,25 @@ void TestCli::testCreate()
 
     db = readDatabase(dbFilename, "a");
     QVERIFY(db);
+
+    // Argon2 parameters tuned for this computer
+    dbFilename = testDir->path() + "/testCreate_tuned.kdbx";
+    setInput({"a", "a"});
+    execCmd(createCmd, {"db-create", dbFilename, "-p", "--tune-kdf", "-t", "200"});
+
+    QCOMPARE(m_stderr->readLine(), QByteArray("Enter password to encrypt database (optional): \n"));
+    QCOMPARE(m_stderr->readLine(), QByteArray("Repeat password: \n"));
+    QCOMPARE(m_stdout->readLine(), QByteArray("Tuning key derivation function for 200ms delay.\n"));
+    QVERIFY(m_stdout->readLine().contains(QByteArray("threads for key derivation function.\n")));
+
+    db = readDatabase(dbFilename, "a");
+    QVERIFY(db);
+    auto argon2Kdf = db->kdf().dynamicCast<Argon2Kdf>();
+    QVERIFY(argon2Kdf);
+    QCOMPARE(argon2Kdf->parallelism(), static_cast<quint32>(QThread::idealThreadCount()));
+    QVERIFY(argon2Kdf->memory() >= 64 * 1024);
+    QCOMPARE(db->metadata()->customData()->value(CustomData::DecryptionTimePreference), QString("200"));
+    QVERIFY(db->keyTransformTime() >= 0);
 }
 
 void TestCli::testDatabaseEdit()
@@ -1008,6 +1073,7 @@ void TestCli::testInfo()
     QCOMPARE(m_stdout->readLine(), QByteArray("Description: \n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("Cipher: AES 256-bit\n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("KDF: AES (6000 rounds)\n"));
+    QVERIFY(m_stdout->readLine().startsWith("Key transformation time: "));
     QCOMPARE(m_stdout->readLine(), QByteArray("Recycle bin is enabled.\n"));
     QVERIFY(m_stdout->readLine().contains(m_dbFile->fileName().toUtf8()));
     QVERIFY(m_stdout->readLine().contains(
@@ -1035,6 +1101,7 @@ void TestCli::testInfo()
     QCOMPARE(m_stdout->readLine(), QByteArray("Description: \n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("Cipher: AES 256-bit\n"));
     QCOMPARE(m_stdout->readLine(), QByteArray("KDF: AES (6000 rounds)\n"));
+    QVERIFY(m_stdout->readLine().startsWith("Key transformation time: "));
     QCOMPARE(m_stdout->readLine(), QByteArray("Recycle bin is enabled.\n"));
 }
 
@@ -1484,6 +1551,36 @@ void TestCli::testImport()
     QVERIFY(db);
 }
 
+void TestCli::testKdfBenchmark()
+{
+    BenchmarkKdf benchmarkCmd;
+    QVERIFY(!benchmarkCmd.name.isEmpty());
+    QVERIFY(benchmarkCmd.getDescriptionLine().contains(benchmarkCmd.name));
+
+    execCmd(benchmarkCmd, {"kdf-benchmark", "--kdf", "scrypt"});
+    QCOMPARE(m_stderr->readAll(), QByteArray("Unsupported key derivation function scrypt.\n"));
+
+    execCmd(benchmarkCmd, {"kdf-benchmark", "-t", "10"});
+    QVERIFY(m_stderr->readAll().contains("Target decryption time must be between"));
+
+    execCmd(benchmarkCmd, {"kdf-benchmark", "-m", "8,x"});
+    QCOMPARE(m_stderr->readAll(), QByteArray("Invalid memory sizes 8,x.\n"));
+
+    execCmd(benchmarkCmd, {"kdf-benchmark", "-t", "100", "-m", "1,2", "-p", "1,2", "-s", "1"});
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    auto lines = QString::fromUtf8(m_stdout->readAll()).split('\n', Qt::SkipEmptyParts);
+    QCOMPARE(lines.size(), 6);
+    QVERIFY(lines.at(1).startsWith("Memory (MiB)"));
+    QVERIFY(lines.at(2).startsWith("1\t1\t"));
+    QVERIFY(lines.at(5).startsWith("2\t2\t"));
+
+    execCmd(benchmarkCmd, {"kdf-benchmark", "--kdf", "aes", "-t", "100", "-s", "1"});
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    lines = QString::fromUtf8(m_stdout->readAll()).split('\n', Qt::SkipEmptyParts);
+    QCOMPARE(lines.size(), 3);
+    QVERIFY(lines.at(2).startsWith("-\t1\t"));
+}
+
 void TestCli::testKeyFileOption()
 {
     List listCmd;
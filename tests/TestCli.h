@@ -47,6 +47,7 @@ private slots:
     void testAdd();
     void testAddGroup();
     void testAnalyze();
+    void testHibpIndex();
     void testAttachmentExport();
     void testAttachmentImport();
     void testAttachmentRemove();
@@ -64,6 +65,7 @@ private slots:
     void testGenerate();
     void testImport();
     void testInfo();
+    void testKdfBenchmark();
     void testKeyFileOption();
     void testNoPasswordOption();
     void testHelp();
@@ -17,7 +17,9 @@
 
 #include "TestConfig.h"
 
+#include <QSignalSpy>
 #include <QTest>
+#include <QtConcurrent>
 
 #include "config-keepassx-tests.h"
 #include "util/TemporaryFile.h"
@@ -40,3 +42,88 @@ void TestConfig::testUpgrade()
 
     tempFile.remove();
 }
+
+void TestConfig::testCache()
+{
+    Config::createTempFileInstance();
+
+    // Values are cached with the type of their default
+    QCOMPARE(config()->get(Config::GUI_HideUsernames).userType(), static_cast<int>(QMetaType::Bool));
+    QCOMPARE(config()->get(Config::AutoTypeDelay).userType(), static_cast<int>(QMetaType::Int));
+
+    QSignalSpy spyChanged(config(), &Config::changed);
+    config()->set(Config::GUI_HideUsernames, true);
+    QCOMPARE(spyChanged.count(), 1);
+    QCOMPARE(config()->get(Config::GUI_HideUsernames), QVariant(true));
+    QCOMPARE(config()->getUncached(Config::GUI_HideUsernames), QVariant(true));
+
+    // The snapshot is already updated when the change is announced
+    connect(config(), &Config::changed, this, [](Config::ConfigKey key) {
+        QCOMPARE(config()->get(key), config()->getUncached(key));
+    });
+    config()->set(Config::AutoTypeDelay, 42);
+    QCOMPARE(config()->get(Config::AutoTypeDelay), QVariant(42));
+
+    // Readers on other threads see either value while it changes
+    QAtomicInt stop;
+    auto reader = QtConcurrent::run([&stop] {
+        while (!stop.loadAcquire()) {
+            const auto delay = config()->get(Config::AutoTypeDelay).toInt();
+            if (delay != 42 && delay != 43) {
+                return false;
+            }
+        }
+        return true;
+    });
+    for (int i = 0; i < 1000; ++i) {
+        config()->set(Config::AutoTypeDelay, i % 2 ? 42 : 43);
+    }
+    stop.storeRelease(1);
+    QVERIFY(reader.result());
+
+    config()->remove(Config::GUI_HideUsernames);
+    QCOMPARE(config()->get(Config::GUI_HideUsernames), config()->getDefault(Config::GUI_HideUsernames));
+
+    config()->resetToDefaults();
+    QCOMPARE(config()->get(Config::AutoTypeDelay), config()->getDefault(Config::AutoTypeDelay));
+
+    disconnect(config(), &Config::changed, this, nullptr);
+}
+
+void TestConfig::benchmarkGet_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("snapshot") << true;
+    QTest::newRow("settings") << false;
+}
+
+void TestConfig::benchmarkGet()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(bool, cached);
+
+    Config::createTempFileInstance();
+    config()->set(Config::GUI_HideUsernames, true);
+    config()->set(Config::Security_PasswordEmptyPlaceholder, true);
+
+    // Settings read by EntryModel::data() for every cell
+    const Config::ConfigKey keys[] = {Config::GUI_HideUsernames,
+                                      Config::GUI_HidePasswords,
+                                      Config::Security_HideNotes,
+                                      Config::Security_PasswordEmptyPlaceholder};
+    int enabled = 0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < 1000; ++i) {
+            for (auto key : keys) {
+                enabled += (cached ? config()->get(key) : config()->getUncached(key)).toBool() ? 1 : 0;
+            }
+        }
+    }
+    QVERIFY(enabled > 0);
+}
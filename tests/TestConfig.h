@@ -25,6 +25,9 @@ class TestConfig : public QObject
     Q_OBJECT
 private slots:
     void testUpgrade();
+    void testCache();
+    void benchmarkGet_data();
+    void benchmarkGet();
 };
 
 #endif // KEEPASSX_TESTCONFIG_H
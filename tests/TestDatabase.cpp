@@ -138,6 +138,74 @@ void TestDatabase::testSaveAs()
     QCOMPARE(error, QString("Could not save, database has not been initialized!"));
 }
 
+void TestDatabase::testSaveInBackground()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("background");
+    entry->setGroup(db->rootGroup());
+    auto timeInfo = entry->timeInfo();
+    timeInfo.setLocationChanged(timeInfo.locationChanged().addDays(-1));
+    entry->setTimeInfo(timeInfo);
+
+    QSignalSpy spyFinished(db.data(), &Database::backgroundSaveFinished);
+
+    // Changes made while saving are not part of the file and keep the database modified
+    db->metadata()->setName("test");
+    QVERIFY2(db->saveInBackground(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(db->isSaving());
+    db->metadata()->setName("test2");
+    QTRY_COMPARE(spyFinished.count(), 1);
+    QVERIFY(spyFinished.first().at(0).toBool());
+    QVERIFY(!db->isSaving());
+    QVERIFY(db->isModified());
+
+    auto savedDb = QSharedPointer<Database>::create();
+    QVERIFY(savedDb->open(tempFile.fileName(), key, &error));
+    QCOMPARE(savedDb->metadata()->name(), QString("test"));
+    auto savedEntry = savedDb->rootGroup()->findEntryByUuid(entry->uuid());
+    QVERIFY(savedEntry);
+    QCOMPARE(savedEntry->title(), QString("background"));
+    QVERIFY(savedEntry->timeInfo().equals(entry->timeInfo(), CompareItemIgnoreMilliseconds));
+
+    // Saves requested while saving are coalesced into one follow-up save
+    db->metadata()->setName("test3");
+    QVERIFY2(db->saveInBackground(Database::Atomic, {}, &error), error.toLatin1());
+    db->metadata()->setName("test4");
+    QVERIFY2(db->saveInBackground(Database::Atomic, {}, &error), error.toLatin1());
+    db->metadata()->setName("test5");
+    QVERIFY2(db->saveInBackground(Database::Atomic, {}, &error), error.toLatin1());
+    QTRY_COMPARE(spyFinished.count(), 3);
+    QVERIFY(!db->isSaving());
+    QVERIFY(!db->isModified());
+
+    savedDb = QSharedPointer<Database>::create();
+    QVERIFY(savedDb->open(tempFile.fileName(), key, &error));
+    QCOMPARE(savedDb->metadata()->name(), QString("test5"));
+
+    // Synchronous saves wait for a running background save
+    db->metadata()->setName("test6");
+    QVERIFY2(db->saveInBackground(Database::Atomic, {}, &error), error.toLatin1());
+    db->metadata()->setName("test7");
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QCOMPARE(spyFinished.count(), 4);
+    QVERIFY(!db->isModified());
+
+    savedDb = QSharedPointer<Database>::create();
+    QVERIFY(savedDb->open(tempFile.fileName(), key, &error));
+    QCOMPARE(savedDb->metadata()->name(), QString("test7"));
+}
+
 void TestDatabase::testSignals()
 {
     TemporaryFile tempFile;
@@ -592,6 +592,73 @@ void TestEntry::testResolveClonedEntry()
     QCOMPARE(cclone4->resolveMultiplePlaceholders(cclone4->password()), original->password());
 }
 
+void TestEntry::testResolvedAttributeCache()
+{
+    Database db;
+    auto* root = db.rootGroup();
+
+    auto* target = new Entry();
+    target->setGroup(root);
+    target->setUuid(QUuid::createUuid());
+    target->setTitle("Target");
+    target->setUsername("{TITLE}-user");
+
+    auto* byUuid = new Entry();
+    byUuid->setGroup(root);
+    byUuid->setUuid(QUuid::createUuid());
+    byUuid->setTitle(QString("{REF:U@I:%1}").arg(target->uuidToHex()));
+
+    auto* byTitle = new Entry();
+    byTitle->setGroup(root);
+    byTitle->setUuid(QUuid::createUuid());
+    byTitle->setTitle("{REF:U@T:Target}");
+
+    auto* unrelated = new Entry();
+    unrelated->setGroup(root);
+    unrelated->setUuid(QUuid::createUuid());
+    unrelated->setTitle("Unrelated");
+
+    QCOMPARE(byUuid->resolvedAttribute(EntryAttributes::TitleKey), QString("Target-user"));
+    QCOMPARE(byTitle->resolvedAttribute(EntryAttributes::TitleKey), QString("Target-user"));
+    QCOMPARE(unrelated->resolvedAttribute(EntryAttributes::TitleKey), QString("Unrelated"));
+
+    // Changes to the referenced entry propagate through nested placeholders
+    target->setTitle("Renamed");
+    QCOMPARE(byUuid->resolvedAttribute(EntryAttributes::TitleKey), QString("Renamed-user"));
+    QCOMPARE(byTitle->resolvedAttribute(EntryAttributes::TitleKey), QString());
+
+    // References searched by value pick up entries that start to match
+    unrelated->setTitle("Target");
+    unrelated->setUsername("other");
+    QCOMPARE(byTitle->resolvedAttribute(EntryAttributes::TitleKey), QString("other"));
+    QCOMPARE(byUuid->resolvedAttribute(EntryAttributes::TitleKey), QString("Renamed-user"));
+
+    // Values cached under the old uuid are dropped when the uuid changes
+    const auto targetUuid = target->uuid();
+    target->setUuid(QUuid::createUuid());
+    QCOMPARE(byUuid->resolvedAttribute(EntryAttributes::TitleKey), QString());
+    QCOMPARE(target->resolvedAttribute(EntryAttributes::UserNameKey), QString("Renamed-user"));
+    target->setUuid(targetUuid);
+    QCOMPARE(byUuid->resolvedAttribute(EntryAttributes::TitleKey), QString("Renamed-user"));
+
+    // Removing the referenced entry
+    delete target;
+    QCOMPARE(byUuid->resolvedAttribute(EntryAttributes::TitleKey), QString());
+
+    // Time dependent values are resolved on every call
+    auto* dated = new Entry();
+    dated->setGroup(root);
+    dated->setUuid(QUuid::createUuid());
+    dated->setTitle("{DT_UTC_YEAR}");
+    QCOMPARE(dated->resolvedAttribute(EntryAttributes::TitleKey), dated->resolveMultiplePlaceholders(dated->title()));
+
+    // Entries outside of a database resolve directly
+    Entry detached;
+    detached.setTitle("{USERNAME}");
+    detached.setUsername("detached");
+    QCOMPARE(detached.resolvedAttribute(EntryAttributes::TitleKey), QString("detached"));
+}
+
 void TestEntry::testIsRecycled()
 {
     auto entry = new Entry();
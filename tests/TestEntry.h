@@ -37,6 +37,7 @@ private slots:
     void testResolveReferencePlaceholders();
     void testResolveNonIdPlaceholdersToUuid();
     void testResolveClonedEntry();
+    void testResolvedAttributeCache();
     void testIsRecycled();
     void testMoveUpDown();
     void testPreviousParentGroup();
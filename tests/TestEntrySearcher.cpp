@@ -16,6 +16,7 @@
  */
 
 #include "TestEntrySearcher.h"
+#include "core/Database.h"
 #include "core/Group.h"
 #include "core/Tools.h"
 
@@ -394,3 +395,206 @@ void TestEntrySearcher::testUUIDSearch()
     m_searchResult = m_entrySearcher.search("uuid:" + Tools::uuidToHex(uuid1), m_rootGroup);
     QCOMPARE(m_searchResult.count(), 1);
 }
+
+void TestEntrySearcher::testSearchIndex()
+{
+    QScopedPointer<Database> db(new Database());
+    auto root = db->rootGroup();
+
+    auto group = new Group();
+    group->setParent(root);
+
+    auto e1 = new Entry();
+    e1->setUuid(QUuid::createUuid());
+    e1->setTitle("Acme Banking");
+    e1->setGroup(group);
+
+    auto e2 = new Entry();
+    e2->setUuid(QUuid::createUuid());
+    e2->setTitle("Mail");
+    e2->setNotes("backup codes for acme");
+    e2->setGroup(root);
+
+    // References are resolved before matching, so they can't be served from the index
+    auto e3 = new Entry();
+    e3->setUuid(QUuid::createUuid());
+    e3->setTitle(QString("{REF:T@I:%1}").arg(e1->uuidToHex()));
+    e3->setGroup(root);
+
+    m_searchResult = m_entrySearcher.search("acme", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e3, e1}));
+
+    m_searchResult = m_entrySearcher.search("title:ACME", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e3, e1}));
+
+    // Wildcards split the word into separate literals
+    m_searchResult = m_entrySearcher.search("acm*king", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e3, e1}));
+
+    m_searchResult = m_entrySearcher.search("acme|mail", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e3, e1}));
+
+    m_searchResult = m_entrySearcher.search("-acme", root);
+    QCOMPARE(m_searchResult, {});
+
+    // Modified entries are picked up on the next search
+    e2->setNotes("nothing to see here");
+    m_searchResult = m_entrySearcher.search("acme", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e3, e1}));
+
+    e2->setUsername("acme-admin");
+    m_searchResult = m_entrySearcher.search("acme", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e3, e1}));
+
+    // Added entries
+    auto e4 = new Entry();
+    e4->setUuid(QUuid::createUuid());
+    e4->setTitle("ACME Corp");
+    e4->setGroup(group);
+    m_searchResult = m_entrySearcher.search("acme", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e3, e1, e4}));
+
+    // Removed entries, the reference can no longer be resolved
+    delete e1;
+    m_searchResult = m_entrySearcher.search("acme", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e4}));
+
+    // Groups moved to another database
+    QScopedPointer<Database> db2(new Database());
+    group->setParent(db2->rootGroup());
+    m_searchResult = m_entrySearcher.search("acme", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2}));
+    m_searchResult = m_entrySearcher.search("acme", db2->rootGroup());
+    QCOMPARE(m_searchResult, QList<Entry*>({e4}));
+
+    // ...and back again
+    group->setParent(root);
+    m_searchResult = m_entrySearcher.search("acme", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e4}));
+}
+
+void TestEntrySearcher::testParallelSearch()
+{
+    Group* group = nullptr;
+    for (int i = 0; i < 5000; ++i) {
+        if (i % 50 == 0) {
+            group = new Group();
+            group->setParent(m_rootGroup);
+        }
+
+        auto entry = new Entry();
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(i % 3 == 0 ? "fizz" : "buzz");
+        entry->setGroup(group);
+    }
+
+    const auto serialResult = m_entrySearcher.search("u:fizz", m_rootGroup);
+    QCOMPARE(serialResult.size(), 1667);
+
+    m_entrySearcher.setParallel(true);
+    QVERIFY(m_entrySearcher.isParallel());
+
+    // Results must be identical, including their order
+    m_searchResult = m_entrySearcher.repeat(m_rootGroup);
+    QCOMPARE(m_searchResult, serialResult);
+
+    m_searchResult = m_entrySearcher.repeatEntries(m_rootGroup->entriesRecursive());
+    QCOMPARE(m_searchResult, serialResult);
+}
+
+void TestEntrySearcher::testResolvedPlaceholders()
+{
+    QScopedPointer<Database> db(new Database());
+    auto root = db->rootGroup();
+
+    auto e1 = new Entry();
+    e1->setUuid(QUuid::createUuid());
+    e1->setTitle("Acme");
+    e1->setUsername("alice");
+    e1->setGroup(root);
+
+    auto e2 = new Entry();
+    e2->setUuid(QUuid::createUuid());
+    e2->setTitle(QString("Copy of {REF:T@I:%1}").arg(e1->uuidToHex()));
+    e2->setUsername(QString("{REF:U@I:%1}").arg(e1->uuidToHex()));
+    e2->setUrl("https://{USERNAME}.example.com/{unknown}");
+    e2->setGroup(root);
+
+    // Fields are matched with their placeholders resolved the same way as by resolvePlaceholder()
+    for (const auto* entry : {e1, e2}) {
+        for (const auto& key : {EntryAttributes::TitleKey, EntryAttributes::UserNameKey, EntryAttributes::URLKey}) {
+            const auto value = entry->attributes()->value(key);
+            QCOMPARE(entry->resolvedAttribute(key), entry->resolvePlaceholder(value));
+        }
+    }
+
+    m_searchResult = m_entrySearcher.search("title:\"copy of acme\"", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2}));
+    m_searchResult = m_entrySearcher.search("user:alice", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1, e2}));
+    m_searchResult = m_entrySearcher.search("url:alice.example.com", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2}));
+    m_searchResult = m_entrySearcher.search("url:unknown", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2}));
+
+    // Resolved values follow changes of the referenced entry
+    e1->setUsername("bob");
+    m_searchResult = m_entrySearcher.search("user:alice", root);
+    QCOMPARE(m_searchResult, {});
+    m_searchResult = m_entrySearcher.search("user:bob", root);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1, e2}));
+}
+
+void TestEntrySearcher::benchmarkSearchIndex_data()
+{
+    QTest::addColumn<int>("entryCount");
+    QTest::addColumn<bool>("useIndex");
+
+    for (int count : {1000, 10000, 60000}) {
+        QTest::newRow(qPrintable(QString("%1 entries, linear").arg(count))) << count << false;
+        QTest::newRow(qPrintable(QString("%1 entries, indexed").arg(count))) << count << true;
+    }
+}
+
+void TestEntrySearcher::benchmarkSearchIndex()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(int, entryCount);
+    QFETCH(bool, useIndex);
+
+    // Groups outside of a database are searched without an index
+    QScopedPointer<Database> db(new Database());
+    QScopedPointer<Group> detachedRoot(new Group());
+    auto root = useIndex ? db->rootGroup() : detachedRoot.data();
+
+    Group* group = nullptr;
+    for (int i = 0; i < entryCount; ++i) {
+        if (i % 100 == 0) {
+            group = new Group();
+            group->setName(QString("Group %1").arg(i / 100));
+            group->setParent(root);
+        }
+
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Service %1").arg(i));
+        entry->setUsername(QString("user%1@example.com").arg(i));
+        entry->setUrl(QString("https://host%1.example.com/login").arg(i));
+        entry->setNotes(i % 100 == 0 ? "contains the needle" : "nothing special");
+        entry->setGroup(group);
+    }
+
+    // Build the index outside of the measured query
+    m_searchResult = m_entrySearcher.search("needle", root);
+    QCOMPARE(m_searchResult.size(), (entryCount + 99) / 100);
+
+    QBENCHMARK
+    {
+        m_searchResult = m_entrySearcher.repeat(root);
+    }
+}
@@ -39,6 +39,11 @@ private slots:
     void testGroup();
     void testSkipProtected();
     void testUUIDSearch();
+    void testSearchIndex();
+    void testParallelSearch();
+    void testResolvedPlaceholders();
+    void benchmarkSearchIndex_data();
+    void benchmarkSearchIndex();
 
 private:
     Group* m_rootGroup;
@@ -24,6 +24,7 @@
 #include <QtTestGui>
 
 #include "core/Group.h"
+#include "core/GroupSettingsCache.h"
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
 
@@ -554,6 +555,95 @@ void TestGroup::testFindEntry()
     QVERIFY(!entry);
 }
 
+void TestGroup::testFindByUuidIndex()
+{
+    QScopedPointer<Database> db(new Database());
+    QScopedPointer<Database> db2(new Database());
+
+    auto group1 = new Group();
+    group1->setUuid(QUuid::createUuid());
+    group1->setParent(db->rootGroup());
+
+    auto group2 = new Group();
+    group2->setUuid(QUuid::createUuid());
+    group2->setParent(db->rootGroup());
+
+    auto entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setGroup(group1);
+
+    // Build the index before changing the tree
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry1->uuid()), entry1);
+    QCOMPARE(db->rootGroup()->findGroupByUuid(group1->uuid()), group1);
+    QCOMPARE(db->rootGroup()->findGroupByUuid(db->rootGroup()->uuid()), db->rootGroup());
+
+    // Lookups are restricted to the subtree of the group
+    QCOMPARE(group1->findEntryByUuid(entry1->uuid()), entry1);
+    QCOMPARE(group1->findEntryByUuid(entry1->uuid(), false), entry1);
+    QVERIFY(!group2->findEntryByUuid(entry1->uuid()));
+    QVERIFY(!db->rootGroup()->findEntryByUuid(entry1->uuid(), false));
+    QVERIFY(!group2->findGroupByUuid(group1->uuid()));
+
+    // Added entries and groups
+    auto entry2 = new Entry();
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setGroup(group2);
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry2->uuid()), entry2);
+
+    auto group3 = new Group();
+    group3->setUuid(QUuid::createUuid());
+    auto entry3 = new Entry();
+    entry3->setUuid(QUuid::createUuid());
+    entry3->setGroup(group3);
+    group3->setParent(group2);
+    QCOMPARE(db->rootGroup()->findGroupByUuid(group3->uuid()), group3);
+    QCOMPARE(group2->findEntryByUuid(entry3->uuid()), entry3);
+
+    // Moved within the database
+    entry2->setGroup(group1);
+    QCOMPARE(group1->findEntryByUuid(entry2->uuid()), entry2);
+    QVERIFY(!group2->findEntryByUuid(entry2->uuid(), false));
+    group3->setParent(group1);
+    QCOMPARE(group1->findGroupByUuid(group3->uuid()), group3);
+    QVERIFY(!group2->findGroupByUuid(group3->uuid()));
+
+    // Changed uuids
+    const auto oldEntryUuid = entry1->uuid();
+    entry1->setUuid(QUuid::createUuid());
+    QVERIFY(!db->rootGroup()->findEntryByUuid(oldEntryUuid));
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry1->uuid()), entry1);
+    const auto oldGroupUuid = group2->uuid();
+    group2->setUuid(QUuid::createUuid());
+    QVERIFY(!db->rootGroup()->findGroupByUuid(oldGroupUuid));
+    QCOMPARE(db->rootGroup()->findGroupByUuid(group2->uuid()), group2);
+    QCOMPARE(db->rootGroup()->findEntryBySearchTerm(entry1->uuid().toRfc4122().toHex(), EntryReferenceType::QUuid),
+             entry1);
+
+    // Moved to another database
+    group3->setParent(db2->rootGroup());
+    QVERIFY(!db->rootGroup()->findGroupByUuid(group3->uuid()));
+    QVERIFY(!db->rootGroup()->findEntryByUuid(entry3->uuid()));
+    QCOMPARE(db2->rootGroup()->findGroupByUuid(group3->uuid()), group3);
+    QCOMPARE(db2->rootGroup()->findEntryByUuid(entry3->uuid()), entry3);
+
+    // Duplicate uuids still find the first entry in tree order
+    auto duplicate = new Entry();
+    duplicate->setUuid(entry1->uuid());
+    duplicate->setGroup(group2);
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry1->uuid()), entry1);
+    QCOMPARE(group2->findEntryByUuid(entry1->uuid()), duplicate);
+
+    // Deleted entries and groups
+    const auto entry2Uuid = entry2->uuid();
+    delete entry2;
+    QVERIFY(!db->rootGroup()->findEntryByUuid(entry2Uuid));
+    const auto group1Uuid = group1->uuid();
+    const auto entry1Uuid = entry1->uuid();
+    delete group1;
+    QVERIFY(!db->rootGroup()->findGroupByUuid(group1Uuid));
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry1Uuid), duplicate);
+}
+
 void TestGroup::testFindGroupByPath()
 {
     QScopedPointer<Database> db(new Database());
@@ -1319,3 +1409,153 @@ void TestGroup::testAutoTypeState()
     QVERIFY(!entry1->groupAutoTypeEnabled());
     QVERIFY(entry2->groupAutoTypeEnabled());
 }
+
+void TestGroup::testTraversal()
+{
+    Database db;
+    auto* root = db.rootGroup();
+
+    auto* entry0 = new Entry();
+    entry0->setGroup(root);
+
+    // Searching is disabled for group1 but enabled again for its child group2
+    auto* group1 = new Group();
+    group1->setParent(root);
+    group1->setSearchingEnabled(Group::Disable);
+    auto* entry1 = new Entry();
+    entry1->setGroup(group1);
+    auto* group2 = new Group();
+    group2->setParent(group1);
+    group2->setSearchingEnabled(Group::Enable);
+    auto* entry2 = new Entry();
+    entry2->setGroup(group2);
+
+    auto* recycleBin = new Group();
+    recycleBin->setParent(root);
+    db.metadata()->setRecycleBin(recycleBin);
+    auto* entry3 = new Entry();
+    entry3->setGroup(recycleBin);
+    auto* group3 = new Group();
+    group3->setParent(recycleBin);
+    auto* entry4 = new Entry();
+    entry4->setGroup(group3);
+
+    auto* group4 = new Group();
+    group4->setParent(root);
+    auto* entry5 = new Entry();
+    entry5->setGroup(group4);
+    auto* historyItem = new Entry();
+    entry5->addHistoryItem(historyItem);
+
+    auto groups = [](const Group* group, Group::TraversalFlags flags) {
+        QList<const Group*> visited;
+        group->forEachGroup([&visited](const Group* g) { visited.append(g); }, flags);
+        return visited;
+    };
+    auto entries = [](const Group* group, Group::TraversalFlags flags) {
+        QList<Entry*> visited;
+        group->forEachEntry([&visited](Entry* e) { visited.append(e); }, flags);
+        return visited;
+    };
+    // History items are only visited by visitors taking a const entry
+    auto entriesWithHistory = [](const Group* group) {
+        QList<const Entry*> visited;
+        group->forEachEntry([&visited](const Entry* e) { visited.append(e); }, Group::IncludeHistory);
+        return visited;
+    };
+    QList<const Entry*> entriesRecursiveWithHistory;
+    for (const Entry* entry : root->entriesRecursive(true)) {
+        entriesRecursiveWithHistory.append(entry);
+    }
+
+    // Without flags the order matches the recursive lists
+    QCOMPARE(groups(root, Group::TraverseAll), static_cast<const Group*>(root)->groupsRecursive(true));
+    QCOMPARE(entries(root, Group::TraverseAll), root->entriesRecursive());
+    QCOMPARE(entriesWithHistory(root), entriesRecursiveWithHistory);
+    QCOMPARE(entriesWithHistory(group4), (QList<const Entry*>{entry5, historyItem}));
+
+    QCOMPARE(groups(root, Group::SkipRecycled), (QList<const Group*>{root, group1, group2, group4}));
+    QCOMPARE(entries(root, Group::SkipRecycled), (QList<Entry*>{entry0, entry1, entry2, entry5}));
+
+    QCOMPARE(groups(root, Group::SkipSearchDisabled),
+             (QList<const Group*>{root, group2, recycleBin, group3, group4}));
+    QCOMPARE(entries(root, Group::SkipSearchDisabled), (QList<Entry*>{entry0, entry2, entry3, entry4, entry5}));
+    QCOMPARE(entries(group2, Group::SkipSearchDisabled), QList<Entry*>{entry2});
+    QCOMPARE(entries(group1, Group::SkipSearchDisabled), QList<Entry*>{entry2});
+
+    QCOMPARE(groups(root, Group::SkipRecycled | Group::SkipSearchDisabled),
+             (QList<const Group*>{root, group2, group4}));
+    QVERIFY(groups(group3, Group::SkipRecycled).isEmpty());
+    QCOMPARE(groups(group3, Group::TraverseAll), QList<const Group*>{group3});
+
+    // The visitor can stop the traversal
+    int visits = 0;
+    QVERIFY(!root->forEachEntry([&visits](Entry*) { return ++visits < 2; }));
+    QCOMPARE(visits, 2);
+    QVERIFY(root->forEachEntry([](Entry*) { return true; }));
+}
+
+void TestGroup::testGroupSettingsCache()
+{
+    const QString hideKey = "BrowserHideEntry";
+    const QString restrictKey = "BrowserRestrictKey";
+
+    Database db;
+    auto* cache = db.groupSettingsCache();
+    auto* root = db.rootGroup();
+    auto* group1 = new Group();
+    group1->setParent(root);
+    auto* group2 = new Group();
+    group2->setParent(group1);
+    auto* group3 = new Group();
+    group3->setParent(root);
+
+    root->setCustomDataTriState(hideKey, Group::Enable);
+    group1->customData()->set(restrictKey, "key1");
+    group1->setAutoTypeEnabled(Group::Disable);
+
+    auto settings = cache->settings(group2);
+    QCOMPARE(settings.customDataTriState(hideKey), Group::Enable);
+    QCOMPARE(settings.customDataString(restrictKey), QString("key1"));
+    QCOMPARE(settings.customDataTriState("BrowserOmitWww"), Group::Inherit);
+    QVERIFY(settings.searchingEnabled);
+    QVERIFY(!settings.autoTypeEnabled);
+    QCOMPARE(cache->settings(group3).customDataString(restrictKey), QString());
+
+    // Changes to a parent reach the cached children
+    group2->setCustomDataTriState(hideKey, Group::Disable);
+    group1->setSearchingEnabled(Group::Disable);
+    root->setCustomDataTriState(hideKey, Group::Inherit);
+    QCOMPARE(cache->settings(group2).customDataTriState(hideKey), Group::Disable);
+    QCOMPARE(cache->settings(group1).customDataTriState(hideKey), Group::Inherit);
+    QVERIFY(!cache->settings(group2).searchingEnabled);
+
+    // Moving a group drops the settings inherited from the old parent
+    group2->setParent(group3);
+    settings = cache->settings(group2);
+    QCOMPARE(settings.customDataString(restrictKey), QString());
+    QVERIFY(settings.searchingEnabled);
+    QVERIFY(settings.autoTypeEnabled);
+
+    // Settings looked up while the group moves are not kept after the move
+    auto lookup = connect(&db, &Database::groupAboutToMove, [cache, group2] { cache->settings(group2); });
+    group2->setParent(group1);
+    disconnect(lookup);
+    QCOMPARE(cache->settings(group2).customDataString(restrictKey), QString("key1"));
+    group2->setParent(group3);
+
+    for (const auto* group : {root, group1, group2, group3}) {
+        settings = cache->settings(group);
+        QCOMPARE(settings.customDataTriState(hideKey), group->resolveCustomDataTriState(hideKey));
+        QCOMPARE(settings.customDataString(restrictKey), group->resolveCustomDataString(restrictKey));
+        QCOMPARE(settings.searchingEnabled, group->resolveSearchingEnabled());
+        QCOMPARE(settings.autoTypeEnabled, group->resolveAutoTypeEnabled());
+    }
+
+    // Entries look up the inherited Auto-Type setting in the cache
+    auto* entry = new Entry();
+    entry->setGroup(group2);
+    QVERIFY(entry->groupAutoTypeEnabled());
+    group3->setAutoTypeEnabled(Group::Disable);
+    QVERIFY(!entry->groupAutoTypeEnabled());
+}
@@ -37,6 +37,7 @@ private slots:
     void testClone();
     void testCopyCustomIcons();
     void testFindEntry();
+    void testFindByUuidIndex();
     void testFindGroupByPath();
     void testPrint();
     void testAddEntryWithPath();
@@ -50,6 +51,8 @@ private slots:
     void testMoveUpDown();
     void testPreviousParentGroup();
     void testAutoTypeState();
+    void testTraversal();
+    void testGroupSettingsCache();
 };
 
 #endif // KEEPASSX_TESTGROUP_H
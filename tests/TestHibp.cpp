@@ -23,7 +23,9 @@
 
 #include <QBuffer>
 #include <QByteArray>
+#include <QCryptographicHash>
 #include <QList>
+#include <QTemporaryFile>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestHibp)
@@ -33,6 +35,45 @@ const char* TEST_HIBP_CONTENTS = "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\n
 
 const char* TEST_BAD_HIBP_CONTENTS = "barf:nope\n";
 
+namespace
+{
+    // Large enough to be memory-mapped and binary-searched instead of streamed
+    QByteArray sortedHibpContents()
+    {
+        QStringList lines;
+        for (int i = 0; i < 30000; ++i) {
+            const auto sha1 = QCryptographicHash::hash(QByteArray::number(i), QCryptographicHash::Sha1);
+            lines << QString("%1:%2").arg(QString::fromLatin1(sha1.toHex().toUpper())).arg(i + 1);
+        }
+        lines << "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123"
+              << "62CDB7020FF920E5AA642C3D4066950DD1F01F4D:456";
+        lines.sort();
+        return lines.join("\r\n").append("\r\n").toLatin1();
+    }
+
+    void addPwnedEntries(Database* db, QList<const Entry*>& expected)
+    {
+        auto entry1 = new Entry();
+        entry1->setPassword("bar");
+        entry1->setGroup(db->rootGroup());
+
+        auto entry2 = new Entry();
+        entry2->setPassword("not leaked");
+        entry2->setGroup(db->rootGroup());
+
+        auto entry3 = new Entry();
+        entry3->setPassword("foo");
+        entry3->setGroup(db->rootGroup());
+
+        auto entry4 = new Entry();
+        entry4->setPassword("29999");
+        entry4->setGroup(db->rootGroup());
+
+        // Findings are reported in hash order
+        expected = {entry3, entry1, entry4};
+    }
+} // namespace
+
 void TestHibp::initTestCase()
 {
     QVERIFY(Crypto::init());
@@ -118,3 +159,65 @@ void TestHibp::testPwned()
     QCOMPARE(findings[1].first, entry4);
     QCOMPARE(findings[1].second, 456);
 }
+
+void TestHibp::testSortedFile()
+{
+    QList<const Entry*> expected;
+    addPwnedEntries(m_db.data(), expected);
+
+    QTemporaryFile hibpFile;
+    QVERIFY(hibpFile.open());
+    hibpFile.write(sortedHibpContents());
+    QVERIFY(hibpFile.seek(0));
+
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QVERIFY(HibpOffline::report(m_db, hibpFile, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 3);
+    QCOMPARE(findings[0].first, expected[0]);
+    QCOMPARE(findings[0].second, 123);
+    QCOMPARE(findings[1].first, expected[1]);
+    QCOMPARE(findings[1].second, 456);
+    QCOMPARE(findings[2].first, expected[2]);
+    QCOMPARE(findings[2].second, 30000);
+}
+
+void TestHibp::testIndex()
+{
+    QList<const Entry*> expected;
+    addPwnedEntries(m_db.data(), expected);
+
+    QByteArray hibpContents(sortedHibpContents());
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    QTemporaryFile indexFile;
+    QVERIFY(indexFile.open());
+    QString error;
+    QVERIFY(HibpOffline::buildIndex(hibpBuffer, indexFile, &error));
+    QCOMPARE(error, QString());
+    QVERIFY(indexFile.size() < hibpContents.size());
+    QVERIFY(indexFile.seek(0));
+
+    QList<QPair<const Entry*, int>> findings;
+    QVERIFY(HibpOffline::report(m_db, indexFile, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 3);
+    QCOMPARE(findings[0].first, expected[0]);
+    QCOMPARE(findings[0].second, 123);
+    QCOMPARE(findings[1].first, expected[1]);
+    QCOMPARE(findings[1].second, 456);
+    QCOMPARE(findings[2].first, expected[2]);
+    QCOMPARE(findings[2].second, 30000);
+
+    // Unsorted files cannot be indexed
+    QByteArray unsortedContents(TEST_HIBP_CONTENTS);
+    unsortedContents.prepend("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF:1\n");
+    QBuffer unsortedBuffer(&unsortedContents);
+    QVERIFY(unsortedBuffer.open(QIODevice::ReadOnly));
+    QBuffer indexBuffer;
+    QVERIFY(indexBuffer.open(QIODevice::WriteOnly));
+    QVERIFY(!HibpOffline::buildIndex(unsortedBuffer, indexBuffer, &error));
+    QVERIFY(!error.isEmpty());
+}
@@ -189,7 +189,7 @@ void TestKeePass2Format::testXmlEntry1()
     const Entry* entry = m_xmlDb->rootGroup()->entries().at(0);
 
     QCOMPARE(entry->uuid(), QUuid::fromRfc4122(QByteArray::fromBase64("+wSUOv6qf0OzW8/ZHAs2sA==")));
-    QCOMPARE(entry->historyItems().size(), 2);
+    QCOMPARE(entry->historyCount(), 2);
     QCOMPARE(entry->iconNumber(), 0);
     QCOMPARE(entry->iconUuid(), QUuid());
     QVERIFY(entry->foregroundColor().isEmpty());
@@ -296,7 +296,7 @@ void TestKeePass2Format::testXmlEntry2()
 
 void TestKeePass2Format::testXmlEntryHistory()
 {
-    const Entry* entryMain = m_xmlDb->rootGroup()->entries().at(0);
+    Entry* entryMain = m_xmlDb->rootGroup()->entries().at(0);
     QCOMPARE(entryMain->historyItems().size(), 2);
 
     {
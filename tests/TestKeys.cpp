@@ -20,14 +20,20 @@
 
 #include <QBuffer>
 #include <QTest>
+#include <QThread>
 
 #include "config-keepassx-tests.h"
 
+#include "core/Config.h"
 #include "core/Database.h"
 #include "core/Metadata.h"
+#include "core/Tools.h"
 #include "crypto/Crypto.h"
 #include "crypto/CryptoHash.h"
+#include "crypto/SymmetricCipher.h"
 #include "crypto/kdf/AesKdf.h"
+#include "crypto/kdf/Argon2Kdf.h"
+#include "crypto/kdf/KdfBenchmark.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
 #include "keys/CompositeKey.h"
@@ -220,6 +226,56 @@ void TestKeys::testFileKeyError()
     errorMsg = "";
 }
 
+void TestKeys::testAesKdfParallelHalves()
+{
+    const auto key = CryptoHash::hash("password", CryptoHash::Sha256);
+    const QByteArray seed(32, '\x4B');
+    const int rounds = 20000;
+
+    // Transforming both halves separately must match transforming the whole key at once
+    auto expected = key;
+    QVERIFY(SymmetricCipher::aesKdf(seed, rounds, expected));
+    expected = CryptoHash::hash(expected, CryptoHash::Sha256);
+
+    AesKdf kdf;
+    QVERIFY(kdf.setSeed(seed));
+    QVERIFY(kdf.setRounds(rounds));
+    QByteArray result;
+    QVERIFY(kdf.transform(key, result));
+    QCOMPARE(result, expected);
+}
+
+void TestKeys::testTuneArgon2()
+{
+    // Measurements are cached in the local configuration
+    Config::createTempFileInstance();
+
+    const int msec = 200;
+    Argon2Kdf kdf(Argon2Kdf::Type::Argon2id);
+    const auto result = KdfBenchmark::tuneArgon2(kdf, msec);
+    QVERIFY(result.isValid());
+
+    QCOMPARE(kdf.parallelism(), static_cast<quint32>(qMax(QThread::idealThreadCount(), 1)));
+    QCOMPARE(kdf.rounds(), result.roundsFor(msec));
+
+    // Memory is doubled from 64 MiB up to 1 GiB and a quarter of the available memory
+    const quint64 minMemory = 1 << 16;
+    const quint64 maxMemory = 1 << 20;
+    QVERIFY(kdf.memory() >= minMemory);
+    QVERIFY(kdf.memory() <= maxMemory);
+    QCOMPARE(kdf.memory() % minMemory, quint64(0));
+    QCOMPARE(qPopulationCount(kdf.memory() / minMemory), 1u);
+    const auto availableMemory = Tools::availableMemory() / 1024;
+    if (availableMemory > 0 && kdf.memory() > minMemory) {
+        QVERIFY(kdf.memory() <= availableMemory / 4);
+    }
+
+    // More memory is only used while enough rounds still fit into the target time
+    if (kdf.memory() > minMemory) {
+        QVERIFY(kdf.rounds() >= 3);
+    }
+}
+
 void TestKeys::benchmarkTransformKey()
 {
     QByteArray env = qgetenv("BENCHMARK");
@@ -35,6 +35,8 @@ private slots:
     void testFileKeyHash();
     void testFileKeyError();
     void testCompositeKeyComponents();
+    void testAesKdfParallelHalves();
+    void testTuneArgon2();
     void benchmarkTransformKey();
 };
 
@@ -24,6 +24,7 @@
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
+#include "crypto/CryptoHash.h"
 
 QTEST_GUILESS_MAIN(TestModified)
 
@@ -470,35 +471,31 @@ void TestModified::testHistoryItems()
     entry2->endUpdate();
     QCOMPARE(entry2->historyItems().size(), 2);
 
+    // Both history items share the attachment, it is only counted once
     entry2->beginUpdate();
     entry2->attachments()->remove(key);
     entry2->endUpdate();
     QCOMPARE(entry2->attachments()->attachmentsSize(), 0);
-    QCOMPARE(entry2->historyItems().size(), 1);
+    QCOMPARE(entry2->historyItems().size(), 3);
 
+    // Attachments shared with the current entry are not counted for the history
     entry2->beginUpdate();
     entry2->attachments()->set("test2", QByteArray(6000, 'a'));
     entry2->endUpdate();
     QCOMPARE(entry2->attachments()->attachmentsSize(), 6000 + key.size() + 1);
-    QCOMPARE(entry2->historyItems().size(), 2);
+    QCOMPARE(entry2->historyItems().size(), 4);
 
     entry2->beginUpdate();
     entry2->attachments()->set("test3", QByteArray(6000, 'b'));
     entry2->endUpdate();
     QCOMPARE(entry2->attachments()->attachmentsSize(), 12000 + (key.size() + 1) * 2);
-    QCOMPARE(entry2->historyItems().size(), 2);
+    QCOMPARE(entry2->historyItems().size(), 5);
 
     entry2->beginUpdate();
-    entry2->attachments()->set("test4", QByteArray(6000, 'c'));
+    entry2->attachments()->remove("test2");
     entry2->endUpdate();
-    QCOMPARE(entry2->attachments()->attachmentsSize(), 18000 + (key.size() + 1) * 3);
+    QCOMPARE(entry2->attachments()->attachmentsSize(), 6000 + key.size() + 1);
     QCOMPARE(entry2->historyItems().size(), 3);
-
-    entry2->beginUpdate();
-    entry2->attachments()->set("test5", QByteArray(6000, 'd'));
-    entry2->endUpdate();
-    QCOMPARE(entry2->attachments()->attachmentsSize(), 24000 + (key.size() + 1) * 4);
-    QCOMPARE(entry2->historyItems().size(), 1);
 }
 
 void TestModified::testHistoryMaxSize()
@@ -634,6 +631,199 @@ void TestModified::testHistoryMaxSize()
     QCOMPARE(entry2->historyItems().size(), 0);
 }
 
+void TestModified::testHistorySharedAttachments()
+{
+    QScopedPointer<Database> db(new Database());
+    db->metadata()->setHistoryMaxItems(-1);
+    db->metadata()->setHistoryMaxSize(10000);
+
+    auto entry = new Entry();
+    entry->setGroup(db->rootGroup());
+
+    entry->beginUpdate();
+    entry->attachments()->set("test", QByteArray(8000, 'a'));
+    entry->endUpdate();
+    QCOMPARE(entry->historyItems().size(), 1);
+
+    // History items share the attachment with the entry instead of copying it
+    for (int i = 0; i < 5; ++i) {
+        entry->beginUpdate();
+        entry->setTitle(QString("title %1").arg(i));
+        entry->endUpdate();
+    }
+    QCOMPARE(entry->historyItems().size(), 6);
+    QVERIFY(entry->historyItems().last()->attachments()->blob("test") == entry->attachments()->blob("test"));
+    QCOMPARE(entry->historyItems().last()->attachments()->hash("test"),
+             CryptoHash::hash(QByteArray(8000, 'a'), CryptoHash::Sha256));
+
+    // Setting the same content keeps the shared blob
+    const auto blob = entry->attachments()->blob("test");
+    entry->attachments()->set("test", QByteArray(8000, 'a'));
+    QVERIFY(entry->attachments()->blob("test") == blob);
+
+    // All history items with the old attachment count it only once
+    entry->beginUpdate();
+    entry->attachments()->set("test", QByteArray(8000, 'b'));
+    entry->endUpdate();
+    QCOMPARE(entry->historyItems().size(), 7);
+
+    entry->beginUpdate();
+    entry->attachments()->set("test", QByteArray(8000, 'c'));
+    entry->endUpdate();
+    QCOMPARE(entry->historyItems().size(), 1);
+    QCOMPARE(entry->historyItems().first()->attachments()->value("test"), QByteArray(8000, 'b'));
+}
+
+void TestModified::testCompactHistory()
+{
+    QScopedPointer<Database> db(new Database());
+    db->metadata()->setHistoryMaxItems(-1);
+    db->metadata()->setHistoryMaxSize(-1);
+
+    auto entry = new Entry();
+    entry->setGroup(db->rootGroup());
+    entry->setTitle("title");
+    entry->attributes()->set("custom", "value", true);
+    entry->attachments()->set("file", QByteArray("data"));
+
+    // History items are only created when they are requested
+    for (int i = 0; i < 10; ++i) {
+        entry->beginUpdate();
+        entry->setPassword(QString("password %1").arg(i));
+        if (i == 5) {
+            entry->attributes()->remove("custom");
+            entry->attachments()->set("file", QByteArray("new data"));
+        }
+        entry->endUpdate();
+    }
+    QScopedPointer<Entry> clone(entry->clone(Entry::CloneIncludeHistory));
+
+    const auto history = entry->historyItems();
+    QCOMPARE(history.size(), 10);
+    QCOMPARE(history.first()->password(), QString(""));
+    for (int i = 1; i < history.size(); ++i) {
+        QCOMPARE(history.at(i)->password(), QString("password %1").arg(i - 1));
+        QCOMPARE(history.at(i)->title(), QString("title"));
+        QCOMPARE(history.at(i)->uuid(), entry->uuid());
+        QCOMPARE(history.at(i)->historyOwner(), entry);
+    }
+    QCOMPARE(history.at(5)->attributes()->value("custom"), QString("value"));
+    QVERIFY(history.at(5)->attributes()->isProtected("custom"));
+    QVERIFY(!history.at(6)->attributes()->hasKey("custom"));
+    QCOMPARE(history.at(5)->attachments()->value("file"), QByteArray("data"));
+    QCOMPARE(history.at(6)->attachments()->value("file"), QByteArray("new data"));
+    QVERIFY(history.at(6)->attachments()->blob("file") == entry->attachments()->blob("file"));
+
+    // Compact history can be read without materializing it
+    QStringList passwords;
+    QVERIFY(clone->forEachHistoryItem([&passwords](const Entry* item) {
+        passwords.append(item->password());
+        return true;
+    }));
+    QCOMPARE(clone->historyCount(), 10);
+    QCOMPARE(passwords.size(), 10);
+    QCOMPARE(passwords.first(), QString(""));
+    QCOMPARE(passwords.last(), QString("password 8"));
+
+    // Clones share the compact history
+    QCOMPARE(clone->historyItems().size(), 10);
+    QVERIFY(clone->equals(entry));
+
+    // Compact history is truncated without materializing it
+    db->metadata()->setHistoryMaxItems(3);
+    auto entry2 = new Entry();
+    entry2->setGroup(db->rootGroup());
+    for (int i = 0; i < 10; ++i) {
+        entry2->beginUpdate();
+        entry2->setPassword(QString("password %1").arg(i));
+        entry2->endUpdate();
+    }
+    QCOMPARE(entry2->historyItems().size(), 3);
+    QCOMPARE(entry2->historyItems().first()->password(), QString("password 6"));
+
+    db->metadata()->setHistoryMaxItems(-1);
+    db->metadata()->setHistoryMaxSize(10000);
+    auto entry3 = new Entry();
+    entry3->setGroup(db->rootGroup());
+    entry3->attachments()->set("test", QByteArray(8000, 'a'));
+    for (int i = 0; i < 5; ++i) {
+        entry3->beginUpdate();
+        entry3->setTitle(QString("title %1").arg(i));
+        entry3->endUpdate();
+    }
+    entry3->beginUpdate();
+    entry3->attachments()->set("test", QByteArray(8000, 'b'));
+    entry3->endUpdate();
+    entry3->beginUpdate();
+    entry3->attachments()->set("test", QByteArray(8000, 'c'));
+    entry3->endUpdate();
+    QCOMPARE(entry3->historyItems().size(), 1);
+    QCOMPARE(entry3->historyItems().first()->attachments()->value("test"), QByteArray(8000, 'b'));
+
+    // Materialized history can be compacted again
+    entry->compactHistory();
+    QCOMPARE(entry->historyItems().size(), 10);
+    QCOMPARE(entry->historyItems().last()->password(), QString("password 8"));
+
+    // Fields set without beginUpdate() do not leak into the compact history
+    auto entry4 = new Entry();
+    entry4->setGroup(db->rootGroup());
+    entry4->setUsername("user");
+    for (int i = 0; i < 3; ++i) {
+        entry4->beginUpdate();
+        entry4->setPassword(QString("password %1").arg(i));
+        entry4->endUpdate();
+    }
+    entry4->setUsername("other user");
+    entry4->attributes()->set("custom", "value");
+    entry4->setPassword("direct");
+    const auto history4 = entry4->historyItems();
+    QCOMPARE(history4.size(), 3);
+    for (int i = 0; i < history4.size(); ++i) {
+        QCOMPARE(history4.at(i)->username(), QString("user"));
+        QVERIFY(!history4.at(i)->attributes()->hasKey("custom"));
+    }
+    QCOMPARE(history4.at(0)->password(), QString(""));
+    QCOMPARE(history4.at(1)->password(), QString("password 0"));
+    QCOMPARE(history4.at(2)->password(), QString("password 1"));
+
+    // Same after compacting the materialized history and adding a revision
+    entry4->compactHistory();
+    entry4->setUsername("third user");
+    entry4->beginUpdate();
+    entry4->setPassword("password 3");
+    entry4->endUpdate();
+    entry4->setNotes("notes");
+    const auto history5 = entry4->historyItems();
+    QCOMPARE(history5.size(), 4);
+    QCOMPARE(history5.at(2)->username(), QString("user"));
+    QCOMPARE(history5.at(2)->password(), QString("password 1"));
+    QCOMPARE(history5.at(3)->username(), QString("third user"));
+    QCOMPARE(history5.at(3)->password(), QString("direct"));
+    QCOMPARE(history5.at(3)->notes(), QString(""));
+
+    // Clone flags change compact history items the same way as materialized ones
+    entry4->compactHistory();
+    QScopedPointer<Entry> refClone(entry4->clone(Entry::CloneIncludeHistory | Entry::CloneUserAsRef));
+    const auto refHistory = refClone->historyItems();
+    QCOMPARE(refHistory.size(), 4);
+    for (const auto* item : refHistory) {
+        QVERIFY(item->isAttributeReferenceOf(EntryAttributes::UserNameKey, entry4->uuid()));
+    }
+
+    // Custom icons of compact history items are found
+    const auto iconUuid = QUuid::createUuid();
+    entry4->beginUpdate();
+    entry4->setIcon(iconUuid);
+    entry4->endUpdate();
+    entry4->beginUpdate();
+    entry4->setIcon(0);
+    entry4->endUpdate();
+    entry4->compactHistory();
+    QVERIFY(entry4->iconUuid().isNull());
+    QVERIFY(db->rootGroup()->customIconsRecursive().contains(iconUuid));
+}
+
 void TestModified::testCustomData()
 {
     int spyCount = 0;
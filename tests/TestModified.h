@@ -33,6 +33,8 @@ private slots:
     void testEntrySets();
     void testHistoryItems();
     void testHistoryMaxSize();
+    void testHistorySharedAttachments();
+    void testCompactHistory();
     void testCustomData();
     void testBlockModifiedSignal();
 };
@@ -17,7 +17,9 @@
 
 #include "TestPasswordHealth.h"
 
+#include "core/Group.h"
 #include "core/PasswordHealth.h"
+#include "crypto/Crypto.h"
 
 #include <QTest>
 
@@ -25,6 +27,7 @@ QTEST_GUILESS_MAIN(TestPasswordHealth)
 
 void TestPasswordHealth::initTestCase()
 {
+    QVERIFY(Crypto::init());
 }
 
 void TestPasswordHealth::testNoDb()
@@ -64,3 +67,47 @@ void TestPasswordHealth::testNoDb()
     QVERIFY(excellent.scoreReason().isEmpty());
     QVERIFY(excellent.scoreDetails().isEmpty());
 }
+
+void TestPasswordHealth::testHealthChecker()
+{
+    auto db = QSharedPointer<Database>::create();
+
+    auto entry1 = new Entry();
+    entry1->setTitle("entry1");
+    entry1->setPassword("secret");
+    entry1->setGroup(db->rootGroup());
+
+    auto entry2 = new Entry();
+    entry2->setTitle("entry2");
+    entry2->setPassword("secret");
+    entry2->setGroup(db->rootGroup());
+
+    auto entry3 = new Entry();
+    entry3->setTitle("entry3");
+    entry3->setPassword("MIhIN9UKrgtPL2hp");
+    entry3->setGroup(db->rootGroup());
+
+    const QList<const Entry*> entries{entry1, entry2, entry3};
+    HealthChecker checker(db);
+    const auto results = checker.evaluate(entries);
+    QCOMPARE(results.size(), entries.size());
+
+    // The batch evaluation matches the evaluation of single entries
+    for (int i = 0; i < entries.size(); ++i) {
+        const auto health = checker.evaluate(entries[i]);
+        QCOMPARE(results[i]->score(), health->score());
+        QCOMPARE(results[i]->scoreReason(), health->scoreReason());
+        QCOMPARE(results[i]->scoreDetails(), health->scoreDetails());
+    }
+
+    // Re-used passwords are penalized and list their uses
+    QCOMPARE(results[0]->score(), 6 - 15);
+    QVERIFY(results[0]->scoreDetails().contains("entry2"));
+    QCOMPARE(results[2]->quality(), PasswordHealth::Quality::Good);
+
+    // Cached entropy follows password changes
+    QCOMPARE(int(db->passwordHealthCache()->entropy("secret")), 6);
+    entry3->setPassword("Yohb2ChR4");
+    QCOMPARE(HealthChecker(db).evaluate(entry3)->score(), 47);
+    QCOMPARE(entry3->passwordHealth()->score(), 47);
+}
@@ -27,6 +27,7 @@ class TestPasswordHealth : public QObject
 private slots:
     void initTestCase();
     void testNoDb();
+    void testHealthChecker();
 };
 
 #endif // KEEPASSX_TESTPASSWORDHEALTH_H
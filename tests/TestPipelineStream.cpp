@@ -0,0 +1,138 @@
+/*
+ *  Copyright (C) 2026 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestPipelineStream.h"
+
+#include <QBuffer>
+#include <QTest>
+
+#include "FailDevice.h"
+#include "crypto/Crypto.h"
+#include "streams/HashedBlockStream.h"
+#include "streams/PipelineStream.h"
+
+QTEST_GUILESS_MAIN(TestPipelineStream)
+
+void TestPipelineStream::initTestCase()
+{
+    QVERIFY(Crypto::init());
+}
+
+void TestPipelineStream::testRead()
+{
+    QByteArray input;
+    for (int i = 0; i < 10000; ++i) {
+        input.append(QByteArray::number(i));
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+
+    HashedBlockStream writer(&buffer, 100);
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+    QCOMPARE(writer.write(input), qint64(input.size()));
+    writer.close();
+    buffer.reset();
+
+    HashedBlockStream reader(&buffer);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+
+    // Small blocks and a short queue make the worker wait for the consumer
+    PipelineStream pipeline(&reader, 64, 2);
+    QVERIFY(pipeline.open(QIODevice::ReadOnly));
+
+    QByteArray output;
+    while (!pipeline.atEnd()) {
+        QByteArray data = pipeline.read(100);
+        QVERIFY(data.size() <= 100);
+        output.append(data);
+    }
+    QCOMPARE(output, input);
+    QCOMPARE(pipeline.read(1).size(), 0);
+    pipeline.close();
+}
+
+void TestPipelineStream::testReadFailure()
+{
+    FailDevice failDevice(1500);
+    failDevice.setData(QByteArray(2000, 'Z'));
+    QVERIFY(failDevice.open(QIODevice::ReadOnly));
+
+    PipelineStream pipeline(&failDevice, 500);
+    QVERIFY(pipeline.open(QIODevice::ReadOnly));
+
+    // Data read before the failure is still delivered
+    QCOMPARE(pipeline.read(1500), QByteArray(1500, 'Z'));
+    QByteArray data(500, '\0');
+    QCOMPARE(pipeline.read(data.data(), data.size()), qint64(-1));
+    QCOMPARE(pipeline.errorString(), QString("FAILDEVICE"));
+
+    // Abort a worker that is still waiting for the consumer
+    failDevice.close();
+    failDevice.setData(QByteArray(2000, 'Z'));
+    QVERIFY(failDevice.open(QIODevice::ReadOnly));
+    PipelineStream abortedPipeline(&failDevice, 1, 1);
+    QVERIFY(abortedPipeline.open(QIODevice::ReadOnly));
+    QCOMPARE(abortedPipeline.read(1), QByteArray(1, 'Z'));
+    abortedPipeline.close();
+}
+
+void TestPipelineStream::testWrite()
+{
+    QByteArray input;
+    for (int i = 0; i < 10000; ++i) {
+        input.append(QByteArray::number(i));
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+
+    HashedBlockStream writer(&buffer, 100);
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+
+    PipelineStream pipeline(&writer, 64, 2);
+    QVERIFY(pipeline.open(QIODevice::WriteOnly));
+    for (int i = 0; i < input.size(); i += 100) {
+        QCOMPARE(pipeline.write(input.mid(i, 100)), qint64(input.mid(i, 100).size()));
+    }
+    QVERIFY(pipeline.reset());
+    pipeline.close();
+    QVERIFY(writer.reset());
+    buffer.reset();
+
+    HashedBlockStream reader(&buffer);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+    QCOMPARE(reader.readAll(), input);
+}
+
+void TestPipelineStream::testWriteFailure()
+{
+    FailDevice failDevice(1500);
+    QVERIFY(failDevice.open(QIODevice::WriteOnly));
+
+    PipelineStream pipeline(&failDevice, 500, 1);
+    QVERIFY(pipeline.open(QIODevice::WriteOnly));
+
+    // The failure is reported by a later write or when flushing
+    QByteArray input(500, 'Z');
+    bool failed = false;
+    for (int i = 0; i < 10 && !failed; ++i) {
+        failed = pipeline.write(input) < 0;
+    }
+    QVERIFY(failed || !pipeline.reset());
+    QCOMPARE(pipeline.errorString(), QString("FAILDEVICE"));
+}
@@ -334,6 +334,24 @@ void TestGuiFdoSecrets::testServiceSearch()
         COMPARE(unlocked, {QDBusObjectPath(item->path())});
     }
 
+    // search by the current attribute values
+    entry->attributes()->set("fdosecrets-test", "3");
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "1"}}));
+        COMPARE(locked, {});
+        COMPARE(unlocked, {});
+    }
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "3"}, {crazyKey, crazyValue}}));
+        COMPARE(locked, {});
+        COMPARE(unlocked, {QDBusObjectPath(item->path())});
+    }
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "3"}, {crazyKey, "other"}}));
+        COMPARE(locked, {});
+        COMPARE(unlocked, {});
+    }
+
     // searching using empty terms returns nothing
     {
         DBUS_GET2(unlocked, locked, service->SearchItems({}));
@@ -352,6 +370,20 @@ void TestGuiFdoSecrets::testServiceSearch()
         COMPARE(locked, {});
         COMPARE(unlocked, {});
     }
+
+    // several matches are returned in tree order, clients use the first one
+    {
+        DBUS_GET(itemPaths, coll->items());
+        VERIFY(itemPaths.size() > 1);
+        for (const auto& path : itemPaths) {
+            auto matchEntry = m_db->rootGroup()->findEntryByUuid(Tools::hexToUuid(path.path().section('/', -1)));
+            VERIFY(matchEntry);
+            matchEntry->attributes()->set("fdosecrets-order", "same");
+        }
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-order", "same"}}));
+        COMPARE(locked, {});
+        COMPARE(unlocked, itemPaths);
+    }
 }
 
 void TestGuiFdoSecrets::testServiceSearchBlockingUnlock()
@@ -1514,6 +1546,64 @@ void TestGuiFdoSecrets::testItemLockState()
     DBUS_VERIFY(item->SetSecret(encrypted));
 }
 
+void TestGuiFdoSecrets::testItemCreatedOnDemand()
+{
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+
+    // listing the items does not create them
+    const auto itemCount = collObj->findChildren<Item*>().size();
+    DBUS_GET(itemPaths, coll->items());
+    VERIFY(itemPaths.size() > 1);
+    COMPARE(collObj->findChildren<Item*>().size(), itemCount);
+
+    // an item is created when its path is first used
+    auto item = getProxy<ItemProxy>(itemPaths.first());
+    VERIFY(item);
+    DBUS_GET(label, item->label());
+    COMPARE(collObj->findChildren<Item*>().size(), itemCount + 1);
+    auto itemObj = m_plugin->dbus()->pathToObject<Item>(itemPaths.first());
+    VERIFY(itemObj);
+    COMPARE(itemObj->backend()->title(), label);
+    COMPARE(collObj->findChildren<Item*>().size(), itemCount + 1);
+
+    // changes are announced for entries no client has used yet
+    QSignalSpy spyItemChanged(coll.data(), SIGNAL(ItemChanged(QDBusObjectPath)));
+    VERIFY(spyItemChanged.isValid());
+    auto entry = m_db->rootGroup()->findEntryByUuid(Tools::hexToUuid(itemPaths.last().path().section('/', -1)));
+    VERIFY(entry);
+    entry->setNotes("changed");
+    QTRY_VERIFY(!spyItemChanged.isEmpty());
+    for (const auto& args : spyItemChanged) {
+        COMPARE(args.at(0).value<QDBusObjectPath>(), itemPaths.last());
+    }
+
+    // a created item is found again and is still listed and searchable
+    DBUS_GET(labelAgain, item->label());
+    COMPARE(labelAgain, label);
+    COMPARE(m_plugin->dbus()->pathToObject<Item>(itemPaths.first()), itemObj);
+    COMPARE(collObj->findChildren<Item*>().size(), itemCount + 1);
+    DBUS_GET(itemPathsAgain, coll->items());
+    VERIFY(itemPathsAgain.contains(itemPaths.first()));
+    DBUS_GET(found, coll->SearchItems({{"Title", label}}));
+    VERIFY(found.contains(itemPaths.first()));
+
+    // deleting the entry of a created item removes the item from the bus
+    QSignalSpy spyItemDeleted(coll.data(), SIGNAL(ItemDeleted(QDBusObjectPath)));
+    VERIFY(spyItemDeleted.isValid());
+    QPointer<Item> deletedItem = itemObj;
+    delete itemObj->backend();
+    QTRY_VERIFY(!spyItemDeleted.isEmpty());
+    COMPARE(spyItemDeleted.first().at(0).value<QDBusObjectPath>(), itemPaths.first());
+    QTRY_VERIFY(!deletedItem);
+    DBUS_GET(itemPathsAfterDelete, coll->items());
+    VERIFY(!itemPathsAfterDelete.contains(itemPaths.first()));
+}
+
 void TestGuiFdoSecrets::testItemRejectSetReferenceFields()
 {
     // expose a subgroup, entries in it should not be able to retrieve data from entries outside it
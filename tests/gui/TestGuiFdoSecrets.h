@@ -92,6 +92,7 @@ private slots:
     void testItemSecret();
     void testItemDelete();
     void testItemLockState();
+    void testItemCreatedOnDemand();
     void testItemRejectSetReferenceFields();
 
     void testAlias();
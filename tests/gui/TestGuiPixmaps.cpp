@@ -18,10 +18,12 @@
 #include "TestGuiPixmaps.h"
 #include "core/Metadata.h"
 
+#include <QSignalSpy>
 #include <QTest>
 
 #include "core/Group.h"
 #include "crypto/Crypto.h"
+#include "gui/CustomIconCache.h"
 #include "gui/DatabaseIcons.h"
 #include "gui/Icons.h"
 
@@ -81,4 +83,42 @@ void TestGuiPixmaps::testGroupIcons()
     QVERIFY(Icons::groupIconPixmap(group).toImage() == Icons::customIconPixmap(db.data(), iconUuid).toImage());
 }
 
+void TestGuiPixmaps::testCustomIconCache()
+{
+    QScopedPointer<Database> db(new Database());
+
+    QUuid iconUuid = QUuid::createUuid();
+    QImage icon(2, 1, QImage::Format_RGB32);
+    icon.fill(qRgb(0, 0, 0));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+
+    Icons::preloadCustomIcons(db.data());
+    auto pixmap = Icons::customIconPixmap(db.data(), iconUuid);
+    QVERIFY(!pixmap.isNull());
+    QCOMPARE(pixmap.toImage().pixel(0, 0), qRgb(0, 0, 0));
+    // Cached pixmaps are shared instead of decoded again
+    QCOMPARE(Icons::customIconPixmap(db.data(), iconUuid).cacheKey(), pixmap.cacheKey());
+    QVERIFY(Icons::customIconPixmap(db.data(), iconUuid, IconSize::Large).cacheKey() != pixmap.cacheKey());
+
+    // Replacing the icon drops the cached pixmap
+    db->metadata()->removeCustomIcon(iconUuid);
+    QVERIFY(Icons::customIconPixmap(db.data(), iconUuid).isNull());
+    icon.fill(qRgb(0, 0, 255));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+    QCOMPARE(Icons::customIconPixmap(db.data(), iconUuid).toImage().pixel(0, 0), qRgb(0, 0, 255));
+
+    // Background decoding finished after the icon was replaced must not restore the old icon
+    CustomIconCache cache(db.data());
+    QSignalSpy preloaded(&cache, &CustomIconCache::preloaded);
+    cache.preload();
+    db->metadata()->removeCustomIcon(iconUuid);
+    icon.fill(qRgb(0, 255, 0));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+    QVERIFY(preloaded.wait());
+    QCOMPARE(cache.pixmap(iconUuid, IconSize::Default).toImage().pixel(0, 0), qRgb(0, 255, 0));
+
+    db->metadata()->clear();
+    QVERIFY(Icons::customIconPixmap(db.data(), iconUuid).isNull());
+}
+
 QTEST_MAIN(TestGuiPixmaps)